@@ -0,0 +1,356 @@
+// raster / GL / Vulkan 백엔드에서 같은 워크로드를 돌려 프레임 시간을 비교하는 벤치마크
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <GLFW/glfw3.h>
+
+#include "include/core/SkCanvas.h"
+#include "include/gpu/ganesh/GrDirectContext.h"
+
+#include "aa_mode.h"
+#include "frame_stats.h"
+#include "gpu_memory.h"
+#include "render_backend.h"
+#include "text_cache.h"
+#include "workloads.h"
+
+struct BenchOptions
+{
+    std::vector<std::string> backends = {"raster", "tiled", "gl", "vulkan"};
+    std::vector<std::string> workloads = workloadNames();
+    int warmup = 10;
+    int iterations = 100;
+    int width = WIDTH;
+    int height = HEIGHT;
+    std::string format = "json";
+    std::string outPath = "skia_bench.json";
+    DeviceSelection device;
+    std::vector<int> threads = {0};   // tiled 백엔드 스레드 수 목록 (0 = 코어 수)
+    int tileSize = 256;
+    size_t strikeCacheBytes = kDefaultStrikeCacheBytes;   // 0 이면 Skia 기본값
+    std::vector<AaOptions> aaModes = {AaOptions()};     // gl / vulkan 에서 각각 별도 타깃
+    int internalSamples = -1;
+};
+
+struct BenchResult
+{
+    std::string backend;
+    std::string aa;
+    std::string workload;
+    int iterations = 0;
+    int64_t gpuBytes = -1;    // 측정 후 GPU 리소스 총량 (render target, MSAA attachment, atlas 포함). raster 는 -1
+    double totalMs = 0;   // 측정 구간 전체 (마지막 GPU 완료까지)
+    StagePercentiles frame;
+    StagePercentiles record;
+    StagePercentiles flush;
+    StagePercentiles gpu;
+};
+
+static std::unique_ptr<RenderBackend> makeTarget(const std::string &backend, const BenchOptions &options,
+                                                 int threads, const AaOptions &aa)
+{
+    BackendConfig config;
+    config.width = options.width;
+    config.height = options.height;
+    config.title = "skia_bench";
+    config.device = options.device;
+    config.tiles.tileSize = options.tileSize;
+    config.tiles.threads = threads;
+    config.aa = aa;
+    config.aa.internalSamples = options.internalSamples;
+    return makeRenderBackend(backend, config);
+}
+
+static void runFrames(RenderBackend &target, Workload &workload, FrameStats &stats, int count, int firstFrame)
+{
+    for (int i = 0; i < count; ++i) {
+        uint64_t frame = stats.beginFrame();
+        SkCanvas *canvas = target.beginFrame(stats, frame);
+        if (!canvas) {
+            stats.endFrame();
+            continue;
+        }
+        {
+            ScopedStageTimer timer(stats, FrameStage::kRecord);
+            workload.draw(canvas, firstFrame + i);
+        }
+        target.endFrame(stats, frame);
+        stats.endFrame();
+    }
+}
+
+// GrDirectContext 가 가진 모든 GPU 리소스 (wrap 된 render target 포함)
+static int64_t gpuMemoryBytes(GrDirectContext *context)
+{
+    CategoryMemoryDump dump;
+    context->dumpMemoryStatistics(&dump);
+    dump.aggregate();
+    int64_t bytes = 0;
+    for (const auto &entry : dump.categories()) {
+        bytes += entry.second.bytes;
+    }
+    return bytes;
+}
+
+static BenchResult runBench(RenderBackend &target, Workload &workload, const BenchOptions &options)
+{
+    // 이전 워크로드의 atlas / scratch 가 메모리 측정에 섞이지 않도록 (program 캐시는 유지)
+    GrDirectContext *context = target.directContext();
+    if (context) {
+        context->purgeUnlockedResources(GrPurgeResourceOptions::kAllResources);
+    }
+
+    FrameStats warmupStats;
+    runFrames(target, workload, warmupStats, options.warmup, 0);
+    target.finish(warmupStats);
+
+    FrameStats stats(options.iterations, options.iterations);
+    auto start = std::chrono::steady_clock::now();
+    runFrames(target, workload, stats, options.iterations, options.warmup);
+    target.finish(stats);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    BenchResult result;
+    result.backend = target.name();
+    result.workload = workload.name();
+    if (context) {
+        result.gpuBytes = gpuMemoryBytes(context);
+    }
+    result.iterations = options.iterations;
+    result.totalMs = elapsed.count();
+    result.frame = stats.percentiles(FrameStage::kCount);
+    result.record = stats.percentiles(FrameStage::kRecord);
+    result.flush = stats.percentiles(FrameStage::kFlush);
+    result.gpu = stats.percentiles(FrameStage::kGpu);
+    return result;
+}
+
+static void runWorkloads(RenderBackend &target, const std::string &aa, const BenchOptions &options,
+                         std::vector<BenchResult> &results)
+{
+    for (const auto &name : options.workloads) {
+        std::unique_ptr<Workload> workload = makeWorkload(name, options.width, options.height);
+        if (!workload) {
+            std::cerr << "Unknown workload: " << name << std::endl;
+            continue;
+        }
+        BenchResult result = runBench(target, *workload, options);
+        result.aa = aa;
+        fprintf(stderr, "%-8s %-8s %-22s frame p50 %8.3f ms  p99 %8.3f ms  gpu p50 %8.3f ms  %8.1f fps  %7.1f MiB\n",
+                result.backend.c_str(), result.aa.c_str(), result.workload.c_str(), result.frame.p50,
+                result.frame.p99, result.gpu.p50,
+                result.totalMs > 0 ? result.iterations * 1000.0 / result.totalMs : 0,
+                result.gpuBytes >= 0 ? result.gpuBytes / (1024.0 * 1024.0) : 0.0);
+        results.push_back(result);
+    }
+}
+
+static void writeJson(std::ostream &out, const std::vector<BenchResult> &results)
+{
+    auto stage = [&out](const char *name, const StagePercentiles &p) {
+        out << ", \"" << name << "\": ";
+        if (p.samples == 0) {
+            out << "null";
+            return;
+        }
+        out << "{\"p50\": " << p.p50 << ", \"p95\": " << p.p95 << ", \"p99\": " << p.p99 << "}";
+    };
+
+    out << "[";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult &r = results[i];
+        out << (i ? ",\n " : "\n ") << "{\"backend\": \"" << r.backend << "\", \"aa\": \"" << r.aa
+            << "\", \"workload\": \"" << r.workload << "\", \"iterations\": " << r.iterations
+            << ", \"total_ms\": " << r.totalMs << ", \"fps\": " << (r.totalMs > 0 ? r.iterations * 1000.0 / r.totalMs : 0)
+            << ", \"gpu_mb\": ";
+        if (r.gpuBytes < 0) {
+            out << "null";
+        } else {
+            out << r.gpuBytes / (1024.0 * 1024.0);
+        }
+        stage("frame_ms", r.frame);
+        stage("record_ms", r.record);
+        stage("flush_ms", r.flush);
+        stage("gpu_ms", r.gpu);
+        out << "}";
+    }
+    out << "\n]\n";
+}
+
+static void writeCsv(std::ostream &out, const std::vector<BenchResult> &results)
+{
+    out << "backend,aa,workload,iterations,total_ms,fps,gpu_mb";
+    for (const char *name : {"frame", "record", "flush", "gpu"}) {
+        out << "," << name << "_p50," << name << "_p95," << name << "_p99";
+    }
+    out << "\n";
+    for (const BenchResult &r : results) {
+        out << r.backend << "," << r.aa << "," << r.workload << "," << r.iterations << "," << r.totalMs << ","
+            << (r.totalMs > 0 ? r.iterations * 1000.0 / r.totalMs : 0) << ",";
+        if (r.gpuBytes >= 0) {
+            out << r.gpuBytes / (1024.0 * 1024.0);
+        }
+        for (const StagePercentiles *p : {&r.frame, &r.record, &r.flush, &r.gpu}) {
+            if (p->samples == 0) {
+                out << ",,,";
+            } else {
+                out << "," << p->p50 << "," << p->p95 << "," << p->p99;
+            }
+        }
+        out << "\n";
+    }
+}
+
+static std::vector<std::string> splitList(const char *str)
+{
+    std::vector<std::string> items;
+    std::stringstream ss(str);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+static void printUsage(const char *argv0)
+{
+    std::cout << "Usage: " << argv0 << " [options]\n"
+              << "  --backends=LIST     raster,tiled,gl,vulkan,auto (default all but auto)\n"
+              << "  --workloads=LIST    default all:";
+    for (const auto &name : workloadNames()) {
+        std::cout << " " << name;
+    }
+    std::cout << "\n"
+              << "  --warmup=N          warmup frames per run (default 10)\n"
+              << "  --iterations=N      measured frames per run (default 100)\n"
+              << "  --size=WxH          render target size (default 800x600)\n"
+              << "  --format=FMT        json | csv (default json)\n"
+              << "  --out=FILE          result file (default skia_bench.json, '-' for stdout)\n"
+              << "  --threads=LIST      tiled backend thread counts, e.g. 1,2,4,8 (default: core count)\n"
+              << "  --tile-size=N       tiled backend tile size in pixels (default 256)\n"
+              << "  --font-cache-mb=N   glyph strike cache limit in MiB (default 16, 0 = Skia default)\n"
+              << "  --device=NAME       force Vulkan device whose name contains NAME\n"
+              << "  --prefer=cpu        prefer a software Vulkan device (lavapipe)\n"
+              << "  --aa=LIST           gl / vulkan AA modes, e.g. coverage,msaa4,msaa8,dmsaa (default coverage)\n"
+              << "  --internal-msaa=N   GrContextOptions::fInternalMultisampleCount (default Skia's)\n";
+}
+
+static bool parseArgs(int argc, char **argv, BenchOptions &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (strncmp(arg, "--backends=", 11) == 0) {
+            options.backends = splitList(arg + 11);
+        } else if (strncmp(arg, "--workloads=", 12) == 0) {
+            options.workloads = splitList(arg + 12);
+        } else if (strncmp(arg, "--warmup=", 9) == 0) {
+            options.warmup = std::max(0, atoi(arg + 9));
+        } else if (strncmp(arg, "--iterations=", 13) == 0) {
+            options.iterations = std::max(1, atoi(arg + 13));
+        } else if (strncmp(arg, "--size=", 7) == 0) {
+            if (sscanf(arg + 7, "%dx%d", &options.width, &options.height) != 2 ||
+                options.width <= 0 || options.height <= 0) {
+                std::cerr << "Invalid size: " << arg + 7 << std::endl;
+                return false;
+            }
+        } else if (strncmp(arg, "--format=", 9) == 0) {
+            options.format = arg + 9;
+            if (options.format != "json" && options.format != "csv") {
+                std::cerr << "Unknown format: " << options.format << std::endl;
+                return false;
+            }
+        } else if (strncmp(arg, "--out=", 6) == 0) {
+            options.outPath = arg + 6;
+        } else if (strncmp(arg, "--threads=", 10) == 0) {
+            options.threads.clear();
+            for (const auto &item : splitList(arg + 10)) {
+                options.threads.push_back(std::max(0, atoi(item.c_str())));
+            }
+        } else if (strncmp(arg, "--tile-size=", 12) == 0) {
+            options.tileSize = std::max(16, atoi(arg + 12));
+        } else if (strncmp(arg, "--font-cache-mb=", 16) == 0) {
+            options.strikeCacheBytes = static_cast<size_t>(std::max(0, atoi(arg + 16))) << 20;
+        } else if (strncmp(arg, "--device=", 9) == 0) {
+            options.device.forcedName = arg + 9;
+        } else if (strcmp(arg, "--prefer=cpu") == 0) {
+            options.device.preference = DevicePreference::kCpu;
+        } else if (strncmp(arg, "--aa=", 5) == 0) {
+            options.aaModes.clear();
+            for (const auto &item : splitList(arg + 5)) {
+                AaOptions aa;
+                if (!parseAaMode(item, &aa)) {
+                    std::cerr << "Unknown AA mode: " << item << " (coverage|msaa[N]|dmsaa)" << std::endl;
+                    return false;
+                }
+                options.aaModes.push_back(aa);
+            }
+        } else if (strncmp(arg, "--internal-msaa=", 16) == 0) {
+            options.internalSamples = std::max(0, atoi(arg + 16));
+        } else {
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        return -1;
+    }
+
+    configureStrikeCache(options.strikeCacheBytes);
+    bool glfwReady = glfwInit();
+    std::vector<BenchResult> results;
+    for (const auto &backend : options.backends) {
+        if (backend == "gl" && !glfwReady) {
+            std::cerr << "Skip gl: glfwInit failed (no display?)" << std::endl;
+            continue;
+        }
+        // tiled 는 스레드 수마다, GPU 백엔드는 AA 모드마다 별도 타깃
+        bool raster = backend == "raster" || backend == "tiled";
+        std::vector<int> threadCounts = backend == "tiled" ? options.threads : std::vector<int>{0};
+        std::vector<AaOptions> aaModes = raster ? std::vector<AaOptions>{AaOptions()} : options.aaModes;
+        for (int threads : threadCounts) {
+            for (const AaOptions &aa : aaModes) {
+                std::unique_ptr<RenderBackend> target = makeTarget(backend, options, threads, aa);
+                if (!target) {
+                    std::cerr << "Skip " << backend << " " << aa.name() << ": backend unavailable" << std::endl;
+                    continue;
+                }
+                runWorkloads(*target, raster ? "analytic" : aa.name(), options, results);
+            }
+        }
+    }
+    if (glfwReady) {
+        glfwTerminate();
+    }
+
+    std::ofstream file;
+    if (options.outPath != "-") {
+        file.open(options.outPath);
+        if (!file) {
+            std::cerr << "Failed to open " << options.outPath << std::endl;
+            return -1;
+        }
+    }
+    std::ostream &out = options.outPath == "-" ? std::cout : file;
+    if (options.format == "csv") {
+        writeCsv(out, results);
+    } else {
+        writeJson(out, results);
+    }
+    return results.empty() ? -1 : 0;
+}
@@ -1,6 +1,13 @@
 #define GLFW_INCLUDE_VULKAN
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
 #include <iostream>
+#include <string>
 #include <vector>
 #include <GLFW/glfw3.h>
 
@@ -8,368 +15,894 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRegion.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkStream.h"
 #include "include/core/SkSurface.h"
+#include "include/encode/SkPngEncoder.h"
 
+#include "include/gpu/ganesh/GrBackendSemaphore.h"
 #include "include/gpu/ganesh/GrDirectContext.h"
-#include "include/gpu/ganesh/GrBackendSurface.h"
 #include "include/gpu/ganesh/SkSurfaceGanesh.h"
-#include "include/gpu/ganesh/vk/GrVkBackendSurface.h"
-#include "include/gpu/ganesh/vk/GrVkDirectContext.h"
-#include "include/gpu/ganesh/vk/GrVkTypes.h"
-#include "include/gpu/vk/VulkanBackendContext.h"
-
-#define WIDTH 800
-#define HEIGHT 600
-
-// 구조체로 Vulkan 객체 관리
-struct VulkanContext
-{
-    VkInstance instance;
-    VkPhysicalDevice physicalDevice;
-    VkDevice device;
-    VkSurfaceKHR surface;
-    VkQueue queue;
-    uint32_t queueFamilyIndex;
-    VkSwapchainKHR swapchain;
-    VkFormat format;
-    VkExtent2D extent;
-    VkCommandPool cmdPool;
-    std::vector<VkImage> images;
-    std::vector<sk_sp<SkSurface>> skSurfaces;
+#include "include/gpu/ganesh/vk/GrVkBackendSemaphore.h"
+
+#include "damage_tracker.h"
+#include "ddl_renderer.h"
+#include "event_tracer.h"
+#include "frame_capture.h"
+#include "frame_scheduler.h"
+#include "font_manager.h"
+#include "frame_stats.h"
+#include "gpu_memory.h"
+#include "image_manager.h"
+#include "retained_scene.h"
+#include "scene_file.h"
+#include "shader_cache.h"
+#include "startup_trace.h"
+#include "vk_context.h"
+#include "vk_gpu_timer.h"
+#include "workloads.h"
+
+struct AppOptions
+{
+    VulkanConfig vulkan;
+    int frames = 100;          // headless 에서 렌더할 프레임 수
+    std::string outputPath;    // headless 마지막 프레임 PNG 저장 경로
+    std::string statsCsvPath;
+    std::string statsJsonPath;
+    int statsInterval = 0;     // N 프레임마다 percentile 출력, 0 이면 종료 시에만
+    CaptureOptions capture;
+    GpuMemoryOptions gpuMemory;
+    std::string scenePath;     // .skscene (없으면 코드로 그리는 triangle)
+    std::string workload;      // 비어 있으면 기본 triangle scene, 있으면 매 프레임 전체를 다시 그리는 워크로드
+    int ddlChunks = -1;        // >= 0 이면 DDL 로 멀티스레드 기록 (0 이면 스레드 수만큼 band)
+    int ddlThreads = 0;
+    std::vector<std::string> images;  // --image 로 준 파일 (백그라운드 decode/업로드 후 썸네일로 표시)
+    ImageManagerOptions imageManager;
+    bool warmUp = false;       // 첫 프레임 전에 대표 draw 들로 shader/pipeline 준비
+    TraceOptions trace;
+    SchedulerOptions scheduler;  // 창 모드 렌더 루프
+    std::chrono::steady_clock::time_point launchTime = std::chrono::steady_clock::now();
 };
 
-bool setupVulkan(GLFWwindow *window, VulkanContext &vkCtx, sk_sp<GrDirectContext> &skContext)
+static void printUsage(const char *argv0)
 {
-    // --- Vulkan Instance ---
-    VkApplicationInfo appInfo{VK_STRUCTURE_TYPE_APPLICATION_INFO};
-    appInfo.pApplicationName = "Skia Vulkan Example";
-    appInfo.apiVersion = VK_API_VERSION_1_3;
+    std::cout << "Usage: " << argv0 << " [options]\n"
+              << "  --headless            render to offscreen VkImages (no window/display)\n"
+              << "  --frames=N            frames to render in headless mode (default 100)\n"
+              << "  --output=FILE         save the last headless frame as PNG\n"
+              << "  --size=WxH            render target size (default 800x600)\n"
+              << "  --prefer=TYPE         discrete | integrated | cpu\n"
+              << "  --allow-cpu           allow software devices (lavapipe/llvmpipe)\n"
+              << "  --device=NAME         force device whose name contains NAME\n"
+              << "  --device-uuid=UUID    force device by VkPhysicalDeviceIDProperties::deviceUUID\n"
+              << "  --frames-in-flight=N  max frames the CPU may record ahead of the GPU (default 2)\n"
+              << "  --present=MODE        fifo | fifo-relaxed | mailbox | immediate (default fifo)\n"
+              << "  --image-count=N       swapchain min image count (default minImageCount + 1)\n"
+              << "  --stats-csv=FILE      dump per-frame timings as CSV on exit\n"
+              << "  --stats-json=FILE     dump per-frame timings and percentiles as JSON on exit\n"
+              << "  --stats-interval=N    print p50/p95/p99 every N frames\n"
+              << "  --capture=PATTERN     async readback of every frame to images (cap_%05d.png / .qoi)\n"
+              << "  --capture-yuv=FILE    async readback of every frame as raw I420 stream\n"
+              << "  --capture-size=WxH    rescale captured frames on the GPU\n"
+              << "  --capture-slots=N     readbacks in flight before frames are dropped (default 3)\n"
+              << "  --capture-backlog=N   frames waiting for the writer before frames are dropped (default 8)\n"
+              << "  --gpu-cache-mb=N      GPU resource cache budget in MiB (default Skia's)\n"
+              << "  --gpu-idle-purge=SEC  purge resources unused for SEC seconds when idle (default 5)\n"
+              << "  --gpu-memory-json=F   write GPU memory counters as JSON to F (- for stdout)\n"
+              << "  --gpu-memory-interval=N  write GPU memory counters every N frames\n"
+              << "  --scene=FILE          draw a binary scene (.skscene, see tools/scene_convert) instead of the triangle\n"
+              << "  --workload=NAME       draw a benchmark workload every frame instead of the triangle scene\n"
+              << "  --ddl[=N]             record the frame on worker threads as N deferred display lists\n"
+              << "  --ddl-threads=N       worker threads for --ddl (default hardware concurrency)\n"
+              << "  --image=FILE          decode/upload an image in the background and show it as a thumbnail (repeatable)\n"
+              << "  --no-transfer-queue   upload images on the render thread instead of the transfer queue\n"
+              << "  --shader-cache=DIR    persistent shader/pipeline cache (default " << defaultShaderCacheDir() << ")\n"
+              << "  --no-shader-cache     disable the persistent shader/pipeline cache\n"
+              << "  --aa=MODE             coverage | msaa[N] | dmsaa (default coverage)\n"
+              << "  --internal-msaa=N     sample count for Skia's internal offscreen targets (0 disables)\n"
+              << "  --vk-allocator=NAME   skia (default) | pooled: suballocate device memory from per-usage block pools\n"
+              << "  --vk-block-mb=N       pooled allocator block size for device-local memory (host pools use N/4)\n"
+              << "  --vk-host-tracking    track driver host allocations through VkAllocationCallbacks\n"
+              << "  --continuous          redraw every frame even when nothing changed (default: render on demand)\n"
+              << "  --max-fps=N           cap the windowed frame rate (default 0: present mode decides)\n"
+              << "  --idle-trim-ms=N      purge stale GPU resources after N ms without frames (default 1000, -1 never)\n"
+              << "  --trace=FILE          record Skia and app trace events, write Chrome trace JSON on exit (T toggles)\n"
+              << "  --trace-categories=L  comma list, -x excludes, x* prefix (default *: all but disabled-by-default-*)\n"
+              << "  --trace-buffer=N      trace events kept per thread (default 65536, oldest overwritten)\n"
+              << "  --trace-paused        start with tracing off until T is pressed\n"
+              << "  --warmup              precompile common draw types before the first frame\n"
+              << "  --verbose             log device / surface format candidates during setup\n";
+}
 
-    uint32_t glfwExtCount = 0;
-    const char **glfwExts = glfwGetRequiredInstanceExtensions(&glfwExtCount);
+static bool parseArgs(int argc, char **argv, AppOptions &options)
+{
+    options.vulkan.shaderCacheDir = defaultShaderCacheDir();
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--headless") == 0) {
+            options.vulkan.headless = true;
+        } else if (strncmp(arg, "--frames=", 9) == 0) {
+            options.frames = atoi(arg + 9);
+        } else if (strncmp(arg, "--frames-in-flight=", 19) == 0) {
+            options.vulkan.framesInFlight = std::max(1, atoi(arg + 19));
+        } else if (strncmp(arg, "--present=", 10) == 0) {
+            std::string mode = arg + 10;
+            if (mode == "fifo") {
+                options.vulkan.presentMode = VK_PRESENT_MODE_FIFO_KHR;
+            } else if (mode == "fifo-relaxed") {
+                options.vulkan.presentMode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+            } else if (mode == "mailbox") {
+                options.vulkan.presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+            } else if (mode == "immediate") {
+                options.vulkan.presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+            } else {
+                std::cerr << "Unknown present mode: " << mode << std::endl;
+                return false;
+            }
+        } else if (strncmp(arg, "--image-count=", 14) == 0) {
+            options.vulkan.imageCount = std::max(0, atoi(arg + 14));
+        } else if (strncmp(arg, "--stats-csv=", 12) == 0) {
+            options.statsCsvPath = arg + 12;
+        } else if (strncmp(arg, "--stats-json=", 13) == 0) {
+            options.statsJsonPath = arg + 13;
+        } else if (strncmp(arg, "--stats-interval=", 17) == 0) {
+            options.statsInterval = std::max(0, atoi(arg + 17));
+        } else if (strncmp(arg, "--output=", 9) == 0) {
+            options.outputPath = arg + 9;
+        } else if (strncmp(arg, "--size=", 7) == 0) {
+            unsigned w = 0, h = 0;
+            if (sscanf(arg + 7, "%ux%u", &w, &h) != 2 || w == 0 || h == 0) {
+                std::cerr << "Invalid size: " << arg + 7 << std::endl;
+                return false;
+            }
+            options.vulkan.width = w;
+            options.vulkan.height = h;
+        } else if (strncmp(arg, "--prefer=", 9) == 0) {
+            std::string type = arg + 9;
+            if (type == "discrete") {
+                options.vulkan.device.preference = DevicePreference::kDiscrete;
+            } else if (type == "integrated") {
+                options.vulkan.device.preference = DevicePreference::kIntegrated;
+            } else if (type == "cpu") {
+                options.vulkan.device.preference = DevicePreference::kCpu;
+            } else {
+                std::cerr << "Unknown device type: " << type << std::endl;
+                return false;
+            }
+        } else if (strcmp(arg, "--allow-cpu") == 0) {
+            options.vulkan.device.allowCpu = true;
+        } else if (strncmp(arg, "--device=", 9) == 0) {
+            options.vulkan.device.forcedName = arg + 9;
+        } else if (strncmp(arg, "--device-uuid=", 14) == 0) {
+            options.vulkan.device.forcedUuid = arg + 14;
+        } else if (strncmp(arg, "--shader-cache=", 15) == 0) {
+            options.vulkan.shaderCacheDir = arg + 15;
+        } else if (strcmp(arg, "--no-shader-cache") == 0) {
+            options.vulkan.shaderCacheDir.clear();
+        } else if (strncmp(arg, "--scene=", 8) == 0) {
+            options.scenePath = arg + 8;
+        } else if (strncmp(arg, "--workload=", 11) == 0) {
+            options.workload = arg + 11;
+        } else if (strcmp(arg, "--ddl") == 0) {
+            options.ddlChunks = 0;
+        } else if (strncmp(arg, "--ddl=", 6) == 0) {
+            options.ddlChunks = std::max(0, atoi(arg + 6));
+        } else if (strncmp(arg, "--ddl-threads=", 14) == 0) {
+            options.ddlThreads = std::max(0, atoi(arg + 14));
+        } else if (strncmp(arg, "--image=", 8) == 0) {
+            options.images.push_back(arg + 8);
+        } else if (strcmp(arg, "--no-transfer-queue") == 0) {
+            options.imageManager.transferQueue = false;
+        } else if (strcmp(arg, "--warmup") == 0) {
+            options.warmUp = true;
+        } else if (strcmp(arg, "--verbose") == 0) {
+            options.vulkan.verbose = true;
+        } else if (parseAaArg(arg, options.vulkan.aa)) {
+        } else if (parseVkMemoryArg(arg, options.vulkan.memory)) {
+        } else if (parseTraceArg(arg, options.trace)) {
+        } else if (parseSchedulerArg(arg, options.scheduler)) {
+        } else if (parseCaptureArg(arg, options.capture)) {
+        } else if (parseGpuMemoryArg(arg, options.gpuMemory)) {
+        } else {
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
 
-    VkInstanceCreateInfo instInfo{VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
-    instInfo.pApplicationInfo = &appInfo;
-    instInfo.enabledExtensionCount = glfwExtCount;
-    instInfo.ppEnabledExtensionNames = glfwExts;
+static void drawTriangle(SkCanvas *canvas, int)
+{
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setStyle(SkPaint::kFill_Style);
+    paint.setColor(SK_ColorRED);
 
-    if (vkCreateInstance(&instInfo, nullptr, &vkCtx.instance) != VK_SUCCESS)
-    {
-        std::cerr << "Failed to create Vulkan instance\n";
-        return false;
+    SkPath triangle;
+    triangle.moveTo(400, 100);
+    triangle.lineTo(200, 500);
+    triangle.lineTo(600, 500);
+    triangle.close();
+
+    canvas->drawPath(triangle, paint);
+}
+
+// --scene 으로 연 파일 (mmap, 프로세스 종료까지 유지)
+static SceneFile gSceneFile;
+
+static void drawStaticContent(SkCanvas *canvas, int frame)
+{
+    if (gSceneFile.isOpen()) {
+        gSceneFile.draw(canvas);
+    } else {
+        drawTriangle(canvas, frame);
     }
+}
 
-    // --- Vulkan Surface via GLFW ---
-    if (glfwCreateWindowSurface(vkCtx.instance, window, nullptr, &vkCtx.surface) != VK_SUCCESS)
-    {
-        std::cerr << "Failed to create GLFW Vulkan surface\n";
+static bool loadScene(const AppOptions &options)
+{
+    if (options.scenePath.empty()) {
+        return true;
+    }
+    StartupPhase phase("scene load");
+    auto start = std::chrono::steady_clock::now();
+    if (!gSceneFile.open(options.scenePath)) {
         return false;
     }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Scene " << options.scenePath << ": " << gSceneFile.pathCount() << " paths, "
+              << gSceneFile.drawCount() << " draws, " << (gSceneFile.mappedBytes() >> 10) << " KiB mapped in "
+              << elapsed.count() << " ms" << std::endl;
+    return true;
+}
+
+// 커서를 따라다니는 원 (damage 가 생기는 dynamic 노드)
+static SkPoint gCursor = {-100, -100};
+static constexpr float kCursorRadius = 20;
 
-    // --- Physical Device ---
-    uint32_t deviceCount = 0;
-    vkEnumeratePhysicalDevices(vkCtx.instance, &deviceCount, nullptr);
-    std::vector<VkPhysicalDevice> devices(deviceCount);
-    vkEnumeratePhysicalDevices(vkCtx.instance, &deviceCount, devices.data());
-    vkCtx.physicalDevice = VK_NULL_HANDLE;
+static SkIRect cursorBounds(SkPoint pos)
+{
+    // AA 가장자리까지 포함
+    return SkRect::MakeLTRB(pos.fX - kCursorRadius, pos.fY - kCursorRadius,
+                            pos.fX + kCursorRadius, pos.fY + kCursorRadius).roundOut().makeOutset(2, 2);
+}
+
+static void drawCursor(SkCanvas *canvas, int)
+{
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawCircle(gCursor, kCursorRadius, paint);
+}
+
+// picture cull rect: 그리는 surface 와 --scene 파일 크기를 모두 덮는다
+static SkRect sceneBounds(SkCanvas *canvas)
+{
+    SkRect bounds = SkRect::Make(canvas->getBaseLayerSize());
+    if (gSceneFile.isOpen()) {
+        bounds.join(SkRect::MakeWH(gSceneFile.width(), gSceneFile.height()));
+    }
+    return bounds;
+}
 
-    VkPhysicalDevice bestDevice = VK_NULL_HANDLE;
-    for (auto device : devices) {
-        VkPhysicalDeviceProperties props;
-        vkGetPhysicalDeviceProperties(device, &props);
-        if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU) {
-            std::cout << "Ignore Software GPU (llvmpipe)" << std::endl;
+// dirty 영역만 clip 해서 다시 그린다 (나머지는 이미지에 남아 있는 이전 내용 사용)
+void drawFrame(SkCanvas *canvas, const SkRegion &dirty)
+{
+    TraceSpan span("drawFrame");
+    // 내용이 바뀌지 않으므로 처음 한 번만 SkPicture 로 기록하고 이후에는 재생만 한다 (크기가 바뀌면 다시 기록)
+    static RetainedScene scene = [] {
+        RetainedScene s(SkRect::MakeEmpty());
+        s.addStatic(drawStaticContent);
+        s.addDynamic(drawCursor);
+        return s;
+    }();
+    scene.setBounds(sceneBounds(canvas));
+
+    canvas->save();
+    canvas->clipRegion(dirty);
+    canvas->clear(SK_ColorWHITE);
+    scene.draw(canvas, 0);
+    canvas->restore();
+}
+
+// --image 썸네일: 왼쪽 위부터 한 줄로, 준비된 것만 그린다
+static ImageManager *gImages = nullptr;
+static std::vector<int> gImageHandles;
+static constexpr int kThumbnailSize = 128;
+static constexpr int kThumbnailPadding = 8;
+
+static SkIRect thumbnailBounds(size_t index)
+{
+    int x = kThumbnailPadding + static_cast<int>(index) * (kThumbnailSize + kThumbnailPadding);
+    return SkIRect::MakeXYWH(x, kThumbnailPadding, kThumbnailSize, kThumbnailSize);
+}
+
+static void drawImages(SkCanvas *canvas, const SkRegion &dirty)
+{
+    if (!gImages) {
+        return;
+    }
+    canvas->save();
+    canvas->clipRegion(dirty);
+    SkSamplingOptions sampling(SkFilterMode::kLinear, SkMipmapMode::kNone);
+    for (size_t i = 0; i < gImageHandles.size(); ++i) {
+        sk_sp<SkImage> image = gImages->image(gImageHandles[i]);
+        if (!image) {
             continue;
         }
+        // 비율 유지하며 칸 안에 맞춤
+        SkRect cell = SkRect::Make(thumbnailBounds(i));
+        float scale = std::min(cell.width() / image->width(), cell.height() / image->height());
+        SkRect dst = SkRect::MakeXYWH(cell.fLeft, cell.fTop, image->width() * scale, image->height() * scale);
+        canvas->drawImageRect(image, dst, sampling);
+    }
+    canvas->restore();
+}
 
-        if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
-            bestDevice = device;
-            break;
-        }
-        if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU) {
-            bestDevice = device; // 외장 없을 경우 사용 (iGPU)
-        }
+// 렌더 스레드에서 (창 모드는 scheduler 타이머로): 새로 준비된 이미지가 있으면 썸네일 영역 damage (headless 는 nullptr)
+static void pollImages(DamageTracker *damage)
+{
+    if (gImages && gImages->poll() > 0 && damage) {
+        damage->add(SkIRect::MakeLTRB(0, 0, thumbnailBounds(gImageHandles.size()).fLeft,
+                                     kThumbnailSize + 2 * kThumbnailPadding));
     }
-    if (bestDevice == VK_NULL_HANDLE) {
-        std::cerr << "No suitable hardware GPU found!" << std::endl;
-        return false;
+}
+
+static std::unique_ptr<ImageManager> createImageManager(const AppOptions &options, const VulkanContext &vkCtx,
+                                                        GrDirectContext *skContext)
+{
+    if (options.images.empty()) {
+        return nullptr;
     }
-    vkCtx.physicalDevice = bestDevice;
-    
-    // --- Queue Family ---
-    uint32_t queueFamilyCount = 0;
-    vkGetPhysicalDeviceQueueFamilyProperties(vkCtx.physicalDevice, &queueFamilyCount, nullptr);
-    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
-    vkGetPhysicalDeviceQueueFamilyProperties(vkCtx.physicalDevice, &queueFamilyCount, queueFamilies.data());
-    bool found = false;
-    for (uint32_t i = 0; i < queueFamilyCount; ++i) {
-        VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(vkCtx.physicalDevice, i, vkCtx.surface, &presentSupport);
-        if ((queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) && presentSupport) {
-            vkCtx.queueFamilyIndex = i;
-            found = true;
-            break;
+    auto images = std::make_unique<ImageManager>(skContext, &vkCtx, options.imageManager);
+    for (const std::string &path : options.images) {
+        gImageHandles.push_back(images->load(path));
+    }
+    std::cout << "Loading " << options.images.size() << " images ("
+              << (images->usesTransferQueue() ? "transfer queue" : "render thread") << " upload)" << std::endl;
+    gImages = images.get();
+    return images;
+}
+
+static void destroyImageManager(std::unique_ptr<ImageManager> &images)
+{
+    if (images) {
+        images->printStats(std::cout);
+    }
+    gImages = nullptr;
+    images.reset();
+}
+
+// 워크로드는 매 프레임 전체를 다시 그리므로 dirty 를 쓰지 않는다
+static void drawContent(SkCanvas *canvas, const SkRegion &dirty, Workload *workload, int frame)
+{
+    if (workload) {
+        workload->draw(canvas, frame);
+    } else {
+        drawFrame(canvas, dirty);
+    }
+    drawImages(canvas, dirty);
+}
+
+// ddl 이 있으면 SkPicture 로 기록한 뒤 worker 들이 band 별 DDL 로 기록하고, 여기서는 replay 만 한다
+static bool renderFrame(SkSurface *surface, const SkRegion &dirty, Workload *workload, int frame, DdlRenderer *ddl)
+{
+    if (!ddl) {
+        drawContent(surface->getCanvas(), dirty, workload, frame);
+        return true;
+    }
+    SkPictureRecorder recorder;
+    drawContent(recorder.beginRecording(SkRect::MakeIWH(surface->width(), surface->height())), dirty, workload, frame);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+    return ddl->render(surface, picture.get());
+}
+
+// --workload / --ddl 옵션에 따라 생성 (없으면 nullptr)
+static bool createRenderers(const AppOptions &options, const VulkanContext &vkCtx,
+                            std::unique_ptr<Workload> &workload, std::unique_ptr<DdlRenderer> &ddl)
+{
+    if (!options.workload.empty()) {
+        workload = makeWorkload(options.workload, vkCtx.extent.width, vkCtx.extent.height);
+        if (!workload) {
+            std::cerr << "Unknown workload: " << options.workload << std::endl;
+            return false;
         }
     }
-    if (!found) {
-        std::cerr << "No suitable queue family\n";
-        return false;
+    if (options.ddlChunks >= 0) {
+        ddl = std::make_unique<DdlRenderer>(options.ddlChunks, options.ddlThreads);
+        std::cout << "DDL recording: " << ddl->chunkCount() << " bands on " << ddl->threadCount() << " threads"
+                  << std::endl;
     }
-    float queuePriority = 1.0f;
-    VkDeviceQueueCreateInfo queueInfo{VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
-    queueInfo.queueFamilyIndex = vkCtx.queueFamilyIndex;
-    queueInfo.queueCount = 1;
-    queueInfo.pQueuePriorities = &queuePriority;
-
-    const char *deviceExts[] = {"VK_KHR_swapchain"};
-    VkDeviceCreateInfo deviceInfo{VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
-    deviceInfo.queueCreateInfoCount = 1;
-    deviceInfo.pQueueCreateInfos = &queueInfo;
-    deviceInfo.enabledExtensionCount = 1;
-    deviceInfo.ppEnabledExtensionNames = deviceExts;
-
-    if (vkCreateDevice(vkCtx.physicalDevice, &deviceInfo, nullptr, &vkCtx.device) != VK_SUCCESS) {
-        std::cerr << "Failed to create device" << std::endl;
+    return true;
+}
+
+static bool savePng(SkSurface *surface, const std::string &path)
+{
+    SkImageInfo info = SkImageInfo::MakeN32Premul(surface->width(), surface->height());
+    std::vector<uint8_t> pixels(info.computeMinByteSize());
+    SkPixmap pixmap(info, pixels.data(), info.minRowBytes());
+    if (!surface->readPixels(pixmap, 0, 0)) {
+        std::cerr << "Failed to read back pixels" << std::endl;
         return false;
     }
-    vkGetDeviceQueue(vkCtx.device, vkCtx.queueFamilyIndex, 0, &vkCtx.queue);
 
-    // --- Swapchain ---
-    VkSurfaceCapabilitiesKHR surfCaps;
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(vkCtx.physicalDevice, vkCtx.surface, &surfCaps);
-    vkCtx.extent = {WIDTH, HEIGHT};
+    SkFILEWStream file(path.c_str());
+    if (!file.isValid() || !SkPngEncoder::Encode(&file, pixmap, SkPngEncoder::Options())) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return false;
+    }
+    std::cout << "PNG saved: " << path << std::endl;
+    return true;
+}
 
-    uint32_t formatCount;
-    vkGetPhysicalDeviceSurfaceFormatsKHR(vkCtx.physicalDevice, vkCtx.surface, &formatCount, nullptr);
-    std::vector<VkSurfaceFormatKHR> formats(formatCount);
-    vkGetPhysicalDeviceSurfaceFormatsKHR(vkCtx.physicalDevice, vkCtx.surface, &formatCount, formats.data());
+static void endFrameStats(const AppOptions &options, FrameStats &stats)
+{
+    stats.endFrame();
+    if (options.statsInterval > 0 && stats.frameCount() % options.statsInterval == 0) {
+        stats.printSummary(std::cout);
+    }
+}
 
-    // UNORM format 우선 (SRGB는 Skia wrap 설정이 어려움, 생성 실패할 수 있음)
-    vkCtx.format = formats[0].format;
-    VkColorSpaceKHR colorSpace = formats[0].colorSpace;
+// 첫 프레임이 끝나면 시작 단계별 시간을 출력
+static void finishStartupTrace(int firstFramePhase)
+{
+    StartupTracer::instance().end(firstFramePhase);
+    StartupTracer::instance().print(std::cout);
+}
 
-    for (const auto &fmt : formats)
-    {
-        std::cout << "Available: format=" << fmt.format << ", colorSpace=" << fmt.colorSpace << std::endl;
-        // BGRA UNORM 우선
-        if (fmt.format == VK_FORMAT_B8G8R8A8_UNORM)
-        {
-            vkCtx.format = fmt.format;
-            colorSpace = fmt.colorSpace;
-            std::cout << "Selected: VK_FORMAT_B8G8R8A8_UNORM (" << vkCtx.format << ")" << std::endl;
-            break;
-        }
-        if (fmt.format == VK_FORMAT_R8G8B8A8_UNORM)
-        {
-            vkCtx.format = fmt.format;
-            colorSpace = fmt.colorSpace;
-            std::cout << "Selected: VK_FORMAT_R8G8B8A8_UNORM (" << vkCtx.format << ")" << std::endl;
-            break;
-        }
-        if (vkCtx.format == formats[0].format)
-        {
-            std::cout << "Using default format: " << vkCtx.format << std::endl;
+static void dumpFrameStats(const AppOptions &options, const FrameStats &stats, const VulkanContext &vkCtx)
+{
+    stats.printSummary(std::cout);
+    if (vkCtx.shaderCache) {
+        vkCtx.shaderCache->printStats(std::cout);
+    }
+    printVulkanMemoryStats(vkCtx, std::cout);
+    if (!options.statsCsvPath.empty() && !stats.writeCsv(options.statsCsvPath)) {
+        std::cerr << "Failed to write " << options.statsCsvPath << std::endl;
+    }
+    if (!options.statsJsonPath.empty() && !stats.writeJson(options.statsJsonPath)) {
+        std::cerr << "Failed to write " << options.statsJsonPath << std::endl;
+    }
+    if (EventTracer *tracer = EventTracer::Get()) {
+        tracer->setEnabled(false);
+        if (!tracer->writeJson()) {
+            std::cerr << "Failed to write " << tracer->path() << std::endl;
         }
     }
+}
 
-    VkSwapchainCreateInfoKHR swapInfo{VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR};
-    swapInfo.surface = vkCtx.surface;
-    swapInfo.minImageCount = surfCaps.minImageCount + 1;
-    swapInfo.imageFormat = vkCtx.format;
-    swapInfo.imageColorSpace = colorSpace;
-    swapInfo.imageExtent = vkCtx.extent;
-    swapInfo.imageArrayLayers = 1;
-    swapInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-    swapInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    swapInfo.preTransform = surfCaps.currentTransform;
-    swapInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    swapInfo.presentMode = VK_PRESENT_MODE_FIFO_KHR;
-    swapInfo.clipped = VK_TRUE;
-    swapInfo.oldSwapchain = VK_NULL_HANDLE;
-
-    if (vkCreateSwapchainKHR(vkCtx.device, &swapInfo, nullptr, &vkCtx.swapchain) != VK_SUCCESS)
-    {
-        std::cerr << "Failed to create swapchain\n";
-        return false;
+// 슬롯의 이전 프레임 GPU 시간을 stats 에 반영 (waitForFrameSlot 이후)
+static void collectGpuTime(VkGpuTimer &gpuTimer, VulkanContext &vkCtx, uint32_t slot, FrameStats &stats)
+{
+    uint64_t gpuFrame;
+    double gpuMs;
+    if (gpuTimer.collect(vkCtx.device, slot, &gpuFrame, &gpuMs)) {
+        stats.setGpuTime(gpuFrame, gpuMs);
     }
+}
 
-    uint32_t imageCount;
-    vkGetSwapchainImagesKHR(vkCtx.device, vkCtx.swapchain, &imageCount, nullptr);
-    vkCtx.images.resize(imageCount);
-    vkGetSwapchainImagesKHR(vkCtx.device, vkCtx.swapchain, &imageCount, vkCtx.images.data());
+// GLFW 콜백에서 접근하는 상태 (glfwSetWindowUserPointer)
+struct WindowState
+{
+    bool framebufferResized = false;
+    DamageTracker damage;
+    FrameScheduler *scheduler = nullptr;
+};
 
-    std::cout << "SurfCaps imageCount: " << surfCaps.minImageCount 
-            << ", Swapchain imageCount: " << imageCount << std::endl;
+static void framebufferResizeCallback(GLFWwindow *window, int, int)
+{
+    WindowState *state = static_cast<WindowState *>(glfwGetWindowUserPointer(window));
+    state->framebufferResized = true;
+    state->scheduler->invalidate();
+}
 
+// compositor 가 없는 환경에서 창이 가려졌다 드러나면 내용을 다시 그려야 함
+static void windowRefreshCallback(GLFWwindow *window)
+{
+    WindowState *state = static_cast<WindowState *>(glfwGetWindowUserPointer(window));
+    state->damage.addFull();
+    state->scheduler->invalidate();
+}
 
-    // --- Skia Vulkan Context ---
-    skgpu::VulkanBackendContext backendContext{};
-    backendContext.fInstance = vkCtx.instance;
-    backendContext.fPhysicalDevice = vkCtx.physicalDevice;
-    backendContext.fDevice = vkCtx.device;
-    backendContext.fQueue = vkCtx.queue;
-    backendContext.fGraphicsQueueIndex = vkCtx.queueFamilyIndex;
-    backendContext.fMaxAPIVersion = VK_API_VERSION_1_3;
-    backendContext.fGetProc = [](const char *procName, VkInstance inst, VkDevice dev) -> PFN_vkVoidFunction
-    {
-        PFN_vkVoidFunction func = nullptr;
-        if (dev != VK_NULL_HANDLE)
-        {
-            func = vkGetDeviceProcAddr(dev, procName);
-        }
-        if (!func && inst != VK_NULL_HANDLE)
-        {
-            func = vkGetInstanceProcAddr(inst, procName);
-        }
-        if (!func)
-        {
-            func = vkGetInstanceProcAddr(VK_NULL_HANDLE, procName);
-        }
-        // std::cout << "func ret = " << func << ", proc name: " << procName << std::endl;
-        return func;
-    };
-
-    std::cout << "Instance: " << vkCtx.instance
-              << ", PhysicalDevice: " << vkCtx.physicalDevice
-              << ", Device: " << vkCtx.device
-              << ", Queue: " << vkCtx.queue
-              << ", QueueFamilyIndex: " << vkCtx.queueFamilyIndex
-              << std::endl;
-
-    skContext = GrDirectContexts::MakeVulkan(backendContext);
-    if (!skContext)
-    {
-        std::cerr << "Failed to create Skia Vulkan context\n";
+// T: trace 기록 on/off (문제 구간만 잡을 때)
+static void keyCallback(GLFWwindow *, int key, int, int action, int)
+{
+    EventTracer *tracer = EventTracer::Get();
+    if (key == GLFW_KEY_T && action == GLFW_PRESS && tracer) {
+        tracer->setEnabled(!tracer->isEnabled());
+        std::cout << "Tracing " << (tracer->isEnabled() ? "on" : "off") << std::endl;
+    }
+}
+
+static void cursorPosCallback(GLFWwindow *window, double x, double y)
+{
+    WindowState *state = static_cast<WindowState *>(glfwGetWindowUserPointer(window));
+    state->damage.add(cursorBounds(gCursor));
+    gCursor = SkPoint::Make(static_cast<float>(x), static_cast<float>(y));
+    state->damage.add(cursorBounds(gCursor));
+    state->scheduler->invalidate();
+}
+
+static void resetDamage(const VulkanContext &vkCtx, DamageTracker &damage)
+{
+    damage.reset(SkIRect::MakeWH(vkCtx.extent.width, vkCtx.extent.height),
+                 static_cast<int>(vkCtx.images.size()));
+}
+
+// 최소화(0x0) 상태면 복원될 때까지 이벤트 대기 후 swapchain 재생성
+static bool handleResize(GLFWwindow *window, VulkanContext &vkCtx, GrDirectContext *skContext,
+                         DamageTracker &damage)
+{
+    int width = 0, height = 0;
+    glfwGetFramebufferSize(window, &width, &height);
+    while ((width == 0 || height == 0) && !glfwWindowShouldClose(window)) {
+        glfwWaitEvents();
+        glfwGetFramebufferSize(window, &width, &height);
+    }
+    if (glfwWindowShouldClose(window)) {
+        return true;
+    }
+    if (!recreateSwapchain(vkCtx, skContext, width, height)) {
+        std::cerr << "Failed to recreate swapchain" << std::endl;
         return false;
     }
+    resetDamage(vkCtx, damage);
+    return true;
+}
+
+// 디스플레이 없이 offscreen 이미지를 돌려가며 렌더링 (CI / 배치 서버용)
+static int runHeadless(const AppOptions &options)
+{
+    VulkanContext vkCtx{};
+    sk_sp<GrDirectContext> skContext;
 
-    // Create Skia surfaces
-    vkCtx.skSurfaces.resize(vkCtx.images.size());
-    for (size_t i = 0; i < vkCtx.images.size(); ++i)
+    if (!setupVulkan(nullptr, options.vulkan, vkCtx, skContext))
     {
-        GrVkImageInfo imgInfo{};
-        imgInfo.fImage = vkCtx.images[i];
-        imgInfo.fImageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        imgInfo.fFormat = vkCtx.format;
-        imgInfo.fLevelCount = 1;
-        imgInfo.fCurrentQueueFamily = vkCtx.queueFamilyIndex;
-
-        GrBackendRenderTarget backendRT = GrBackendRenderTargets::MakeVk(WIDTH, HEIGHT, imgInfo);
-        if (!backendRT.isValid())
+        std::cerr << "Failed Vulkan setup\n";
+        destroyVulkan(vkCtx, skContext);
+        return -1;
+    }
+
+    if (options.warmUp) {
+        StartupPhase phase("shader warm-up");
+        SkSurfaceProps props(vkCtx.surfaceFlags, kUnknown_SkPixelGeometry);
+        warmUpShaders(skContext.get(), colorTypeForFormat(vkCtx.format), vkCtx.sampleCount, &props);
+    }
+
+    FrameStats stats;
+    stats.setStartTime(options.launchTime);
+    VkGpuTimer gpuTimer;
+    gpuTimer.init(vkCtx);
+    FrameCapture capture;
+    std::unique_ptr<Workload> workload;
+    std::unique_ptr<DdlRenderer> ddl;
+    if (!capture.init(options.capture) || !createRenderers(options, vkCtx, workload, ddl)) {
+        destroyVulkan(vkCtx, skContext);
+        return -1;
+    }
+
+    GpuMemoryManager gpuMemory(skContext.get(), options.gpuMemory);
+    std::unique_ptr<ImageManager> images = createImageManager(options, vkCtx, skContext.get());
+
+    int firstFramePhase = StartupTracer::instance().begin("first frame");
+    size_t imageIndex = 0;
+    for (int frame = 0; frame < options.frames; ++frame) {
+        uint64_t frameNumber = stats.beginFrame();
+        uint32_t slot = vkCtx.frameIndex;
         {
-            std::cerr << "Invalid GrBackendRenderTarget for image " << i << std::endl;
-            continue;
+            ScopedStageTimer timer(stats, FrameStage::kAcquire);
+            waitForFrameSlot(vkCtx);
         }
+        collectGpuTime(gpuTimer, vkCtx, slot, stats);
+        pollImages(nullptr);
 
-        SkColorType colorType;
-        if (vkCtx.format == VK_FORMAT_B8G8R8A8_UNORM || vkCtx.format == VK_FORMAT_B8G8R8A8_SRGB)
-        {
-            colorType = kBGRA_8888_SkColorType;
+        imageIndex = frame % vkCtx.images.size();
+        SkSurface *surface = surfaceForImage(vkCtx, skContext.get(), static_cast<uint32_t>(imageIndex));
+        if (!surface) {
+            break;
         }
-        else if (vkCtx.format == VK_FORMAT_R8G8B8A8_UNORM || vkCtx.format == VK_FORMAT_R8G8B8A8_SRGB)
         {
-            colorType = kRGBA_8888_SkColorType;
+            ScopedStageTimer timer(stats, FrameStage::kRecord);
+            SkRegion dirty(SkIRect::MakeWH(vkCtx.extent.width, vkCtx.extent.height));
+            if (!renderFrame(surface, dirty, workload.get(), frame, ddl.get())) {
+                break;
+            }
         }
-        else
+        capture.request(surface, frameNumber);
         {
-            colorType = kRGBA_8888_SkColorType;
+            ScopedStageTimer timer(stats, FrameStage::kFlush);
+            gpuTimer.begin(vkCtx.queue, slot, frameNumber);
+            skContext->flushAndSubmit();
+            gpuTimer.end(vkCtx.queue, slot);
+            submitFrameFence(vkCtx);
         }
-
-        vkCtx.skSurfaces[i] = SkSurfaces::WrapBackendRenderTarget(
-            skContext.get(),
-            backendRT,
-            kTopLeft_GrSurfaceOrigin,
-            colorType,
-            nullptr, // colorSpace
-            nullptr  // surfaceProps
-        );
-
-        if (!vkCtx.skSurfaces[i])
-        {
-            std::cerr << "Failed to wrap surface " << i << std::endl;
-            return false;
+        capture.poll(skContext.get());
+        gpuMemory.endFrame();
+        endFrameStats(options, stats);
+        if (stats.frameCount() == 1) {
+            finishStartupTrace(firstFramePhase);
         }
     }
+    capture.finish(skContext.get());
+    skContext->flushAndSubmit(GrSyncCpu::kYes);
+    vkDeviceWaitIdle(vkCtx.device);
+    for (uint32_t slot = 0; slot < vkCtx.frames.size(); ++slot) {
+        collectGpuTime(gpuTimer, vkCtx, slot, stats);
+    }
+    std::cout << "Rendered " << options.frames << " headless frames" << std::endl;
+    dumpFrameStats(options, stats, vkCtx);
+    destroyImageManager(images);
+    gpuMemory.finish();
+    gpuTimer.destroy(vkCtx.device);
+
+    int ret = 0;
+    SkSurface *lastSurface = surfaceForImage(vkCtx, skContext.get(), static_cast<uint32_t>(imageIndex));
+    if (!options.outputPath.empty() && (!lastSurface || !savePng(lastSurface, options.outputPath))) {
+        ret = -1;
+    }
 
-    return true;
-}
-
-void drawFrame(SkCanvas *canvas)
-{
-    canvas->clear(SK_ColorWHITE);
-    SkPaint paint;
-    paint.setAntiAlias(true);
-    paint.setStyle(SkPaint::kFill_Style);
-    paint.setColor(SK_ColorRED);
-
-    SkPath triangle;
-    triangle.moveTo(400, 100);
-    triangle.lineTo(200, 500);
-    triangle.lineTo(600, 500);
-    triangle.close();
-
-    canvas->drawPath(triangle, paint);
+    destroyVulkan(vkCtx, skContext);
+    return ret;
 }
 
-int main()
+int main(int argc, char **argv)
 {
-    if (!glfwInit()) {
+    AppOptions options;
+    StartupTracer::instance().setOrigin(options.launchTime);
+    if (!parseArgs(argc, argv, options)) {
         return -1;
     }
-
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Skia Vulkan", nullptr, nullptr);
-    if (!window) {
+    // 시작 단계도 trace 에 남도록 가장 먼저 설치
+    EventTracer::Install(options.trace);
+    // fontconfig 스캔은 다른 초기화와 독립적이므로 먼저 백그라운드로 시작
+    prewarmFontMgr();
+    if (!loadScene(options)) {
         return -1;
     }
+    if (options.vulkan.headless) {
+        return runHeadless(options);
+    }
+
+    {
+        StartupPhase phase("glfw init");
+        if (!glfwInit()) {
+            return -1;
+        }
+    }
 
+    // Vulkan instance 생성은 창과 무관하므로 창 생성(main 스레드 필수)과 병렬로
     VulkanContext vkCtx{};
     sk_sp<GrDirectContext> skContext;
+    std::future<bool> instanceReady =
+            std::async(std::launch::async, [&] { return createVulkanInstance(options.vulkan, vkCtx); });
 
-    if (!setupVulkan(window, vkCtx, skContext))
+    GLFWwindow *window;
+    {
+        StartupPhase phase("glfw window");
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+        window = glfwCreateWindow(options.vulkan.width, options.vulkan.height, "Skia Vulkan", nullptr, nullptr);
+    }
+    if (!instanceReady.get() || !window) {
+        std::cerr << "Failed to create window or Vulkan instance\n";
+        destroyVulkan(vkCtx, skContext);
+        return -1;
+    }
+
+    if (!setupVulkan(window, options.vulkan, vkCtx, skContext))
     {
         std::cerr << "Failed Vulkan setup\n";
         return -1;
     }
-    std::cout << "Setup vulkan Successfully" << std::endl;
 
-    while (!glfwWindowShouldClose(window))
+    if (options.warmUp) {
+        StartupPhase phase("shader warm-up");
+        SkSurfaceProps props(vkCtx.surfaceFlags, kUnknown_SkPixelGeometry);
+        warmUpShaders(skContext.get(), colorTypeForFormat(vkCtx.format), vkCtx.sampleCount, &props);
+    }
+
+    FrameStats stats;
+    stats.setStartTime(options.launchTime);
+    VkGpuTimer gpuTimer;
+    gpuTimer.init(vkCtx);
+    FrameCapture capture;
+    std::unique_ptr<Workload> workload;
+    std::unique_ptr<DdlRenderer> ddl;
+    if (!capture.init(options.capture) || !createRenderers(options, vkCtx, workload, ddl)) {
+        destroyVulkan(vkCtx, skContext);
+        return -1;
+    }
+
+    FrameScheduler scheduler(options.scheduler);
+    WindowState state;
+    state.scheduler = &scheduler;
+    resetDamage(vkCtx, state.damage);
+    glfwSetWindowUserPointer(window, &state);
+    glfwSetFramebufferSizeCallback(window, framebufferResizeCallback);
+    glfwSetWindowRefreshCallback(window, windowRefreshCallback);
+    glfwSetCursorPosCallback(window, cursorPosCallback);
+    glfwSetKeyCallback(window, keyCallback);
+
+    GpuMemoryManager gpuMemory(skContext.get(), options.gpuMemory);
+    std::unique_ptr<ImageManager> images = createImageManager(options, vkCtx, skContext.get());
+    // 한동안 그리지 않으면 한 번만 오래된 / scratch 리소스 정리
+    scheduler.setIdleCallback([&gpuMemory] { gpuMemory.onIdle(); });
+    // 워크로드는 매 프레임 애니메이션
+    if (workload) {
+        scheduler.beginAnimation();
+    }
+    // decode/업로드 중인 이미지가 있는 동안만 입력이 없어도 주기적으로 깨어나 확인
+    if (images) {
+        scheduler.addTimer(0.016, [&] {
+            pollImages(&state.damage);
+            if (state.damage.hasDamage()) {
+                scheduler.invalidate();
+            }
+            return images->pendingCount() > 0;
+        });
+    }
+
+    std::vector<VkRectLayerKHR> presentRects;
+    int firstFramePhase = StartupTracer::instance().begin("first frame");
+
+    while (scheduler.waitForFrame(window))
     {
-        glfwPollEvents();
+        if (state.framebufferResized) {
+            state.framebufferResized = false;
+            if (!handleResize(window, vkCtx, skContext.get(), state.damage)) {
+                break;
+            }
+            scheduler.invalidate();
+            continue;
+        }
+
+        // 워크로드 애니메이션과 --continuous 는 매 프레임 전체를 다시 그림
+        if (workload || options.scheduler.continuous) {
+            state.damage.addFull();
+        }
+        // 바뀐 것이 없으면 마지막으로 present 한 이미지가 그대로 유효.
+        // 그리지 않고 넘어가거나 대기한 뒤의 프레임은 간격에 idle 시간이 섞이므로 끊는다
+        if (!state.damage.hasDamage()) {
+            stats.markIdle();
+            continue;
+        }
+        if (scheduler.idledBeforeFrame()) {
+            stats.markIdle();
+        }
 
+        uint64_t frameNumber = stats.beginFrame();
+        uint32_t slot = vkCtx.frameIndex;
         uint32_t imageIndex;
-        VkResult result = vkAcquireNextImageKHR(vkCtx.device, vkCtx.swapchain, UINT64_MAX,
-                                                VK_NULL_HANDLE, VK_NULL_HANDLE, &imageIndex);
-        if (result != VK_SUCCESS)
+        VkResult result;
+        FrameSync *frame;
+        {
+            ScopedStageTimer timer(stats, FrameStage::kAcquire);
+            // framesInFlight 만큼 앞선 프레임의 GPU 작업이 끝날 때까지만 대기
+            frame = &waitForFrameSlot(vkCtx);
+            result = vkAcquireNextImageKHR(vkCtx.device, vkCtx.swapchain, UINT64_MAX,
+                                           frame->acquireSemaphore, VK_NULL_HANDLE, &imageIndex);
+        }
+        collectGpuTime(gpuTimer, vkCtx, slot, stats);
+        if (result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            // 그리지 못한 프레임은 기록하지 않고 닫은 뒤 새 swapchain 으로 다시 그린다
+            stats.cancelFrame();
+            if (!handleResize(window, vkCtx, skContext.get(), state.damage)) {
+                break;
+            }
+            scheduler.invalidate();
+            continue;
+        }
+        if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+        {
+            // DEVICE_LOST / SURFACE_LOST 등은 다시 acquire 해도 같은 결과이므로 루프를 끝낸다
+            std::cerr << "Failed to acquire swapchain image (VkResult " << result << ")" << std::endl;
+            stats.cancelFrame();
+            break;
+        }
+
+        SkSurface *surface = surfaceForImage(vkCtx, skContext.get(), imageIndex);
+        if (!surface) {
+            stats.cancelFrame();
+            break;
+        }
+
         {
-            std::cerr << "Failed to acquire swapchain image" << std::endl;
+            ScopedStageTimer timer(stats, FrameStage::kRecord);
+            if (!renderFrame(surface, state.damage.beginFrame(imageIndex), workload.get(),
+                             static_cast<int>(frameNumber), ddl.get())) {
+                break;
+            }
         }
+        capture.request(surface, frameNumber);
 
-        if (vkCtx.skSurfaces[imageIndex])
+        GrSemaphoresSubmitted submitted;
         {
-            drawFrame(vkCtx.skSurfaces[imageIndex]->getCanvas());
-            skContext->flushAndSubmit();
+            ScopedStageTimer timer(stats, FrameStage::kFlush);
+            GrBackendSemaphore renderSemaphore = GrBackendSemaphores::MakeVk(vkCtx.renderSemaphores[imageIndex]);
+            GrFlushInfo flushInfo;
+            flushInfo.fNumSemaphores = 1;
+            flushInfo.fSignalSemaphores = &renderSemaphore;
+            // 이미지가 실제로 사용 가능해진 뒤에 Skia 명령이 실행되도록 GPU 측 대기.
+            // GPU timer 가 있으면 begin timestamp submit 이 acquire 를 대신 기다리므로
+            // Skia 는 그 submit 을 기다린다 (GPU 시간에 acquire 대기가 섞이지 않도록).
+            // Vulkan 에서 Skia 의 wait semaphore 는 다음 submit 전체에 걸리므로 기록 뒤에 걸어도 된다.
+            VkSemaphore skiaWait = frame->acquireSemaphore;
+            if (gpuTimer.begin(vkCtx.queue, slot, frameNumber, frame->acquireSemaphore)) {
+                skiaWait = gpuTimer.startedSemaphore(slot);
+            }
+            GrBackendSemaphore waitSemaphore = GrBackendSemaphores::MakeVk(skiaWait);
+            surface->wait(1, &waitSemaphore, /*deleteSemaphoresAfterWait=*/false);
+            submitted = skContext->flush(surface, SkSurfaces::BackendSurfaceAccess::kPresent, flushInfo);
+            skContext->submit();
+            gpuTimer.end(vkCtx.queue, slot);
+            submitFrameFence(vkCtx);
         }
+        capture.poll(skContext.get());
 
         // Present swapchain
         VkPresentInfoKHR presentInfo{VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
+        if (submitted == GrSemaphoresSubmitted::kYes) {
+            presentInfo.waitSemaphoreCount = 1;
+            presentInfo.pWaitSemaphores = &vkCtx.renderSemaphores[imageIndex];
+        }
         presentInfo.swapchainCount = 1;
         presentInfo.pSwapchains = &vkCtx.swapchain;
         presentInfo.pImageIndices = &imageIndex;
 
-        vkQueuePresentKHR(vkCtx.queue, &presentInfo);
+        // 이번 프레임에 바뀐 영역만 compositor 에 알림
+        VkPresentRegionKHR presentRegion{};
+        VkPresentRegionsKHR presentRegions{VK_STRUCTURE_TYPE_PRESENT_REGIONS_KHR};
+        if (vkCtx.incrementalPresent) {
+            presentRects.clear();
+            for (SkRegion::Iterator it(state.damage.frameDamage()); !it.done(); it.next()) {
+                const SkIRect &r = it.rect();
+                presentRects.push_back({{r.fLeft, r.fTop},
+                                        {static_cast<uint32_t>(r.width()), static_cast<uint32_t>(r.height())},
+                                        0});
+            }
+            presentRegion.rectangleCount = static_cast<uint32_t>(presentRects.size());
+            presentRegion.pRectangles = presentRects.data();
+            presentRegions.swapchainCount = 1;
+            presentRegions.pRegions = &presentRegion;
+            presentInfo.pNext = &presentRegions;
+        }
+
+        {
+            ScopedStageTimer timer(stats, FrameStage::kPresent);
+            result = vkQueuePresentKHR(vkCtx.queue, &presentInfo);
+        }
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+            state.framebufferResized = true;
+            scheduler.invalidate();
+        }
+        gpuMemory.endFrame();
+        endFrameStats(options, stats);
+        if (stats.frameCount() == 1) {
+            finishStartupTrace(firstFramePhase);
+        }
     }
 
-    for (auto &s : vkCtx.skSurfaces)
-        s.reset();
-    skContext.reset();
+    capture.finish(skContext.get());
+    vkDeviceWaitIdle(vkCtx.device);
+    for (uint32_t slot = 0; slot < vkCtx.frames.size(); ++slot) {
+        collectGpuTime(gpuTimer, vkCtx, slot, stats);
+    }
+    scheduler.printStats(std::cout);
+    dumpFrameStats(options, stats, vkCtx);
+    destroyImageManager(images);
+    gpuMemory.finish();
+    gpuTimer.destroy(vkCtx.device);
 
-    vkDestroySwapchainKHR(vkCtx.device, vkCtx.swapchain, nullptr);
-    vkDestroyDevice(vkCtx.device, nullptr);
-    vkDestroySurfaceKHR(vkCtx.instance, vkCtx.surface, nullptr);
-    vkDestroyInstance(vkCtx.instance, nullptr);
+    destroyVulkan(vkCtx, skContext);
 
     glfwDestroyWindow(window);
     glfwTerminate();
@@ -0,0 +1,256 @@
+// 백엔드를 실행 시 선택하는 샘플: 같은 scene / 워크로드를 raster, tiled, GL, Vulkan 에서 그린다
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <GLFW/glfw3.h>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkStream.h"
+
+#include "aa_mode.h"
+#include "event_tracer.h"
+#include "font_manager.h"
+#include "frame_stats.h"
+#include "image_encoder.h"
+#include "render_backend.h"
+#include "scene_file.h"
+#include "workloads.h"
+
+struct SampleOptions
+{
+    std::string backend = "auto";
+    BackendConfig config;
+    int frames = 0;            // 0 이면 headless 100, 창 모드는 닫을 때까지
+    std::string workload;
+    std::string scenePath;
+    std::string outputPath;    // 마지막 프레임을 PNG 로 저장
+    std::string statsCsvPath;
+    std::string statsJsonPath;
+    TraceOptions trace;
+};
+
+static void printUsage(const char *argv0)
+{
+    std::cout << "Usage: " << argv0 << " [options]\n"
+              << "  --backend=NAME        auto | raster | tiled | gl | vulkan (default auto: vulkan > gl > raster)\n"
+              << "  --headless            render offscreen without a window (required for raster / tiled)\n"
+              << "  --frames=N            frames to render (default 100 headless, until closed otherwise)\n"
+              << "  --size=WxH            render target size (default 800x600)\n"
+              << "  --workload=NAME       draw a benchmark workload instead of the triangle scene\n"
+              << "  --scene=FILE          draw a binary scene (.skscene)\n"
+              << "  --output=FILE         save the last frame as PNG\n"
+              << "  --threads=N           tiled backend threads (default hardware concurrency)\n"
+              << "  --tile-size=N         tiled backend tile size (default 256)\n"
+              << "  --device=NAME         force Vulkan device whose name contains NAME\n"
+              << "  --prefer=cpu          prefer a software Vulkan device (lavapipe)\n"
+              << "  --aa=MODE             coverage | msaa[N] | dmsaa for gl / vulkan (default coverage)\n"
+              << "  --internal-msaa=N     sample count for Skia's internal offscreen targets (0 disables)\n"
+              << "  --trace=FILE          write Skia and app trace events as Chrome trace JSON on exit\n"
+              << "  --trace-categories=L  comma list, -x excludes, x* prefix (default *)\n"
+              << "  --stats-csv=FILE      dump per-frame timings as CSV on exit\n"
+              << "  --stats-json=FILE     dump per-frame timings and percentiles as JSON on exit\n";
+}
+
+static bool parseArgs(int argc, char **argv, SampleOptions &options)
+{
+    options.config.headless = false;
+    options.config.title = "Skia";
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (strncmp(arg, "--backend=", 10) == 0) {
+            options.backend = arg + 10;
+        } else if (strcmp(arg, "--headless") == 0) {
+            options.config.headless = true;
+        } else if (strncmp(arg, "--frames=", 9) == 0) {
+            options.frames = std::max(0, atoi(arg + 9));
+        } else if (strncmp(arg, "--size=", 7) == 0) {
+            if (sscanf(arg + 7, "%dx%d", &options.config.width, &options.config.height) != 2 ||
+                options.config.width <= 0 || options.config.height <= 0) {
+                std::cerr << "Invalid size: " << arg + 7 << std::endl;
+                return false;
+            }
+        } else if (strncmp(arg, "--workload=", 11) == 0) {
+            options.workload = arg + 11;
+        } else if (strncmp(arg, "--scene=", 8) == 0) {
+            options.scenePath = arg + 8;
+        } else if (strncmp(arg, "--output=", 9) == 0) {
+            options.outputPath = arg + 9;
+        } else if (strncmp(arg, "--threads=", 10) == 0) {
+            options.config.tiles.threads = std::max(0, atoi(arg + 10));
+        } else if (strncmp(arg, "--tile-size=", 12) == 0) {
+            options.config.tiles.tileSize = std::max(16, atoi(arg + 12));
+        } else if (strncmp(arg, "--device=", 9) == 0) {
+            options.config.device.forcedName = arg + 9;
+        } else if (strcmp(arg, "--prefer=cpu") == 0) {
+            options.config.device.preference = DevicePreference::kCpu;
+        } else if (parseAaArg(arg, options.config.aa)) {
+        } else if (parseTraceArg(arg, options.trace)) {
+        } else if (strncmp(arg, "--stats-csv=", 12) == 0) {
+            options.statsCsvPath = arg + 12;
+        } else if (strncmp(arg, "--stats-json=", 13) == 0) {
+            options.statsJsonPath = arg + 13;
+        } else {
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    if (options.frames == 0 && options.config.headless) {
+        options.frames = 100;
+    }
+    return true;
+}
+
+static void drawTriangle(SkCanvas *canvas)
+{
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorRED);
+
+    SkPath triangle;
+    triangle.moveTo(400, 100);
+    triangle.lineTo(200, 500);
+    triangle.lineTo(600, 500);
+    triangle.close();
+    canvas->drawPath(triangle, paint);
+}
+
+static bool savePng(RenderBackend &backend, const std::string &path)
+{
+    SkImageInfo info = SkImageInfo::MakeN32Premul(backend.width(), backend.height());
+    std::vector<uint8_t> pixels(info.computeMinByteSize());
+    SkPixmap pixmap(info, pixels.data(), info.minRowBytes());
+    if (!backend.readPixels(pixmap)) {
+        std::cerr << "Failed to read back pixels" << std::endl;
+        return false;
+    }
+    SkFILEWStream file(path.c_str());
+    if (!file.isValid() || !encodeImage(pixmap, EncodeOptions(), nullptr, &file)) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return false;
+    }
+    std::cout << "PNG saved: " << path << std::endl;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    auto launchTime = std::chrono::steady_clock::now();
+    SampleOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        return -1;
+    }
+    EventTracer::Install(options.trace);
+    prewarmFontMgr();
+
+    SceneFile sceneFile;
+    if (!options.scenePath.empty() && !sceneFile.open(options.scenePath)) {
+        return -1;
+    }
+    std::unique_ptr<Workload> workload;
+    if (!options.workload.empty()) {
+        workload = makeWorkload(options.workload, options.config.width, options.config.height);
+        if (!workload) {
+            std::cerr << "Unknown workload: " << options.workload << std::endl;
+            return -1;
+        }
+    }
+
+    // raster 는 GLFW 가 없어도 되지만 auto / gl / vulkan 은 창(또는 숨긴 창) 이 필요
+    bool glfwReady = glfwInit();
+    std::unique_ptr<RenderBackend> backend;
+    if (glfwReady || options.backend == "raster" || options.backend == "tiled") {
+        backend = makeRenderBackend(options.backend, options.config);
+    }
+    if (!backend) {
+        std::cerr << "Backend unavailable: " << options.backend << std::endl;
+        if (glfwReady) {
+            glfwTerminate();
+        }
+        return -1;
+    }
+    std::chrono::duration<double, std::milli> setupMs = std::chrono::steady_clock::now() - launchTime;
+    std::cout << "Backend: " << backend->name() << " (" << backend->width() << "x" << backend->height()
+              << ", setup " << setupMs.count() << " ms)" << std::endl;
+
+    FrameStats stats;
+    stats.setStartTime(launchTime);
+    GLFWwindow *window = backend->window();
+    int width = backend->width(), height = backend->height();
+    for (int frame = 0; options.frames == 0 || frame < options.frames; ++frame) {
+        if (window) {
+            glfwPollEvents();
+            if (glfwWindowShouldClose(window)) {
+                break;
+            }
+            int w = 0, h = 0;
+            glfwGetFramebufferSize(window, &w, &h);
+            if (w == 0 || h == 0) {
+                glfwWaitEvents();
+                continue;
+            }
+            if ((w != width || h != height) && backend->resize(w, h)) {
+                width = w;
+                height = h;
+            }
+        }
+
+        uint64_t frameNumber = stats.beginFrame();
+        SkCanvas *canvas = backend->beginFrame(stats, frameNumber);
+        if (!canvas) {
+            stats.cancelFrame();
+            if (backend->failed()) {
+                break;
+            }
+            continue;
+        }
+        {
+            ScopedStageTimer timer(stats, FrameStage::kRecord);
+            canvas->clear(SK_ColorWHITE);
+            if (workload) {
+                workload->draw(canvas, frame);
+            } else if (sceneFile.isOpen()) {
+                sceneFile.draw(canvas);
+            } else {
+                drawTriangle(canvas);
+            }
+        }
+        backend->endFrame(stats, frameNumber);
+        backend->present(stats);
+        stats.endFrame();
+    }
+    backend->finish(stats);
+
+    stats.printSummary(std::cout);
+    if (!options.statsCsvPath.empty() && !stats.writeCsv(options.statsCsvPath)) {
+        std::cerr << "Failed to write " << options.statsCsvPath << std::endl;
+    }
+    if (!options.statsJsonPath.empty() && !stats.writeJson(options.statsJsonPath)) {
+        std::cerr << "Failed to write " << options.statsJsonPath << std::endl;
+    }
+    if (EventTracer *tracer = EventTracer::Get()) {
+        tracer->setEnabled(false);
+        if (!tracer->writeJson()) {
+            std::cerr << "Failed to write " << tracer->path() << std::endl;
+        }
+    }
+    int ret = 0;
+    if (!options.outputPath.empty() && !savePng(*backend, options.outputPath)) {
+        ret = -1;
+    }
+
+    backend.reset();
+    if (glfwReady) {
+        glfwTerminate();
+    }
+    return ret;
+}
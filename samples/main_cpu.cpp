@@ -1,28 +1,31 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkFontMgr.h"
-#include "include/encode/SkPngEncoder.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkTextBlob.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
 
-int main() {
-    // SkSurfaces::Raster 함수는 SkSurface.h에 포함되어 있습니다.
-    SkImageInfo info = SkImageInfo::MakeN32Premul(800, 600);
-    
-    // SkSurfaces::Raster를 직접 호출합니다.
-    auto surface = SkSurfaces::Raster(info);
-    if (!surface) {
-        std::cerr << "Failed to create raster surface." << std::endl;
-        return 1;
-    }
-    
-    SkCanvas* canvas = surface->getCanvas();
+#include "async_image_writer.h"
+#include "batch_renderer.h"
+#include "image_encoder.h"
+#include "scene_file.h"
+#include "text_cache.h"
+#include "tiled_raster.h"
+#include "workloads.h"
 
+static void drawScene(SkCanvas* canvas) {
     SkPaint paint;
     paint.setColor(SK_ColorBLUE);
     paint.setAntiAlias(true);
@@ -36,31 +39,136 @@ int main() {
     paint.setColor(SK_ColorRED);
     canvas->drawPath(triangle, paint);
 
-    std::cout << "Skia CPU sample rendered successfully." << std::endl;
+    TextCache textCache;
+    paint.setColor(SK_ColorBLACK);
+    textCache.drawText(canvas, "Skia CPU sample", 50, 40, textCache.font("sans-serif", 20), paint);
+}
 
-    sk_sp<SkImage> image = surface->makeImageSnapshot();
-    if (!image) {
-        std::cerr << "Failed to create image snapshot." << std::endl;
-        return 1;
+int main(int argc, char** argv) {
+    int width = 800, height = 600;
+    TiledRasterOptions tileOptions;
+    std::string workloadName;
+    std::string scenePath;
+    std::string outputPath;
+    EncodeOptions encodeOptions;
+    bool batch = false;
+    BatchOptions batchOptions;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--size=", 7) == 0) {
+            sscanf(argv[i] + 7, "%dx%d", &width, &height);
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            tileOptions.threads = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--tile-size=", 12) == 0) {
+            tileOptions.tileSize = atoi(argv[i] + 12);
+        } else if (strncmp(argv[i], "--workload=", 11) == 0) {
+            workloadName = argv[i] + 11;
+        } else if (strncmp(argv[i], "--scene=", 8) == 0) {
+            scenePath = argv[i] + 8;
+        } else if (strncmp(argv[i], "--output=", 9) == 0) {
+            outputPath = argv[i] + 9;
+        } else if (strncmp(argv[i], "--format=", 9) == 0) {
+            if (!parseEncodeFormat(argv[i] + 9, &encodeOptions.format)) {
+                std::cerr << "Unknown format: " << argv[i] + 9 << " (png|qoi)" << std::endl;
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--preset=", 9) == 0) {
+            if (!parseEncodePreset(argv[i] + 9, &encodeOptions.preset)) {
+                std::cerr << "Unknown preset: " << argv[i] + 9 << " (fastest|balanced|smallest)" << std::endl;
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--frames=", 9) == 0) {
+            // N (0..N-1) 또는 A-B (양 끝 포함)
+            int first = 0, last = 0;
+            if (sscanf(argv[i] + 9, "%d-%d", &first, &last) == 2) {
+                batchOptions.firstFrame = first;
+                batchOptions.frameCount = last - first + 1;
+            } else {
+                batchOptions.firstFrame = 0;
+                batchOptions.frameCount = atoi(argv[i] + 9);
+            }
+            batch = true;
+        } else if (strncmp(argv[i], "--ring=", 7) == 0) {
+            batchOptions.ringSize = atoi(argv[i] + 7);
+        }
     }
 
-    SkFILEWStream file("output_skia_sample.png");
-    if (!file.isValid()) {
-        std::cerr << "Failed to open output file." << std::endl;
-        return 1;
+    SkImageInfo info = SkImageInfo::MakeN32Premul(width, height);
+
+    if (batch) {
+        // 애니메이션 frame 시퀀스: --output 은 frame 번호 자리(%05d 등)를 포함해야 함
+        if (batchOptions.frameCount <= 0) {
+            std::cerr << "Invalid frame range" << std::endl;
+            return 1;
+        }
+        if (workloadName.empty()) {
+            workloadName = "retained_scene";
+        }
+        std::unique_ptr<Workload> workload = makeWorkload(workloadName, width, height);
+        if (!workload) {
+            std::cerr << "Unknown workload: " << workloadName << std::endl;
+            return 1;
+        }
+        batchOptions.outputPattern =
+                outputPath.empty() ? std::string("frame_%05d.") + encodeFormatName(encodeOptions.format) : outputPath;
+        batchOptions.encode = encodeOptions;
+        batchOptions.tiles = tileOptions;
+        batchOptions.encodeThreads = tileOptions.threads;
+
+        BatchStats stats;
+        bool ok = runBatch(info, *workload, batchOptions, &stats);
+        stats.print(std::cout);
+        return ok ? 0 : 1;
     }
-    SkPngEncoder::Options options;
-    options.fZLibLevel = 9;
-    options.fFilterFlags = SkPngEncoder::FilterFlag::kNone;
-    // GrDirectContext 없는 CPU용 버전
-    auto pngData = SkPngEncoder::Encode(nullptr, image.get(), options);
-    if (pngData) {
-        file.write(pngData->data(), pngData->size());
-        std::cout << "PNG saved successfully!" << std::endl;
+
+    if (outputPath.empty()) {
+        outputPath = std::string("output_skia_sample.") + encodeFormatName(encodeOptions.format);
+    }
+
+    // scene 을 한 번 SkPicture 로 기록하고, 타일별로 여러 스레드에서 재생
+    auto start = std::chrono::steady_clock::now();
+    SkPictureRecorder recorder;
+    SkCanvas* recordingCanvas = recorder.beginRecording(SkRect::MakeWH(width, height));
+    SceneFile sceneFile;
+    if (!scenePath.empty()) {
+        if (!sceneFile.open(scenePath)) {
+            return 1;
+        }
+        sceneFile.draw(recordingCanvas);
+    } else if (workloadName.empty()) {
+        drawScene(recordingCanvas);
     } else {
-        std::cerr << "Failed to encode PNG." << std::endl;
+        std::unique_ptr<Workload> workload = makeWorkload(workloadName, width, height);
+        if (!workload) {
+            std::cerr << "Unknown workload: " << workloadName << std::endl;
+            return 1;
+        }
+        workload->draw(recordingCanvas, 0);
+    }
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+    auto recorded = std::chrono::steady_clock::now();
+
+    TiledRasterRenderer renderer(info, tileOptions);
+    renderer.render(picture.get());
+    auto rendered = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double, std::milli> recordMs = recorded - start;
+    std::chrono::duration<double, std::milli> renderMs = rendered - recorded;
+    std::cout << "Skia CPU sample rendered successfully. (" << width << "x" << height
+              << ", " << renderer.tileCount() << " tiles, " << renderer.threadCount() << " threads, record "
+              << recordMs.count() << " ms, render " << renderMs.count() << " ms)" << std::endl;
+
+    // 인코딩은 백그라운드 스레드에서, PNG 는 row strip 단위로 병렬 압축
+    AsyncImageWriter writer(tileOptions.threads);
+    bool encoded = false;
+    writer.write(renderer.bitmap().pixmap(), outputPath, encodeOptions, [&encoded](bool ok) { encoded = ok; });
+    writer.flush();
+    std::chrono::duration<double, std::milli> encodeMs = std::chrono::steady_clock::now() - rendered;
+    if (!encoded) {
+        std::cerr << "Failed to encode " << outputPath << std::endl;
         return 1;
     }
+    std::cout << encodeFormatName(encodeOptions.format) << " saved successfully! (" << outputPath << ", "
+              << encodePresetName(encodeOptions.preset) << ", " << encodeMs.count() << " ms)" << std::endl;
 
     return 0;
-}
\ No newline at end of file
+}
@@ -1,6 +1,12 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <vector>
-#include <GL/gl.h>
+#include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
 // Skia includes
@@ -18,16 +24,35 @@
 #include "include/gpu/ganesh/gl/GrGLInterface.h"
 #include "include/gpu/ganesh/gl/GrGLBackendSurface.h"
 
+#include "aa_mode.h"
+#include "frame_capture.h"
+#include "frame_scheduler.h"
+#include "font_manager.h"
+#include "frame_stats.h"
+#include "gpu_memory.h"
+#include "gl_gpu_timer.h"
+#include "retained_scene.h"
+#include "scene_file.h"
+#include "shader_cache.h"
+#include "startup_trace.h"
 
-bool setupSkiaGL(int width, int height, sk_sp<GrDirectContext> &context, sk_sp<SkSurface> &surface) {
+
+bool setupSkiaGL(int width, int height, const AaOptions &aa, GrContextOptions options,
+                 sk_sp<GrDirectContext> &context, sk_sp<SkSurface> &surface) {
+    aa.apply(&options);
     sk_sp<const GrGLInterface> interface = GrGLMakeNativeInterface();
-    context = GrDirectContexts::MakeGL(interface);
+    context = GrDirectContexts::MakeGL(interface, options);
     if (!context) {
         std::cerr << "Failed to create Skia GrDirectContext for OpenGL!" << std::endl;
         return false;
     }
 
-    int sampleCnt = 0;
+    // 기본 framebuffer 의 실제 샘플 수 (GLFW_SAMPLES 요청이 거절될 수 있음). MSAA 면 swap 때 resolve 된다
+    GLint sampleCnt = 0;
+    glGetIntegerv(GL_SAMPLES, &sampleCnt);
+    if (aa.mode == AaMode::kMsaa && sampleCnt <= 1) {
+        std::cerr << "MSAA framebuffer unavailable, falling back to coverage AA" << std::endl;
+    }
     int stencilBits = 8;
     GrGLFramebufferInfo framebufferInfo;
     framebufferInfo.fFBOID = 0;
@@ -35,7 +60,7 @@ bool setupSkiaGL(int width, int height, sk_sp<GrDirectContext> &context, sk_sp<S
     GrBackendRenderTarget backendRT = GrBackendRenderTargets::MakeGL(
             width, height, sampleCnt, stencilBits, framebufferInfo);
 
-    SkSurfaceProps props(0, kUnknown_SkPixelGeometry);
+    SkSurfaceProps props(aa.surfaceFlags(), kUnknown_SkPixelGeometry);
     surface = SkSurfaces::WrapBackendRenderTarget(
         context.get(), backendRT, kBottomLeft_GrSurfaceOrigin, kRGBA_8888_SkColorType, nullptr, &props);
     if (!surface) {
@@ -45,10 +70,7 @@ bool setupSkiaGL(int width, int height, sk_sp<GrDirectContext> &context, sk_sp<S
     return true;
 }
 
-void drawFrame(SkCanvas* canvas) {
-    glClear(GL_COLOR_BUFFER_BIT);
-    canvas->clear(SK_ColorBLUE);
-
+static void drawTriangle(SkCanvas* canvas, int) {
     SkPaint paint;
     paint.setAntiAlias(true);
     paint.setStyle(SkPaint::kFill_Style);
@@ -63,37 +85,218 @@ void drawFrame(SkCanvas* canvas) {
     canvas->drawPath(triangle, paint);
 }
 
-int main() {
+// --scene 으로 연 파일 (없으면 코드로 그리는 삼각형)
+static SceneFile gSceneFile;
+
+void drawFrame(SkCanvas* canvas) {
+    // 변하지 않는 내용은 SkPicture 로 한 번만 기록해 두고 재생
+    static RetainedScene scene = [] {
+        RetainedScene s(SkRect::MakeEmpty());
+        if (gSceneFile.isOpen()) {
+            s.addStatic([](SkCanvas* c, int) { gSceneFile.draw(c); });
+        } else {
+            s.addStatic(drawTriangle);
+        }
+        return s;
+    }();
+    // cull rect 는 surface 와 scene 파일 크기를 모두 덮도록 (작으면 drawPicture 가 통째로 quick-reject 될 수 있음)
+    SkRect bounds = SkRect::Make(canvas->getBaseLayerSize());
+    if (gSceneFile.isOpen()) {
+        bounds.join(SkRect::MakeWH(gSceneFile.width(), gSceneFile.height()));
+    }
+    scene.setBounds(bounds);
+
+    glClear(GL_COLOR_BUFFER_BIT);
+    canvas->clear(SK_ColorBLUE);
+    scene.draw(canvas, 0);
+}
+
+// 같은 드라이버/GPU 에서만 program binary 를 재사용할 수 있으므로 GL 문자열로 캐시를 구분
+static std::string glShaderCacheIdentity() {
+    auto str = [](GLenum name) {
+        const GLubyte* value = glGetString(name);
+        return value ? std::string(reinterpret_cast<const char*>(value)) : std::string();
+    };
+    return "gl:" + str(GL_VENDOR) + ":" + str(GL_RENDERER) + ":" + str(GL_VERSION);
+}
+
+int main(int argc, char** argv) {
+    auto launchTime = std::chrono::steady_clock::now();
+    StartupTracer::instance().setOrigin(launchTime);
+    std::string statsCsvPath, statsJsonPath;
+    std::string shaderCacheDir = defaultShaderCacheDir();
+    bool warmUp = false;
+    CaptureOptions captureOptions;
+    GpuMemoryOptions gpuMemoryOptions;
+    AaOptions aaOptions;
+    SchedulerOptions schedulerOptions;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--stats-csv=", 12) == 0) {
+            statsCsvPath = argv[i] + 12;
+        } else if (strncmp(argv[i], "--stats-json=", 13) == 0) {
+            statsJsonPath = argv[i] + 13;
+        } else if (strncmp(argv[i], "--shader-cache=", 15) == 0) {
+            shaderCacheDir = argv[i] + 15;
+        } else if (strcmp(argv[i], "--no-shader-cache") == 0) {
+            shaderCacheDir.clear();
+        } else if (strcmp(argv[i], "--warmup") == 0) {
+            warmUp = true;
+        } else if (strncmp(argv[i], "--scene=", 8) == 0) {
+            StartupPhase phase("scene load");
+            if (!gSceneFile.open(argv[i] + 8)) {
+                return -1;
+            }
+        } else if (parseAaArg(argv[i], aaOptions)) {
+        } else if (strncmp(argv[i], "--aa=", 5) == 0) {
+            // 모르는 AA 모드 (parseAaArg 가 이유를 출력함)
+            return -1;
+        } else if (parseSchedulerArg(argv[i], schedulerOptions)) {
+        } else if (!parseGpuMemoryArg(argv[i], gpuMemoryOptions)) {
+            parseCaptureArg(argv[i], captureOptions);
+        }
+    }
+
+    // fontconfig 스캔은 창/GL 초기화와 독립적이므로 백그라운드에서
+    prewarmFontMgr();
+
+    int startupPhase = StartupTracer::instance().begin("glfw init + window");
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_SAMPLES, aaOptions.mode == AaMode::kMsaa ? aaOptions.samples : 0);
 
     int width = 800, height = 600;
     GLFWwindow* window = glfwCreateWindow(width, height, "Skia OpenGL Example", nullptr, nullptr);
+    StartupTracer::instance().end(startupPhase);
     if (!window) {
         std::cerr << "Failed to create GLFW window." << std::endl;
         glfwTerminate();
         return -1;
     }
     glfwMakeContextCurrent(window);
-    
+
+    // core profile 에서 query 함수 등을 쓰기 위해 GLEW 로드
+    startupPhase = StartupTracer::instance().begin("glew");
+    glewExperimental = GL_TRUE;
+    GLenum glewStatus = glewInit();
+    StartupTracer::instance().end(startupPhase);
+    if (glewStatus != GLEW_OK) {
+        std::cerr << "Failed to initialize GLEW." << std::endl;
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return -1;
+    }
+
+    // context 보다 먼저 만들고 나중에 파괴
+    std::unique_ptr<DiskShaderCache> shaderCache;
+    std::future<void> cachePreload;
+    GrContextOptions contextOptions;
+    if (!shaderCacheDir.empty()) {
+        shaderCache = std::make_unique<DiskShaderCache>(shaderCacheDir, glShaderCacheIdentity());
+        if (shaderCache->isValid()) {
+            // Skia GL context 생성과 병렬로 디스크에서 읽어 둠 (program 은 첫 draw 때 load 됨)
+            DiskShaderCache* cache = shaderCache.get();
+            cachePreload = std::async(std::launch::async, [cache] {
+                StartupPhase phase("shader cache preload");
+                cache->preload();
+            });
+            contextOptions.fPersistentCache = shaderCache.get();
+            contextOptions.fShaderCacheStrategy = GrContextOptions::ShaderCacheStrategy::kBackendBinary;
+        }
+    }
+
     sk_sp<GrDirectContext> context = nullptr;
     sk_sp<SkSurface> surface = nullptr;
-    if (!setupSkiaGL(width, height, context, surface)) {
+    startupPhase = StartupTracer::instance().begin("skia context");
+    bool contextReady = setupSkiaGL(width, height, aaOptions, contextOptions, context, surface);
+    StartupTracer::instance().end(startupPhase);
+    if (cachePreload.valid()) {
+        cachePreload.wait();
+    }
+    if (!contextReady) {
         std::cerr << "Setup failed!" << std::endl;
         glfwDestroyWindow(window);
         glfwTerminate();
         return -1;
     }
 
-    while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+    if (warmUp) {
+        StartupPhase phase("shader warm-up");
+        // 기본 framebuffer 와 같은 샘플 수 / DMSAA flag 로 그려야 frame 에서 쓰는 프로그램이 만들어진다
+        GLint sampleCnt = 0;
+        glGetIntegerv(GL_SAMPLES, &sampleCnt);
+        warmUpShaders(context.get(), kRGBA_8888_SkColorType, std::max(1, sampleCnt), &surface->props());
+    }
 
-        drawFrame(surface->getCanvas());
-        context->flushAndSubmit();
+    FrameStats stats;
+    stats.setStartTime(launchTime);
+    GlGpuTimer gpuTimer;
+    gpuTimer.init();
+    FrameCapture capture;
+    if (!capture.init(captureOptions)) {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return -1;
+    }
+
+    // 장면이 바뀌지 않으므로 첫 프레임과 창이 다시 그려져야 할 때(refresh)만 그리고 나머지는 이벤트 대기.
+    // --continuous 면 이전처럼 매 프레임 그림
+    FrameScheduler scheduler(schedulerOptions);
+    glfwSetWindowUserPointer(window, &scheduler);
+    glfwSetWindowRefreshCallback(window, [](GLFWwindow* w) {
+        static_cast<FrameScheduler*>(glfwGetWindowUserPointer(w))->invalidate();
+    });
+    GpuMemoryManager gpuMemory(context.get(), gpuMemoryOptions);
+    scheduler.setIdleCallback([&gpuMemory] { gpuMemory.onIdle(); });
 
-        glfwSwapBuffers(window);
+    int firstFramePhase = StartupTracer::instance().begin("first frame");
+    while (scheduler.waitForFrame(window)) {
+        // 이벤트를 기다린 시간은 프레임 간격에서 제외
+        if (scheduler.idledBeforeFrame()) {
+            stats.markIdle();
+        }
+        uint64_t frameNumber = stats.beginFrame();
+        gpuTimer.collect(stats);
+        {
+            ScopedStageTimer timer(stats, FrameStage::kRecord);
+            drawFrame(surface->getCanvas());
+        }
+        capture.request(surface.get(), frameNumber);
+        {
+            // Skia 는 flush 시점에 GL 명령을 발행하므로 GPU 시간도 이 구간만 측정
+            ScopedStageTimer timer(stats, FrameStage::kFlush);
+            gpuTimer.begin(frameNumber);
+            context->flushAndSubmit();
+            gpuTimer.end();
+        }
+        capture.poll(context.get());
+        {
+            ScopedStageTimer timer(stats, FrameStage::kPresent);
+            glfwSwapBuffers(window);
+        }
+        gpuMemory.endFrame();
+        stats.endFrame();
+        if (stats.frameCount() == 1) {
+            StartupTracer::instance().end(firstFramePhase);
+            StartupTracer::instance().print(std::cout);
+        }
+    }
+
+    capture.finish(context.get());
+    gpuTimer.drain(stats);
+    gpuTimer.destroy();
+    scheduler.printStats(std::cout);
+    stats.printSummary(std::cout);
+    if (shaderCache) {
+        shaderCache->printStats(std::cout);
+    }
+    gpuMemory.finish();
+    if (!statsCsvPath.empty() && !stats.writeCsv(statsCsvPath)) {
+        std::cerr << "Failed to write " << statsCsvPath << std::endl;
+    }
+    if (!statsJsonPath.empty() && !stats.writeJson(statsJsonPath)) {
+        std::cerr << "Failed to write " << statsJsonPath << std::endl;
     }
     
     surface.reset();
@@ -0,0 +1,71 @@
+#include "aa_mode.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "include/core/SkSurfaceProps.h"
+#include "include/gpu/ganesh/GrContextOptions.h"
+
+uint32_t AaOptions::surfaceFlags() const
+{
+    return mode == AaMode::kDynamicMsaa ? SkSurfaceProps::kDynamicMSAA_Flag : 0;
+}
+
+void AaOptions::apply(GrContextOptions *options) const
+{
+    if (internalSamples >= 0) {
+        options->fInternalMultisampleCount = internalSamples;
+    }
+}
+
+std::string AaOptions::name() const
+{
+    switch (mode) {
+    case AaMode::kCoverage:
+        return "coverage";
+    case AaMode::kMsaa:
+        return "msaa" + std::to_string(samples);
+    case AaMode::kDynamicMsaa:
+        return "dmsaa";
+    }
+    return "unknown";
+}
+
+bool parseAaMode(const std::string &name, AaOptions *options)
+{
+    if (name == "coverage") {
+        options->mode = AaMode::kCoverage;
+    } else if (name == "dmsaa") {
+        options->mode = AaMode::kDynamicMsaa;
+    } else if (name.compare(0, 4, "msaa") == 0) {
+        int samples = name.size() > 4 ? atoi(name.c_str() + 4) : 4;
+        // 샘플 수는 2 의 거듭제곱만
+        if (samples < 2 || samples > 16 || (samples & (samples - 1)) != 0) {
+            return false;
+        }
+        options->mode = AaMode::kMsaa;
+        options->samples = samples;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseAaArg(const char *arg, AaOptions &options)
+{
+    if (strncmp(arg, "--aa=", 5) == 0) {
+        // 모르는 모드면 처리하지 않은 인자로 돌려 호출자가 usage 를 출력하고 끝내게 한다
+        if (!parseAaMode(arg + 5, &options)) {
+            std::cerr << "Unknown AA mode: " << arg + 5 << " (coverage|msaa[N]|dmsaa)" << std::endl;
+            return false;
+        }
+        return true;
+    }
+    if (strncmp(arg, "--internal-msaa=", 16) == 0) {
+        options.internalSamples = std::max(0, atoi(arg + 16));
+        return true;
+    }
+    return false;
+}
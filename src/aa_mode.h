@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+struct GrContextOptions;
+
+// 안티에일리어싱 전략
+//  kCoverage   : 단일 샘플 render target, path 는 Skia 의 analytic / coverage mask (atlas) 경로
+//  kMsaa       : N 샘플 MSAA render target 에 그리고 매 flush 에 resolve
+//  kDynamicMsaa: 단일 샘플 target 이지만 복잡한 path 가 있는 render pass 만 Skia 가 MSAA 로 전환 (DMSAA)
+enum class AaMode
+{
+    kCoverage,
+    kMsaa,
+    kDynamicMsaa,
+};
+
+struct AaOptions
+{
+    AaMode mode = AaMode::kCoverage;
+    int samples = 4;            // kMsaa 샘플 수 (디바이스 최대치로 제한됨)
+    int internalSamples = -1;   // GrContextOptions::fInternalMultisampleCount (Skia 내부 offscreen), -1 이면 기본값
+
+    // render target 샘플 수 (MSAA 가 아니면 1)
+    int sampleCount() const { return mode == AaMode::kMsaa ? samples : 1; }
+    // SkSurfaceProps flags (DMSAA 면 kDynamicMSAA_Flag)
+    uint32_t surfaceFlags() const;
+    // context 생성 전에 호출
+    void apply(GrContextOptions *options) const;
+    // "coverage", "msaa4", "dmsaa" 등
+    std::string name() const;
+};
+
+// coverage | msaa | msaaN | dmsaa 를 파싱. 모르는 이름이면 false
+bool parseAaMode(const std::string &name, AaOptions *options);
+// --aa=MODE, --internal-msaa=N 을 처리하면 true. --aa= 의 모드를 모르면 에러를 출력하고 false
+bool parseAaArg(const char *arg, AaOptions &options);
@@ -0,0 +1,99 @@
+#include "async_image_writer.h"
+
+#include <iostream>
+
+#include "include/core/SkStream.h"
+
+AsyncImageWriter::AsyncImageWriter(int encodeThreads, size_t queueDepth)
+    : fPool(encodeThreads), fQueue(queueDepth)
+{
+    fThread = std::thread([this] { writerLoop(); });
+}
+
+AsyncImageWriter::~AsyncImageWriter()
+{
+    fQueue.close();
+    fThread.join();
+}
+
+bool AsyncImageWriter::write(const SkPixmap &pixmap, const std::string &path, const EncodeOptions &options,
+                             DoneFn done)
+{
+    Job job;
+    job.pixmap = pixmap;
+    job.path = path;
+    job.options = options;
+    job.done = std::move(done);
+    return enqueue(std::move(job));
+}
+
+bool AsyncImageWriter::writeCopy(const SkPixmap &pixmap, const std::string &path, const EncodeOptions &options)
+{
+    Job job;
+    if (!job.copy.tryAllocPixels(pixmap.info()) || !pixmap.readPixels(job.copy.pixmap())) {
+        std::cerr << "Failed to copy pixels for " << path << std::endl;
+        return false;
+    }
+    job.pixmap = job.copy.pixmap();
+    job.path = path;
+    job.options = options;
+    return enqueue(std::move(job));
+}
+
+bool AsyncImageWriter::enqueue(Job job)
+{
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        ++fPending;
+    }
+    if (!fQueue.push(std::move(job))) {
+        std::lock_guard<std::mutex> lock(fMutex);
+        --fPending;
+        fIdle.notify_all();
+        return false;
+    }
+    return true;
+}
+
+void AsyncImageWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(fMutex);
+    fIdle.wait(lock, [this] { return fPending == 0; });
+}
+
+int AsyncImageWriter::failedCount() const
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    return fFailed;
+}
+
+void AsyncImageWriter::writerLoop()
+{
+    Job job;
+    while (fQueue.pop(job)) {
+        bool ok = false;
+        {
+            SkFILEWStream file(job.path.c_str());
+            if (!file.isValid()) {
+                std::cerr << "Failed to open output file: " << job.path << std::endl;
+            } else {
+                ok = fEncoder.encode(job.pixmap, job.options, &fPool, &file);
+                file.flush();
+                if (!ok) {
+                    std::cerr << "Failed to encode " << job.path << std::endl;
+                }
+            }
+        }
+        if (job.done) {
+            job.done(ok);
+        }
+        job = Job();
+
+        std::lock_guard<std::mutex> lock(fMutex);
+        if (!ok) {
+            ++fFailed;
+        }
+        --fPending;
+        fIdle.notify_all();
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkPixmap.h"
+
+#include "bounded_queue.h"
+#include "image_encoder.h"
+#include "thread_pool.h"
+
+// 인코딩과 파일 쓰기를 백그라운드 스레드에서 처리한다. 렌더 루프는 큐에 넣고 바로 다음 프레임으로 간다.
+// 큐가 가득 차면 write() 가 블록되어 인코딩이 렌더링을 못 따라갈 때 메모리가 무한히 늘지 않는다.
+class AsyncImageWriter
+{
+public:
+    using DoneFn = std::function<void(bool ok)>;
+
+    // encodeThreads <= 0 이면 hardware_concurrency
+    explicit AsyncImageWriter(int encodeThreads = 0, size_t queueDepth = 4);
+    ~AsyncImageWriter();
+
+    AsyncImageWriter(const AsyncImageWriter &) = delete;
+    AsyncImageWriter &operator=(const AsyncImageWriter &) = delete;
+
+    // pixmap 의 픽셀은 done 이 호출될 때까지 유효해야 한다 (done 은 writer 스레드에서 호출)
+    bool write(const SkPixmap &pixmap, const std::string &path, const EncodeOptions &options, DoneFn done = nullptr);
+    // 픽셀을 복사해 두고 반환하므로 호출자는 버퍼를 바로 재사용할 수 있다
+    bool writeCopy(const SkPixmap &pixmap, const std::string &path, const EncodeOptions &options);
+
+    // 지금까지 넣은 작업이 모두 끝날 때까지 대기
+    void flush();
+
+    int failedCount() const;
+    int encodeThreadCount() const { return fPool.threadCount(); }
+
+private:
+    struct Job
+    {
+        SkPixmap pixmap;
+        SkBitmap copy;  // writeCopy 일 때 픽셀 소유
+        std::string path;
+        EncodeOptions options;
+        DoneFn done;
+    };
+
+    bool enqueue(Job job);
+    void writerLoop();
+
+    ThreadPool fPool;
+    ImageEncoder fEncoder;      // writer 스레드 전용, strip 버퍼를 작업 사이에 재사용
+    BoundedQueue<Job> fQueue;
+    std::thread fThread;
+
+    mutable std::mutex fMutex;
+    std::condition_variable fIdle;
+    int fPending = 0;
+    int fFailed = 0;
+};
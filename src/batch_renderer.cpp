@@ -0,0 +1,185 @@
+#include "batch_renderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkStream.h"
+
+#include "bounded_queue.h"
+#include "frame_path.h"
+#include "thread_pool.h"
+#include "workloads.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct EncodeItem
+{
+    int slot = -1;
+    int frame = 0;
+};
+
+struct WriteItem
+{
+    int frame = 0;
+    int output = -1;    // 인코딩 결과가 담긴 output 버퍼 (실패하면 -1)
+};
+
+// 재사용하는 std::vector 에 이어 쓰는 stream. 생성 시 비우지만 capacity 는 그대로라 프레임마다 할당하지 않는다
+class VectorWStream : public SkWStream
+{
+public:
+    explicit VectorWStream(std::vector<uint8_t> &buffer) : fBuffer(buffer) { fBuffer.clear(); }
+
+    bool write(const void *data, size_t size) override
+    {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        fBuffer.insert(fBuffer.end(), bytes, bytes + size);
+        return true;
+    }
+    size_t bytesWritten() const override { return fBuffer.size(); }
+
+private:
+    std::vector<uint8_t> &fBuffer;
+};
+
+} // namespace
+
+void BatchStats::print(std::ostream &os) const
+{
+    auto util = [this](double busy) { return wallMs > 0 ? busy * 100.0 / wallMs : 0.0; };
+    os << std::fixed << std::setprecision(1);
+    os << "Batch: " << frames << " frames in " << wallMs << " ms (" << (wallMs > 0 ? frames * 1000.0 / wallMs : 0.0)
+       << " fps), " << bytesWritten << " bytes, " << failed << " failed" << std::endl;
+    os << "  render " << std::setw(5) << util(renderBusyMs) << "%  (stalled " << renderStallMs << " ms)" << std::endl;
+    os << "  encode " << std::setw(5) << util(encodeBusyMs) << "%" << std::endl;
+    os << "  write  " << std::setw(5) << util(writeBusyMs) << "%" << std::endl;
+    os << std::defaultfloat;
+}
+
+bool runBatch(const SkImageInfo &info, Workload &workload, const BatchOptions &options, BatchStats *stats)
+{
+    std::string patternError;
+    if (!isValidFramePattern(options.outputPattern, &patternError)) {
+        std::cerr << "Invalid output pattern " << options.outputPattern << ": " << patternError << std::endl;
+        return false;
+    }
+
+    const int ringSize = std::max(1, options.ringSize);
+    std::vector<SkBitmap> ring(ringSize);
+    for (SkBitmap &bitmap : ring) {
+        if (!bitmap.tryAllocPixels(info)) {
+            std::cerr << "Failed to allocate frame buffer" << std::endl;
+            return false;
+        }
+    }
+
+    TiledRasterRenderer renderer(info, options.tiles);
+    ThreadPool encodePool(options.encodeThreads);
+    // encoder 의 strip 버퍼와 인코딩 결과 버퍼는 batch 동안 재사용 (write 가 끝난 output 만 encode 에 반환)
+    ImageEncoder encoder;
+    std::vector<std::vector<uint8_t>> outputs(ringSize);
+
+    BoundedQueue<int> freeSlots(ringSize);
+    BoundedQueue<int> freeOutputs(ringSize);
+    BoundedQueue<EncodeItem> encodeQueue(ringSize);
+    BoundedQueue<WriteItem> writeQueue(ringSize);
+    for (int i = 0; i < ringSize; ++i) {
+        freeSlots.push(i);
+        freeOutputs.push(i);
+    }
+
+    BatchStats result;
+    const Clock::time_point start = Clock::now();
+
+    // --- encode 단계: 버퍼를 output 버퍼로 인코딩하고 바로 ring 에 반환 ---
+    std::thread encodeThread([&] {
+        EncodeItem item;
+        int output = -1;
+        while (encodeQueue.pop(item) && freeOutputs.pop(output)) {
+            Clock::time_point t = Clock::now();
+            VectorWStream stream(outputs[output]);
+            bool ok = encoder.encode(ring[item.slot].pixmap(), options.encode, &encodePool, &stream);
+            freeSlots.push(item.slot);
+            result.encodeBusyMs += elapsedMs(t);
+            if (!ok) {
+                std::cerr << "Failed to encode frame " << item.frame << std::endl;
+                freeOutputs.push(output);
+                output = -1;
+            }
+            writeQueue.push({item.frame, output});
+        }
+        writeQueue.close();
+    });
+
+    // --- write 단계 ---
+    std::thread writeThread([&] {
+        WriteItem item;
+        while (writeQueue.pop(item)) {
+            Clock::time_point t = Clock::now();
+            bool ok = false;
+            if (item.output >= 0) {
+                const std::vector<uint8_t> &data = outputs[item.output];
+                std::string path = formatFramePath(options.outputPattern, item.frame);
+                SkFILEWStream file(path.c_str());
+                ok = file.isValid() && file.write(data.data(), data.size());
+                if (ok) {
+                    result.bytesWritten += data.size();
+                } else {
+                    std::cerr << "Failed to write " << path << std::endl;
+                }
+                freeOutputs.push(item.output);
+            }
+            if (!ok) {
+                ++result.failed;
+            }
+            result.writeBusyMs += elapsedMs(t);
+        }
+    });
+
+    // --- render 단계 (호출 스레드) ---
+    const SkRect bounds = SkRect::MakeWH(info.width(), info.height());
+    SkPictureRecorder recorder;
+    for (int i = 0; i < options.frameCount; ++i) {
+        const int frame = options.firstFrame + i;
+        Clock::time_point waitStart = Clock::now();
+        int slot = -1;
+        if (!freeSlots.pop(slot)) {
+            break;
+        }
+        result.renderStallMs += elapsedMs(waitStart);
+
+        Clock::time_point t = Clock::now();
+        workload.draw(recorder.beginRecording(bounds), frame);
+        sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+        renderer.renderInto(picture.get(), ring[slot].pixmap());
+        result.renderBusyMs += elapsedMs(t);
+
+        encodeQueue.push({slot, frame});
+        ++result.frames;
+    }
+    encodeQueue.close();
+    encodeThread.join();
+    writeThread.join();
+
+    result.wallMs = elapsedMs(start);
+    if (stats) {
+        *stats = result;
+    }
+    return result.failed == 0;
+}
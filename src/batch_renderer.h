@@ -0,0 +1,43 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+#include "include/core/SkImageInfo.h"
+
+#include "image_encoder.h"
+#include "tiled_raster.h"
+
+class Workload;
+
+struct BatchOptions
+{
+    int firstFrame = 0;
+    int frameCount = 1;
+    int ringSize = 3;                   // 미리 할당해 돌려 쓰는 raster 버퍼 수
+    std::string outputPattern;          // frame 번호 자리 하나 (frame_path.h), 예: frames/frame_%05d.png
+    EncodeOptions encode;
+    TiledRasterOptions tiles;
+    int encodeThreads = 0;              // 0 이면 hardware_concurrency
+};
+
+// 단계별 busy 시간. utilization = busyMs / wallMs
+struct BatchStats
+{
+    int frames = 0;
+    int failed = 0;
+    double wallMs = 0;
+    double renderBusyMs = 0;
+    double renderStallMs = 0;           // 빈 버퍼를 기다린 시간 (encode 가 병목일 때 증가)
+    double encodeBusyMs = 0;
+    double writeBusyMs = 0;
+    size_t bytesWritten = 0;
+
+    void print(std::ostream &os) const;
+};
+
+// render -> encode -> write 세 단계를 bounded queue 로 연결해 frame 범위를 렌더링한다.
+// render 는 호출 스레드에서 workload 를 SkPicture 로 기록한 뒤 타일 병렬 재생하고,
+// encode/write 는 각자 스레드에서 돈다. 픽셀 버퍼는 ringSize 개만 처음에 할당하며
+// encode 가 끝난 버퍼만 다시 render 에 돌려준다.
+bool runBatch(const SkImageInfo &info, Workload &workload, const BatchOptions &options, BatchStats *stats);
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// 생산자/소비자 단계 사이의 고정 크기 큐. 가득 차면 push 가, 비어 있으면 pop 이 블록된다 (tryPop 은 블록하지 않음).
+// close() 이후 push 는 실패하고, pop 은 남은 항목을 모두 꺼낸 뒤 false 를 반환한다.
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity) : fCapacity(capacity ? capacity : 1) {}
+
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock(fMutex);
+        fNotFull.wait(lock, [this] { return fClosed || fItems.size() < fCapacity; });
+        if (fClosed) {
+            return false;
+        }
+        fItems.push_back(std::move(item));
+        fNotEmpty.notify_one();
+        return true;
+    }
+
+    bool pop(T &item)
+    {
+        std::unique_lock<std::mutex> lock(fMutex);
+        fNotEmpty.wait(lock, [this] { return fClosed || !fItems.empty(); });
+        if (fItems.empty()) {
+            return false;
+        }
+        item = std::move(fItems.front());
+        fItems.pop_front();
+        fNotFull.notify_one();
+        return true;
+    }
+
+    // 비어 있으면 기다리지 않고 false
+    bool tryPop(T &item)
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        if (fItems.empty()) {
+            return false;
+        }
+        item = std::move(fItems.front());
+        fItems.pop_front();
+        fNotFull.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fClosed = true;
+        fNotFull.notify_all();
+        fNotEmpty.notify_all();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        return fItems.size();
+    }
+
+    size_t capacity() const { return fCapacity; }
+
+private:
+    const size_t fCapacity;
+    mutable std::mutex fMutex;
+    std::condition_variable fNotFull;
+    std::condition_variable fNotEmpty;
+    std::deque<T> fItems;
+    bool fClosed = false;
+};
@@ -0,0 +1,65 @@
+#include "damage_tracker.h"
+
+static void simplify(SkRegion &region, int maxRects)
+{
+    int count = 0;
+    for (SkRegion::Iterator it(region); !it.done(); it.next()) {
+        if (++count > maxRects) {
+            region.setRect(region.getBounds());
+            return;
+        }
+    }
+}
+
+void DamageTracker::reset(const SkIRect &bounds, int imageCount)
+{
+    fBounds = bounds;
+    fHistory.clear();
+    fImageFrame.assign(imageCount, -1);
+    fPending.setRect(fBounds);
+}
+
+void DamageTracker::add(const SkIRect &rect)
+{
+    SkIRect clipped = rect;
+    if (clipped.intersect(fBounds)) {
+        fPending.op(clipped, SkRegion::kUnion_Op);
+    }
+}
+
+void DamageTracker::addFull()
+{
+    fPending.setRect(fBounds);
+}
+
+SkRegion DamageTracker::beginFrame(int imageIndex)
+{
+    simplify(fPending, kMaxRects);
+    fFrameDamage = fPending;
+    fPending.setEmpty();
+
+    fHistory.push_front(fFrameDamage);
+    if (fHistory.size() > kMaxHistory) {
+        fHistory.pop_back();
+    }
+
+    if (imageIndex >= static_cast<int>(fImageFrame.size())) {
+        fImageFrame.resize(imageIndex + 1, -1);
+    }
+
+    SkRegion redraw;
+    int64_t last = fImageFrame[imageIndex];
+    int64_t age = fFrame - last;
+    if (last < 0 || age > static_cast<int64_t>(fHistory.size())) {
+        redraw.setRect(fBounds);
+    } else {
+        for (int64_t k = 0; k < age; ++k) {
+            redraw.op(fHistory[k], SkRegion::kUnion_Op);
+        }
+        simplify(redraw, kMaxRects);
+    }
+
+    fImageFrame[imageIndex] = fFrame;
+    ++fFrame;
+    return redraw;
+}
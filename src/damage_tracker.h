@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "include/core/SkRect.h"
+#include "include/core/SkRegion.h"
+
+// scene 변경 영역을 모아 프레임마다 다시 그릴 영역을 계산한다.
+// swapchain 이미지는 마지막으로 그려진 이후의 내용을 유지하므로 (buffer age),
+// 이미지별로 그 사이 누적된 damage 만 다시 그리면 된다.
+class DamageTracker
+{
+public:
+    // resize / swapchain 재생성 시: 모든 이미지를 전체 다시 그리도록 초기화
+    void reset(const SkIRect &bounds, int imageCount);
+
+    void add(const SkIRect &rect);
+    void addFull();
+
+    // 아직 어느 프레임에도 반영되지 않은 변경이 있는지
+    bool hasDamage() const { return !fPending.isEmpty(); }
+
+    // 새 프레임 시작: imageIndex 이미지에서 다시 그려야 할 영역 반환
+    SkRegion beginFrame(int imageIndex);
+
+    // 이번 프레임에서 새로 바뀐 영역 (VK_KHR_incremental_present 로 전달)
+    const SkRegion &frameDamage() const { return fFrameDamage; }
+
+private:
+    static constexpr size_t kMaxHistory = 8;
+    static constexpr int kMaxRects = 16;   // 넘으면 bounding box 로 단순화 (clip 비용)
+
+    SkIRect fBounds = SkIRect::MakeEmpty();
+    int64_t fFrame = 0;
+    SkRegion fPending;
+    SkRegion fFrameDamage;
+    std::deque<SkRegion> fHistory;    // fHistory[k]: (fFrame - 1 - k) 프레임의 damage
+    std::vector<int64_t> fImageFrame; // 이미지별 마지막으로 그린 프레임, -1 이면 내용 없음
+};
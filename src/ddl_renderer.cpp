@@ -0,0 +1,54 @@
+#include "ddl_renderer.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkSurface.h"
+#include "include/private/chromium/GrDeferredDisplayListRecorder.h"
+#include "include/private/chromium/GrSurfaceCharacterization.h"
+
+DdlRenderer::DdlRenderer(int chunks, int threads)
+    : fPool(std::make_unique<ThreadPool>(threads))
+{
+    fChunks = chunks > 0 ? chunks : fPool->threadCount();
+    fDisplayLists.resize(fChunks);
+}
+
+bool DdlRenderer::render(SkSurface *surface, const SkPicture *picture)
+{
+    GrSurfaceCharacterization characterization;
+    if (!surface->characterize(&characterization)) {
+        std::cerr << "Failed to characterize surface for DDL recording" << std::endl;
+        return false;
+    }
+
+    const int width = surface->width();
+    const int height = surface->height();
+    const int bandHeight = (height + fChunks - 1) / fChunks;
+    fPool->parallelFor(fChunks, [&](int index) {
+        int top = index * bandHeight;
+        int bottom = std::min(height, top + bandHeight);
+        if (top >= bottom) {
+            fDisplayLists[index].reset();
+            return;
+        }
+        GrDeferredDisplayListRecorder recorder(characterization);
+        SkCanvas *canvas = recorder.getCanvas();
+        canvas->clipRect(SkRect::MakeLTRB(0, top, width, bottom));
+        canvas->drawPicture(picture);
+        fDisplayLists[index] = recorder.detach();
+    });
+
+    bool ok = true;
+    for (sk_sp<GrDeferredDisplayList> &displayList : fDisplayLists) {
+        if (displayList) {
+            ok &= skgpu::ganesh::DrawDDL(surface, std::move(displayList));
+        }
+    }
+    if (!ok) {
+        std::cerr << "Failed to replay deferred display list" << std::endl;
+    }
+    return ok;
+}
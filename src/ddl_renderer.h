@@ -0,0 +1,35 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "include/core/SkRefCnt.h"
+#include "include/private/chromium/GrDeferredDisplayList.h"
+
+#include "thread_pool.h"
+
+class SkPicture;
+class SkSurface;
+
+// GPU surface 용 멀티스레드 기록.
+// main 스레드는 frame 을 SkPicture 로 기록(op 직렬화만 하므로 가볍다)하고, worker 들이 가로 band 별로
+// picture 를 GrDeferredDisplayListRecorder 에 재생해 Ganesh op 생성(path 삼각분할 등 CPU 비용)을 나눠 맡는다.
+// 완성된 DDL 은 main 스레드에서 순서대로 DrawDDL 로 replay 한 뒤 평소처럼 flush/submit 한다.
+// band 는 서로 겹치지 않으므로 replay 순서와 무관하게 결과가 같다.
+class DdlRenderer
+{
+public:
+    // chunks <= 0 이면 스레드 수만큼, threads <= 0 이면 hardware_concurrency
+    DdlRenderer(int chunks, int threads);
+
+    // surface 의 characterization (크기/format/sample 수) 로 기록하므로 resize 후에도 그대로 호출하면 된다
+    bool render(SkSurface *surface, const SkPicture *picture);
+
+    int chunkCount() const { return fChunks; }
+    int threadCount() const { return fPool->threadCount(); }
+
+private:
+    int fChunks;
+    std::unique_ptr<ThreadPool> fPool;
+    std::vector<sk_sp<GrDeferredDisplayList>> fDisplayLists;
+};
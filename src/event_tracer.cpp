@@ -0,0 +1,358 @@
+#include "event_tracer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// src/core/SkTraceEventCommon.h 의 TRACE_VALUE_TYPE_* (공개 헤더에 없음)
+enum TraceValueType : uint8_t
+{
+    kBoolValue = 1,
+    kUintValue = 2,
+    kIntValue = 3,
+    kDoubleValue = 4,
+    kPointerValue = 5,
+    kStringValue = 6,
+    kCopyStringValue = 7,
+};
+
+static constexpr uint8_t kRecording = SkEventTracer::kEnabledForRecording_CategoryGroupEnabledFlags;
+static constexpr uint8_t kCopyNameFlag = 1 << 0;   // TRACE_EVENT_FLAG_COPY
+
+std::atomic<EventTracer *> EventTracer::gInstance{nullptr};
+
+// 스레드당 하나. tracer 는 프로세스에 하나뿐이므로 포인터만 둔다 (buffer 는 tracer 가 소유)
+static thread_local void *tThreadBuffer = nullptr;
+
+bool parseTraceArg(const char *arg, TraceOptions &options)
+{
+    if (strncmp(arg, "--trace=", 8) == 0) {
+        options.path = arg + 8;
+    } else if (strncmp(arg, "--trace-categories=", 19) == 0) {
+        options.categories = arg + 19;
+    } else if (strncmp(arg, "--trace-buffer=", 15) == 0) {
+        options.eventsPerThread = static_cast<uint32_t>(std::max(1024, atoi(arg + 15)));
+    } else if (strcmp(arg, "--trace-paused") == 0) {
+        options.startEnabled = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+EventTracer *EventTracer::Install(const TraceOptions &options)
+{
+    if (options.path.empty() || Get()) {
+        return Get();
+    }
+    EventTracer *tracer = new EventTracer(options);
+    if (!SkEventTracer::SetInstance(tracer)) {
+        std::cerr << "Another SkEventTracer is already installed, tracing disabled" << std::endl;
+        delete tracer;
+        return nullptr;
+    }
+    gInstance.store(tracer, std::memory_order_release);
+    tracer->setThreadName("main");
+    std::cout << "Tracing to " << options.path << " (categories " << options.categories
+              << (options.startEnabled ? "" : ", paused") << ")" << std::endl;
+    return tracer;
+}
+
+EventTracer::EventTracer(const TraceOptions &options)
+    : fOptions(options), fOrigin(std::chrono::steady_clock::now()), fEnabled(options.startEnabled)
+{
+    fAppCategory = getCategoryGroupEnabled("app");
+}
+
+uint64_t EventTracer::nowNs() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - fOrigin).count();
+}
+
+bool EventTracer::categoryEnabled(const std::string &group) const
+{
+    // group 은 "skia,skia.gpu" 처럼 쉼표로 묶일 수 있고, 그중 하나라도 켜져 있으면 기록
+    auto matches = [](const std::string &pattern, const std::string &category) {
+        if (pattern == "*") {
+            return category.compare(0, 19, "disabled-by-default") != 0;
+        }
+        if (!pattern.empty() && pattern.back() == '*') {
+            return category.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0;
+        }
+        return pattern == category;
+    };
+    std::vector<std::string> includes, excludes;
+    size_t start = 0;
+    while (start <= fOptions.categories.size()) {
+        size_t end = fOptions.categories.find(',', start);
+        std::string token = fOptions.categories.substr(start, end == std::string::npos ? end : end - start);
+        if (!token.empty() && token[0] == '-') {
+            excludes.push_back(token.substr(1));
+        } else if (!token.empty()) {
+            includes.push_back(token);
+        }
+        if (end == std::string::npos) {
+            break;
+        }
+        start = end + 1;
+    }
+    if (includes.empty()) {
+        includes.push_back("*");
+    }
+
+    start = 0;
+    while (start <= group.size()) {
+        size_t end = group.find(',', start);
+        std::string category = group.substr(start, end == std::string::npos ? end : end - start);
+        bool included = std::any_of(includes.begin(), includes.end(),
+                                    [&](const std::string &p) { return matches(p, category); });
+        bool excluded = std::any_of(excludes.begin(), excludes.end(),
+                                    [&](const std::string &p) { return matches(p, category); });
+        if (included && !excluded) {
+            return true;
+        }
+        if (end == std::string::npos) {
+            break;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+void EventTracer::updateFlags()
+{
+    // Skia 는 매크로 호출 지점마다 flag 포인터를 캐시하고 값만 읽으므로 값을 바꾸면 즉시 반영된다
+    bool enabled = isEnabled();
+    for (size_t i = 0; i < fCategoryMatches.size(); ++i) {
+        fCategoryFlags[i] = enabled && fCategoryMatches[i] ? kRecording : 0;
+    }
+}
+
+void EventTracer::setEnabled(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    fEnabled.store(enabled, std::memory_order_relaxed);
+    updateFlags();
+}
+
+const uint8_t *EventTracer::getCategoryGroupEnabled(const char *name)
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    for (size_t i = 0; i < fCategoryNames.size(); ++i) {
+        if (fCategoryNames[i] == name) {
+            return &fCategoryFlags[i];
+        }
+    }
+    if (fCategoryNames.size() >= kMaxCategories - 1) {
+        return &fCategoryFlags[kMaxCategories - 1];
+    }
+    fCategoryNames.push_back(name);
+    fCategoryMatches.push_back(categoryEnabled(name));
+    updateFlags();
+    return &fCategoryFlags[fCategoryNames.size() - 1];
+}
+
+const char *EventTracer::getCategoryGroupName(const uint8_t *categoryEnabledFlag)
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    size_t index = categoryEnabledFlag - fCategoryFlags;
+    return index < fCategoryNames.size() ? fCategoryNames[index].c_str() : "overflow";
+}
+
+EventTracer::ThreadBuffer &EventTracer::threadBuffer()
+{
+    if (tThreadBuffer) {
+        return *static_cast<ThreadBuffer *>(tThreadBuffer);
+    }
+    uint64_t capacity = 1;
+    while (capacity < fOptions.eventsPerThread) {
+        capacity <<= 1;
+    }
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->events.resize(capacity);
+    buffer->mask = capacity - 1;
+
+    std::lock_guard<std::mutex> lock(fMutex);
+    buffer->tid = static_cast<int>(fThreads.size()) + 1;
+    buffer->name = "thread " + std::to_string(buffer->tid);
+    tThreadBuffer = buffer.get();
+    fThreads.push_back(std::move(buffer));
+    return *fThreads.back();
+}
+
+void EventTracer::setThreadName(const char *name)
+{
+    ThreadBuffer &buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(fMutex);
+    buffer.name = name;
+}
+
+SkEventTracer::Handle EventTracer::addTraceEvent(char phase, const uint8_t *categoryEnabledFlag, const char *name,
+                                                 uint64_t id, int32_t numArgs, const char **argNames,
+                                                 const uint8_t *argTypes, const uint64_t *argValues, uint8_t flags)
+{
+    if (!(*categoryEnabledFlag & kRecording)) {
+        return 0;
+    }
+    ThreadBuffer &buffer = threadBuffer();
+    uint64_t seq = buffer.head.load(std::memory_order_relaxed);
+    Event &event = buffer.events[seq & buffer.mask];
+    event.name = name;
+    event.startNs = nowNs();
+    event.durationNs = 0;
+    event.id = id;
+    event.category = static_cast<uint16_t>(categoryEnabledFlag - fCategoryFlags);
+    event.phase = phase;
+    event.numArgs = static_cast<uint8_t>(std::min<int32_t>(numArgs, kMaxArgs));
+    // 호출이 끝나면 사라지는 문자열은 event 안에 잘라서 복사 (이름 또는 첫 번째 copy 인자 하나만)
+    bool copyUsed = false;
+    if (flags & kCopyNameFlag) {
+        snprintf(event.copiedString, kCopiedStringSize, "%s", name);
+        event.name = event.copiedString;
+        copyUsed = true;
+    }
+    for (int i = 0; i < event.numArgs; ++i) {
+        event.argNames[i] = argNames[i];
+        event.argTypes[i] = argTypes[i];
+        event.argValues[i] = argValues[i];
+        if (argTypes[i] == kCopyStringValue) {
+            const char *copied = "";
+            if (!copyUsed) {
+                snprintf(event.copiedString, kCopiedStringSize, "%s", reinterpret_cast<const char *>(argValues[i]));
+                copied = event.copiedString;
+                copyUsed = true;
+            }
+            event.argValues[i] = reinterpret_cast<uint64_t>(copied);
+        }
+    }
+    buffer.head.store(seq + 1, std::memory_order_release);
+    return phase == 'X' ? seq + 1 : 0;
+}
+
+SkEventTracer::Handle EventTracer::beginSpan(const char *name)
+{
+    return addTraceEvent('X', fAppCategory, name, 0, 0, nullptr, nullptr, nullptr, 0);
+}
+
+void EventTracer::updateTraceEventDuration(const uint8_t *, const char *, Handle handle)
+{
+    if (handle == 0) {
+        return;
+    }
+    // 범위는 시작한 스레드에서 끝나므로 같은 buffer. 그사이 ring 이 한 바퀴 돌았으면 이미 덮어쓰인 것
+    ThreadBuffer &buffer = threadBuffer();
+    uint64_t seq = handle - 1;
+    if (buffer.head.load(std::memory_order_relaxed) - seq > buffer.events.size()) {
+        return;
+    }
+    Event &event = buffer.events[seq & buffer.mask];
+    event.durationNs = nowNs() - event.startNs;
+}
+
+static void writeJsonString(std::ostream &out, const char *s)
+{
+    out << '"';
+    for (; *s; ++s) {
+        unsigned char c = static_cast<unsigned char>(*s);
+        if (c == '"' || c == '\\') {
+            out << '\\' << *s;
+        } else if (c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        } else {
+            out << *s;
+        }
+    }
+    out << '"';
+}
+
+bool EventTracer::writeJson(const std::string &path) const
+{
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(fMutex);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    size_t eventCount = 0, dropped = 0;
+    for (const auto &buffer : fThreads) {
+        out << (first ? "\n" : ",\n") << "  {\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": "
+            << buffer->tid << ", \"args\": {\"name\": ";
+        writeJsonString(out, buffer->name.c_str());
+        out << "}}";
+        first = false;
+
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t begin = head > buffer->events.size() ? head - buffer->events.size() : 0;
+        dropped += begin;
+        for (uint64_t seq = begin; seq < head; ++seq) {
+            const Event &event = buffer->events[seq & buffer->mask];
+            // 끝나지 않은 범위 (종료 직전 실행 중이던 것) 는 길이 0 으로 남긴다
+            out << ",\n  {\"ph\": \"" << event.phase << "\", \"name\": ";
+            writeJsonString(out, event.name ? event.name : "");
+            out << ", \"cat\": ";
+            writeJsonString(out, event.category < fCategoryNames.size() ? fCategoryNames[event.category].c_str()
+                                                                         : "overflow");
+            out << ", \"pid\": 1, \"tid\": " << buffer->tid << ", \"ts\": " << event.startNs / 1000.0;
+            if (event.phase == 'X') {
+                out << ", \"dur\": " << event.durationNs / 1000.0;
+            } else if (event.phase == 'I' || event.phase == 'i') {
+                out << ", \"s\": \"t\"";
+            }
+            if (event.id) {
+                out << ", \"id\": " << event.id;
+            }
+            if (event.numArgs > 0) {
+                out << ", \"args\": {";
+                for (int i = 0; i < event.numArgs; ++i) {
+                    out << (i ? ", " : "");
+                    writeJsonString(out, event.argNames[i]);
+                    out << ": ";
+                    uint64_t value = event.argValues[i];
+                    switch (event.argTypes[i]) {
+                    case kBoolValue:
+                        out << (value ? "true" : "false");
+                        break;
+                    case kUintValue:
+                        out << value;
+                        break;
+                    case kIntValue:
+                        out << static_cast<int64_t>(value);
+                        break;
+                    case kDoubleValue: {
+                        double d;
+                        memcpy(&d, &value, sizeof(d));
+                        out << d;
+                        break;
+                    }
+                    case kStringValue:
+                    case kCopyStringValue:
+                        writeJsonString(out, reinterpret_cast<const char *>(value));
+                        break;
+                    default: {
+                        char pointer[32];
+                        snprintf(pointer, sizeof(pointer), "\"0x%llx\"", static_cast<unsigned long long>(value));
+                        out << pointer;
+                        break;
+                    }
+                    }
+                }
+                out << "}";
+            }
+            out << "}";
+            ++eventCount;
+        }
+    }
+    out << "\n]}\n";
+    std::cout << "Trace: " << eventCount << " events from " << fThreads.size() << " threads written to " << path;
+    if (dropped > 0) {
+        std::cout << " (" << dropped << " oldest events overwritten, raise --trace-buffer)";
+    }
+    std::cout << std::endl;
+    return static_cast<bool>(out);
+}
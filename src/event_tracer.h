@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "include/utils/SkEventTracer.h"
+
+struct TraceOptions
+{
+    std::string path;                   // 비어 있으면 tracer 를 설치하지 않음
+    std::string categories = "*";       // 쉼표 목록. "-x" 는 제외, "x*" 는 prefix, "*" 는 disabled-by-default-* 외 전부
+    uint32_t eventsPerThread = 1 << 16; // 스레드별 ring buffer 크기 (2 의 거듭제곱으로 올림), 넘치면 오래된 것부터 덮어씀
+    bool startEnabled = true;           // false 면 setEnabled(true) (창 모드에서는 T 키) 전까지 기록하지 않음
+};
+
+// --trace=FILE, --trace-categories=LIST, --trace-buffer=N, --trace-paused 를 처리하면 true
+bool parseTraceArg(const char *arg, TraceOptions &options);
+
+// Skia 내부 TRACE_EVENT 와 앱 구간(TraceSpan)을 스레드별 ring buffer 에 모아 Chrome trace JSON 으로 내보낸다.
+// 기록 경로는 lock 없이 자기 스레드 buffer 에만 쓰고, 스레드가 처음 기록할 때만 등록용 mutex 를 잡는다.
+// writeJson() 은 다른 스레드가 기록 중이어도 부를 수 있지만 그 순간 덮어쓰이는 이벤트는 깨질 수 있으므로
+// 보통 setEnabled(false) 뒤에 호출한다. 결과는 chrome://tracing 또는 ui.perfetto.dev 에서 연다.
+class EventTracer : public SkEventTracer
+{
+public:
+    // SkEventTracer::SetInstance 로 등록 (프로세스당 한 번, 소유권은 Skia). path 가 비었거나 실패하면 nullptr
+    static EventTracer *Install(const TraceOptions &options);
+    // 설치된 tracer (없으면 nullptr)
+    static EventTracer *Get() { return gInstance.load(std::memory_order_acquire); }
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return fEnabled.load(std::memory_order_relaxed); }
+    // 현재 스레드의 trace 상 이름 (기본 "thread N")
+    void setThreadName(const char *name);
+
+    bool writeJson(const std::string &path) const;
+    bool writeJson() const { return writeJson(fOptions.path); }
+    const std::string &path() const { return fOptions.path; }
+
+    // SkEventTracer
+    const uint8_t *getCategoryGroupEnabled(const char *name) override;
+    const char *getCategoryGroupName(const uint8_t *categoryEnabledFlag) override;
+    Handle addTraceEvent(char phase, const uint8_t *categoryEnabledFlag, const char *name, uint64_t id,
+                         int32_t numArgs, const char **argNames, const uint8_t *argTypes, const uint64_t *argValues,
+                         uint8_t flags) override;
+    void updateTraceEventDuration(const uint8_t *categoryEnabledFlag, const char *name, Handle handle) override;
+
+    // TraceSpan 용: "app" category 가 지금 기록 중인지
+    bool appEnabled() const { return *fAppCategory != 0; }
+    Handle beginSpan(const char *name);
+    void endSpan(Handle handle) { updateTraceEventDuration(fAppCategory, nullptr, handle); }
+
+private:
+    static constexpr int kMaxArgs = 2;
+    static constexpr int kMaxCategories = 256;
+    static constexpr size_t kCopiedStringSize = 48;
+
+    struct Event
+    {
+        const char *name;
+        uint64_t startNs;
+        uint64_t durationNs;        // 'X' 는 범위가 끝날 때 채움
+        uint64_t id;
+        uint16_t category;
+        char phase;
+        uint8_t numArgs;
+        const char *argNames[kMaxArgs];
+        uint8_t argTypes[kMaxArgs];
+        uint64_t argValues[kMaxArgs];
+        char copiedString[kCopiedStringSize];  // TRACE_EVENT_FLAG_COPY 이름 또는 TRACE_STR_COPY 인자 하나
+    };
+
+    struct ThreadBuffer
+    {
+        int tid = 0;
+        std::string name;
+        std::vector<Event> events;
+        uint64_t mask = 0;
+        std::atomic<uint64_t> head{0};      // 지금까지 기록한 이벤트 수 (다음 slot = head & mask)
+    };
+
+    explicit EventTracer(const TraceOptions &options);
+
+    uint64_t nowNs() const;
+    ThreadBuffer &threadBuffer();
+    bool categoryEnabled(const std::string &group) const;
+    void updateFlags();
+
+    static std::atomic<EventTracer *> gInstance;
+
+    TraceOptions fOptions;
+    std::chrono::steady_clock::time_point fOrigin;
+    std::atomic<bool> fEnabled{false};
+    const uint8_t *fAppCategory = nullptr;
+
+    mutable std::mutex fMutex;      // 카테고리 등록, 스레드 등록, writeJson
+    uint8_t fCategoryFlags[kMaxCategories] = {};
+    std::deque<std::string> fCategoryNames;
+    std::vector<bool> fCategoryMatches;
+    std::vector<std::unique_ptr<ThreadBuffer>> fThreads;
+};
+
+// 앱 코드의 구간을 "app" category 의 complete 이벤트로 기록. tracer 가 없거나 꺼져 있으면 아무것도 하지 않음.
+// name 은 tracer 가 살아 있는 동안 유효한 문자열(리터럴)이어야 한다.
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char *name)
+    {
+        EventTracer *tracer = EventTracer::Get();
+        if (tracer && tracer->appEnabled()) {
+            fTracer = tracer;
+            fHandle = tracer->beginSpan(name);
+        }
+    }
+    ~TraceSpan()
+    {
+        if (fTracer) {
+            fTracer->endSpan(fHandle);
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    EventTracer *fTracer = nullptr;
+    SkEventTracer::Handle fHandle = 0;
+};
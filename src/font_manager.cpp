@@ -0,0 +1,41 @@
+#include "font_manager.h"
+
+#include <future>
+#include <mutex>
+
+#include "include/ports/SkFontMgr_fontconfig.h"
+
+#include "startup_trace.h"
+
+namespace {
+
+std::mutex gMutex;
+std::shared_future<sk_sp<SkFontMgr>> gFontMgr;
+
+sk_sp<SkFontMgr> createFontMgr()
+{
+    StartupPhase phase("fontconfig");
+    return SkFontMgr_New_FontConfig(nullptr);
+}
+
+std::shared_future<sk_sp<SkFontMgr>> startFontMgr(std::launch policy)
+{
+    std::lock_guard<std::mutex> lock(gMutex);
+    if (!gFontMgr.valid()) {
+        gFontMgr = std::async(policy, createFontMgr).share();
+    }
+    return gFontMgr;
+}
+
+} // namespace
+
+void prewarmFontMgr()
+{
+    startFontMgr(std::launch::async);
+}
+
+sk_sp<SkFontMgr> sharedFontMgr()
+{
+    // prewarm 하지 않았다면 deferred 로 만들어 이 스레드에서 바로 생성
+    return startFontMgr(std::launch::deferred).get();
+}
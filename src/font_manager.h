@@ -0,0 +1,10 @@
+#pragma once
+
+#include "include/core/SkFontMgr.h"
+#include "include/core/SkRefCnt.h"
+
+// fontconfig 초기화(폰트 디렉터리 스캔)는 수십 ms 가 걸리므로 시작할 때 백그라운드에서 시작해 둔다.
+void prewarmFontMgr();
+
+// 프로세스 공용 fontconfig SkFontMgr. prewarm 중이면 끝날 때까지 기다리고, 아니면 여기서 생성
+sk_sp<SkFontMgr> sharedFontMgr();
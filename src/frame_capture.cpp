@@ -0,0 +1,179 @@
+#include "frame_capture.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include "include/core/SkStream.h"
+#include "include/gpu/ganesh/GrDirectContext.h"
+
+#include "frame_path.h"
+
+bool parseCaptureArg(const char *arg, CaptureOptions &options)
+{
+    if (strncmp(arg, "--capture=", 10) == 0) {
+        options.imagePattern = arg + 10;
+    } else if (strncmp(arg, "--capture-yuv=", 14) == 0) {
+        options.yuvPath = arg + 14;
+    } else if (strncmp(arg, "--capture-size=", 15) == 0) {
+        int w = 0, h = 0;
+        sscanf(arg + 15, "%dx%d", &w, &h);
+        options.size = SkISize::Make(w, h);
+    } else if (strncmp(arg, "--capture-slots=", 16) == 0) {
+        options.slots = atoi(arg + 16);
+    } else if (strncmp(arg, "--capture-backlog=", 18) == 0) {
+        options.backlog = atoi(arg + 18);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+FrameCapture::FrameCapture() = default;
+
+FrameCapture::~FrameCapture()
+{
+    stopWriter();
+}
+
+bool FrameCapture::init(const CaptureOptions &options)
+{
+    if (!options.enabled()) {
+        return true;
+    }
+    if (!options.imagePattern.empty() && !options.yuvPath.empty()) {
+        std::cerr << "--capture and --capture-yuv are exclusive" << std::endl;
+        return false;
+    }
+    fOptions = options;
+
+    ReadbackOptions readback;
+    readback.slots = options.slots;
+    readback.size = options.size;
+    if (!options.yuvPath.empty()) {
+        readback.format = ReadbackFormat::kYUV420;
+        fYuvFile = std::make_unique<SkFILEWStream>(options.yuvPath.c_str());
+        if (!fYuvFile->isValid()) {
+            std::cerr << "Failed to open " << options.yuvPath << std::endl;
+            fYuvFile.reset();
+            return false;
+        }
+    } else {
+        std::string patternError;
+        if (!isValidFramePattern(options.imagePattern, &patternError)) {
+            std::cerr << "Invalid capture pattern " << options.imagePattern << ": " << patternError << std::endl;
+            return false;
+        }
+        const std::string &pattern = options.imagePattern;
+        fEncode.format = pattern.size() > 4 && pattern.compare(pattern.size() - 4, 4, ".qoi") == 0
+                                 ? EncodeFormat::kQoi
+                                 : EncodeFormat::kPng;
+        fEncode.preset = EncodePreset::kFastest;
+        // 렌더 스레드와 코어를 나눠 쓰도록 인코딩 스레드는 절반만
+        fEncodePool = std::make_unique<ThreadPool>(
+                std::max(1, static_cast<int>(std::thread::hardware_concurrency() / 2)));
+    }
+
+    // 버퍼는 처음 쓸 때 프레임 크기로 잡히고 이후에는 재사용된다
+    const int backlog = std::max(1, options.backlog);
+    fBuffers.resize(backlog);
+    fFreeBuffers = std::make_unique<BoundedQueue<int>>(backlog);
+    fJobs = std::make_unique<BoundedQueue<WriteJob>>(backlog);
+    for (int i = 0; i < backlog; ++i) {
+        fFreeBuffers->push(i);
+    }
+    fWriter = std::thread([this] { writerLoop(); });
+
+    fRing = std::make_unique<AsyncReadbackRing>(readback);
+    return true;
+}
+
+void FrameCapture::request(SkSurface *surface, uint64_t frame)
+{
+    if (fRing) {
+        fRing->request(surface, frame);
+    }
+}
+
+void FrameCapture::poll(GrDirectContext *context)
+{
+    if (fRing) {
+        fRing->poll(context, [this](const ReadbackFrame &frame) { consume(frame, false); });
+    }
+}
+
+void FrameCapture::consume(const ReadbackFrame &frame, bool waitForBuffer)
+{
+    WriteJob job;
+    if (!(waitForBuffer ? fFreeBuffers->pop(job.buffer) : fFreeBuffers->tryPop(job.buffer))) {
+        // writer 가 밀려 있으면 렌더 스레드를 세우지 않고 이 프레임은 버린다
+        ++fWriteDropped;
+        return;
+    }
+    job.frame = frame.frame;
+    if (!fYuvFile) {
+        job.info = frame.rgba.info();
+    }
+    // 슬롯 버퍼를 통째로 가져가고 writer 가 다 쓴 버퍼를 슬롯에 돌려준다 (렌더 스레드에서 프레임 복사 없음).
+    // 슬롯 버퍼는 빽빽한 RGBA 또는 Y|U|V 이므로 그대로 쓸 수 있다
+    fBuffers[job.buffer].swap(*frame.storage);
+    // 큐 깊이가 버퍼 수와 같으므로 블록하지 않는다
+    fJobs->push(job);
+}
+
+void FrameCapture::writerLoop()
+{
+    WriteJob job;
+    while (fJobs->pop(job)) {
+        const std::vector<uint8_t> &pixels = fBuffers[job.buffer];
+        bool ok = false;
+        if (fYuvFile) {
+            ok = fYuvFile->write(pixels.data(), pixels.size());
+            if (!ok) {
+                std::cerr << "Failed to write frame " << job.frame << " to " << fOptions.yuvPath << std::endl;
+            }
+        } else {
+            std::string path = formatFramePath(fOptions.imagePattern, static_cast<int>(job.frame));
+            SkFILEWStream file(path.c_str());
+            SkPixmap pixmap(job.info, pixels.data(), job.info.minRowBytes());
+            ok = file.isValid() && fEncoder.encode(pixmap, fEncode, fEncodePool.get(), &file);
+            if (!ok) {
+                std::cerr << "Failed to write " << path << std::endl;
+            }
+        }
+        if (ok) {
+            ++fWritten;
+        } else {
+            ++fWriteFailed;
+        }
+        fFreeBuffers->push(job.buffer);
+    }
+}
+
+void FrameCapture::stopWriter()
+{
+    if (fWriter.joinable()) {
+        fJobs->close();
+        fWriter.join();
+    }
+}
+
+void FrameCapture::finish(GrDirectContext *context)
+{
+    if (!fRing) {
+        return;
+    }
+    // 종료 시에는 남은 프레임을 버리지 않도록 writer 를 기다린다
+    fRing->drain(context, [this](const ReadbackFrame &frame) { consume(frame, true); });
+    stopWriter();
+    if (fYuvFile) {
+        fYuvFile->flush();
+    }
+    std::cout << "Capture: " << fWritten.load() << " frames written, " << fRing->dropped() << " dropped at readback, "
+              << fWriteDropped << " dropped behind writer, " << fRing->failed() + fWriteFailed.load() << " failed"
+              << std::endl;
+    fRing.reset();
+}
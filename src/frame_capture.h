@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkSize.h"
+
+#include "bounded_queue.h"
+#include "gpu_readback.h"
+#include "image_encoder.h"
+#include "thread_pool.h"
+
+class GrDirectContext;
+class SkFILEWStream;
+class SkSurface;
+
+struct CaptureOptions
+{
+    std::string imagePattern;   // frame 마다 이미지, 예: cap_%05d.png (frame_path.h, .qoi 면 QOI, 아니면 PNG fastest)
+    std::string yuvPath;        // I420 raw stream 하나로 이어 쓰기 (ffmpeg -f rawvideo -pix_fmt yuv420p)
+    SkISize size = {0, 0};      // 0 이면 surface 크기
+    int slots = 3;
+    int backlog = 8;            // writer 를 기다리는 프레임 버퍼 수 (모두 차 있으면 drop)
+
+    bool enabled() const { return !imagePattern.empty() || !yuvPath.empty(); }
+};
+
+// --capture=PATTERN, --capture-yuv=FILE, --capture-size=WxH, --capture-slots=N, --capture-backlog=N 을 처리하면 true
+bool parseCaptureArg(const char *arg, CaptureOptions &options);
+
+// AsyncReadbackRing 결과를 파일로 내보내는 GPU 샘플 공용 캡처 경로.
+// 렌더 스레드는 readback 슬롯 버퍼를 미리 정한 수(backlog)의 writer 버퍼 중 빈 것과 swap 만 하고, 인코딩과
+// 파일 쓰기(YUV 포함)는 writer 스레드가 한 뒤 버퍼를 돌려준다. 빈 버퍼가 없으면 기다리지 않고 그 프레임을 버리고 센다.
+class FrameCapture
+{
+public:
+    FrameCapture();
+    ~FrameCapture();
+
+    bool init(const CaptureOptions &options);
+    bool enabled() const { return fRing != nullptr; }
+
+    // 그리기 후, flush 전에 호출
+    void request(SkSurface *surface, uint64_t frame);
+    // 매 프레임 호출: 완료된 readback 을 writer 에 넘긴다
+    void poll(GrDirectContext *context);
+    // 종료 시: 남은 readback 과 쓰기를 마치고 통계 출력
+    void finish(GrDirectContext *context);
+
+private:
+    struct WriteJob
+    {
+        uint64_t frame = 0;
+        int buffer = -1;
+        SkImageInfo info;   // 이미지일 때 픽셀 형식 (rowBytes 는 minRowBytes)
+    };
+
+    // waitForBuffer 가 false 면 빈 버퍼가 없을 때 drop (렌더 루프), true 면 writer 를 기다림 (finish)
+    void consume(const ReadbackFrame &frame, bool waitForBuffer);
+    void writerLoop();
+    void stopWriter();
+
+    CaptureOptions fOptions;
+    EncodeOptions fEncode;
+    std::unique_ptr<AsyncReadbackRing> fRing;
+    std::unique_ptr<SkFILEWStream> fYuvFile;
+
+    // writer 스레드 쪽. fBuffers[i] 는 fFreeBuffers 에서 꺼낸 스레드만 만진다.
+    // readback 슬롯과 swap 하며 돌므로 처음 몇 프레임 뒤에는 새로 할당하지 않는다
+    std::vector<std::vector<uint8_t>> fBuffers;
+    std::unique_ptr<BoundedQueue<int>> fFreeBuffers;
+    std::unique_ptr<BoundedQueue<WriteJob>> fJobs;
+    std::unique_ptr<ThreadPool> fEncodePool;
+    ImageEncoder fEncoder;
+    std::thread fWriter;
+
+    uint64_t fWriteDropped = 0;             // 렌더 스레드에서만 갱신
+    std::atomic<uint64_t> fWritten{0};
+    std::atomic<uint64_t> fWriteFailed{0};
+};
@@ -0,0 +1,96 @@
+#include "frame_path.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// pattern[pos] 가 '%' 일 때 변환 하나를 읽는다. 성공하면 spec 에 "%...d" 를 담고 end 는 변환 다음 위치
+bool parseConversion(const std::string &pattern, size_t pos, std::string *spec, size_t *end)
+{
+    size_t i = pos + 1;
+    while (i < pattern.size() && strchr("-+ 0", pattern[i])) {
+        ++i;
+    }
+    auto digits = [&pattern, &i] {
+        size_t start = i;
+        while (i < pattern.size() && isdigit(static_cast<unsigned char>(pattern[i]))) {
+            ++i;
+        }
+        return i - start;
+    };
+    if (digits() > 2) {
+        return false;
+    }
+    if (i < pattern.size() && pattern[i] == '.') {
+        ++i;
+        if (digits() > 2) {
+            return false;
+        }
+    }
+    if (i >= pattern.size() || (pattern[i] != 'd' && pattern[i] != 'i')) {
+        return false;
+    }
+    *spec = pattern.substr(pos, i - pos) + 'd';
+    *end = i + 1;
+    return true;
+}
+
+} // namespace
+
+bool isValidFramePattern(const std::string &pattern, std::string *error)
+{
+    int conversions = 0;
+    for (size_t i = 0; i < pattern.size();) {
+        if (pattern[i] != '%') {
+            ++i;
+            continue;
+        }
+        if (i + 1 < pattern.size() && pattern[i + 1] == '%') {
+            i += 2;
+            continue;
+        }
+        std::string spec;
+        if (!parseConversion(pattern, i, &spec, &i)) {
+            if (error) {
+                *error = "only integer conversions like %05d are allowed (use %% for a literal %)";
+            }
+            return false;
+        }
+        ++conversions;
+    }
+    if (conversions != 1 && error) {
+        *error = conversions == 0 ? "needs a frame number placeholder (e.g. frame_%05d.png)"
+                                  : "has more than one frame number placeholder";
+    }
+    return conversions == 1;
+}
+
+std::string formatFramePath(const std::string &pattern, int frame)
+{
+    std::string path;
+    path.reserve(pattern.size() + 16);
+    for (size_t i = 0; i < pattern.size();) {
+        if (pattern[i] != '%') {
+            path += pattern[i++];
+            continue;
+        }
+        if (i + 1 < pattern.size() && pattern[i + 1] == '%') {
+            path += '%';
+            i += 2;
+            continue;
+        }
+        std::string spec;
+        if (!parseConversion(pattern, i, &spec, &i)) {
+            // 검증하지 않은 pattern: 나머지는 그대로 둔다
+            path.append(pattern, i, std::string::npos);
+            break;
+        }
+        // spec 은 위에서 만든 "%[flags][w][.p]d" 이고 width/precision 이 두 자리 이하라 버퍼를 넘지 않는다
+        char number[256];
+        snprintf(number, sizeof(number), spec.c_str(), frame);
+        path += number;
+    }
+    return path;
+}
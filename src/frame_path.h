@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+// frame 번호가 들어가는 출력 경로 패턴 (예: frames/frame_%05d.png).
+// 사용자 입력을 printf 형식 문자열로 그대로 넘기지 않도록 정수 변환 하나만 허용하고 직접 치환한다.
+// 허용: flag(- + 0 공백), 두 자리까지의 width / .precision, d 또는 i. 리터럴 % 는 %%.
+
+// 정수 변환이 정확히 하나이고 그 외 변환이 없으면 true. 아니면 error 에 이유
+bool isValidFramePattern(const std::string &pattern, std::string *error = nullptr);
+
+// isValidFramePattern 을 통과한 pattern 의 변환 자리를 frame 으로 바꾼 경로
+std::string formatFramePath(const std::string &pattern, int frame);
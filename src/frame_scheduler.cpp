@@ -0,0 +1,151 @@
+#include "frame_scheduler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <GLFW/glfw3.h>
+
+bool parseSchedulerArg(const char *arg, SchedulerOptions &options)
+{
+    if (strcmp(arg, "--continuous") == 0) {
+        options.continuous = true;
+    } else if (strncmp(arg, "--max-fps=", 10) == 0) {
+        options.maxFps = std::max(0, atoi(arg + 10));
+    } else if (strncmp(arg, "--idle-trim-ms=", 15) == 0) {
+        options.idleTrimDelay = atoi(arg + 15) / 1000.0;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+FrameScheduler::FrameScheduler(const SchedulerOptions &options)
+    : fOptions(options),
+      fMinInterval(options.maxFps > 0 ? 1.0 / options.maxFps : 0.0),
+      fOrigin(std::chrono::steady_clock::now()),
+      fThread(std::this_thread::get_id()),
+      fLastFrame(-fMinInterval)
+{
+}
+
+double FrameScheduler::now() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - fOrigin).count();
+}
+
+void FrameScheduler::invalidate()
+{
+    fDirty.store(true, std::memory_order_release);
+    // 렌더 스레드는 어차피 이벤트 처리 후 다시 확인하므로 다른 스레드에서 온 요청만 깨운다
+    if (std::this_thread::get_id() != fThread) {
+        glfwPostEmptyEvent();
+    }
+}
+
+void FrameScheduler::endAnimation()
+{
+    if (fAnimations > 0 && --fAnimations == 0) {
+        // 마지막 상태를 그린 프레임이 한 번 더 필요
+        fDirty.store(true, std::memory_order_release);
+    }
+}
+
+int FrameScheduler::addTimer(double interval, TimerCallback callback)
+{
+    int id = fNextTimerId++;
+    fTimers.push_back({id, interval, now() + interval, std::move(callback)});
+    return id;
+}
+
+void FrameScheduler::cancelTimer(int id)
+{
+    fTimers.erase(std::remove_if(fTimers.begin(), fTimers.end(), [id](const Timer &t) { return t.id == id; }),
+                  fTimers.end());
+}
+
+void FrameScheduler::runTimers(double now)
+{
+    // callback 이 타이머를 추가/해제할 수 있으므로 만기된 id 를 먼저 모은 뒤 하나씩 찾아 실행
+    std::vector<int> due;
+    for (const Timer &timer : fTimers) {
+        if (timer.next <= now) {
+            due.push_back(timer.id);
+        }
+    }
+    for (int id : due) {
+        auto it = std::find_if(fTimers.begin(), fTimers.end(), [id](const Timer &t) { return t.id == id; });
+        if (it == fTimers.end()) {
+            continue;
+        }
+        it->next = now + it->interval;
+        TimerCallback callback = it->callback;
+        if (!callback()) {
+            cancelTimer(id);
+        }
+    }
+}
+
+bool FrameScheduler::waitForFrame(GLFWwindow *window)
+{
+    glfwPollEvents();
+    bool idled = false;
+    for (;;) {
+        if (glfwWindowShouldClose(window)) {
+            return false;
+        }
+        double t = now();
+        runTimers(t);
+
+        double deadline = std::numeric_limits<double>::infinity();
+        bool wanted = fOptions.continuous || fAnimations > 0 || fDirty.load(std::memory_order_acquire);
+        if (wanted) {
+            // fps 상한: 이전 프레임에서 최소 간격이 지나지 않았으면 남은 시간만큼 이벤트를 받으며 대기
+            double next = fLastFrame + fMinInterval;
+            if (t >= next) {
+                fDirty.store(false, std::memory_order_relaxed);
+                fLastFrame = t;
+                fIdleTrimmed = false;
+                fIdledBeforeFrame = idled;
+                ++fFrames;
+                return true;
+            }
+            deadline = next;
+        } else if (fIdleCallback && !fIdleTrimmed && fOptions.idleTrimDelay >= 0) {
+            double trimAt = fLastFrame + fOptions.idleTrimDelay;
+            if (t >= trimAt) {
+                fIdleTrimmed = true;
+                ++fIdleTrims;
+                fIdleCallback();
+                continue;
+            }
+            deadline = trimAt;
+        }
+        for (const Timer &timer : fTimers) {
+            deadline = std::min(deadline, timer.next);
+        }
+        idled = idled || !wanted;
+
+        if (deadline == std::numeric_limits<double>::infinity()) {
+            glfwWaitEvents();
+        } else {
+            glfwWaitEventsTimeout(std::max(0.0, deadline - t));
+        }
+        fWaitSeconds += now() - t;
+        ++fWakeups;
+    }
+}
+
+void FrameScheduler::printStats(std::ostream &os) const
+{
+    double elapsed = now();
+    os << "Scheduler: " << fFrames << " frames, " << fWakeups << " wakeups, waiting "
+       << (elapsed > 0 ? fWaitSeconds / elapsed * 100.0 : 0.0) << "% of " << elapsed << " s, " << fIdleTrims
+       << " idle trims";
+    if (fOptions.continuous) {
+        os << " (continuous)";
+    } else if (fOptions.maxFps > 0) {
+        os << " (max " << fOptions.maxFps << " fps)";
+    }
+    os << std::endl;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+struct GLFWwindow;
+
+struct SchedulerOptions
+{
+    bool continuous = false;        // 바뀐 것이 없어도 매 프레임 그림 (이전 동작, 측정용)
+    int maxFps = 0;                 // 0 이면 제한 없음 (present mode / vsync 에 맡김)
+    double idleTrimDelay = 1.0;     // 마지막 프레임 후 이 시간(초) 동안 조용하면 idle hook 을 한 번 호출, < 0 이면 안 함
+};
+
+// --continuous, --max-fps=N, --idle-trim-ms=N 을 처리하면 true
+bool parseSchedulerArg(const char *arg, SchedulerOptions &options);
+
+// 창 모드 렌더 루프용 render-on-demand 스케줄러.
+// invalidate() 되었거나, 애니메이션이 진행 중이거나, 타이머 callback 이 프레임을 요청했을 때만 waitForFrame() 이 돌아오고
+// 그 외에는 glfwWaitEvents / glfwWaitEventsTimeout 에서 block 하므로 정적인 화면에서는 CPU / GPU 를 거의 쓰지 않는다.
+// invalidate() 외의 함수는 렌더 스레드(GLFW main 스레드)에서만 호출할 것.
+class FrameScheduler
+{
+public:
+    using TimerCallback = std::function<bool()>;    // false 를 돌려주면 해제
+
+    explicit FrameScheduler(const SchedulerOptions &options);
+
+    // 다음 프레임을 요청. 다른 스레드에서 부르면 대기 중인 루프를 깨운다
+    void invalidate();
+    // begin 과 end 사이에는 매 프레임 그린다 (중첩 가능)
+    void beginAnimation() { ++fAnimations; }
+    void endAnimation();
+    bool isAnimating() const { return fAnimations > 0; }
+
+    // interval 초마다 렌더 스레드에서 callback. 그려야 할 것이 생기면 callback 안에서 invalidate()
+    int addTimer(double interval, TimerCallback callback);
+    void cancelTimer(int id);
+    // idleTrimDelay 동안 그리지 않으면 한 번 호출, 다음 프레임 이후 다시 대기
+    void setIdleCallback(std::function<void()> callback) { fIdleCallback = std::move(callback); }
+
+    // 그릴 일이 생길 때까지 창 이벤트를 처리하며 대기. 창이 닫히면 false
+    bool waitForFrame(GLFWwindow *window);
+    // 방금 돌아온 프레임 전에 그릴 것이 없어 대기했는지 (fps 상한 대기는 제외). 프레임 간격 통계를 끊는 데 사용
+    bool idledBeforeFrame() const { return fIdledBeforeFrame; }
+
+    // 그린 프레임 수, 깨어난 횟수, 대기한 시간 비율, idle hook 호출 수
+    void printStats(std::ostream &os) const;
+
+private:
+    struct Timer
+    {
+        int id;
+        double interval;
+        double next;
+        TimerCallback callback;
+    };
+
+    double now() const;
+    void runTimers(double now);
+
+    SchedulerOptions fOptions;
+    double fMinInterval;
+    std::chrono::steady_clock::time_point fOrigin;
+    std::thread::id fThread;
+
+    std::atomic<bool> fDirty{true};     // 첫 프레임은 항상 그림
+    int fAnimations = 0;
+    std::vector<Timer> fTimers;
+    int fNextTimerId = 1;
+    std::function<void()> fIdleCallback;
+    bool fIdleTrimmed = false;
+    bool fIdledBeforeFrame = false;
+
+    double fLastFrame;
+    uint64_t fFrames = 0;
+    uint64_t fWakeups = 0;
+    uint64_t fIdleTrims = 0;
+    double fWaitSeconds = 0;
+};
@@ -0,0 +1,233 @@
+#include "frame_stats.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+static constexpr int kStageCount = static_cast<int>(FrameStage::kCount);
+
+const char *frameStageName(FrameStage stage)
+{
+    switch (stage) {
+        case FrameStage::kAcquire: return "acquire";
+        case FrameStage::kRecord:  return "record";
+        case FrameStage::kFlush:   return "flush";
+        case FrameStage::kPresent: return "present";
+        case FrameStage::kGpu:     return "gpu";
+        default:                   return "unknown";
+    }
+}
+
+FrameStats::FrameStats(size_t window, size_t maxRecords)
+    : fWindow(std::max<size_t>(1, window))
+    , fMaxRecords(std::max(window, maxRecords))
+{
+}
+
+uint64_t FrameStats::beginFrame()
+{
+    auto now = std::chrono::steady_clock::now();
+    fCurrent = FrameTiming();
+    fCurrent.frame = fFrameCount;
+    std::fill(std::begin(fCurrent.ms), std::end(fCurrent.ms), -1.0);
+    if (fHasLastFrame) {
+        std::chrono::duration<double, std::milli> interval = now - fLastFrameStart;
+        fCurrent.totalMs = interval.count();
+    }
+    fLastFrameStart = now;
+    fHasLastFrame = true;
+    return fCurrent.frame;
+}
+
+void FrameStats::record(FrameStage stage, double ms)
+{
+    double &slot = fCurrent.ms[static_cast<int>(stage)];
+    // 한 프레임에 여러 번 기록되면 합산 (예: resize 후 재시도한 acquire)
+    slot = slot < 0 ? ms : slot + ms;
+}
+
+void FrameStats::cancelFrame()
+{
+    fCurrent = FrameTiming();
+    fCurrent.frame = fFrameCount;
+    fHasLastFrame = false;
+}
+
+void FrameStats::setStartTime(std::chrono::steady_clock::time_point start)
+{
+    fStartTime = start;
+    fHasStartTime = true;
+}
+
+void FrameStats::endFrame()
+{
+    if (fFrameCount == 0) {
+        auto now = std::chrono::steady_clock::now();
+        fFirstFrameMs = std::chrono::duration<double, std::milli>(now - fLastFrameStart).count();
+        if (fHasStartTime) {
+            fTimeToFirstFrameMs = std::chrono::duration<double, std::milli>(now - fStartTime).count();
+        }
+    }
+    fRecords.push_back(fCurrent);
+    if (fRecords.size() > fMaxRecords) {
+        fRecords.pop_front();
+    }
+    ++fFrameCount;
+}
+
+FrameTiming *FrameStats::findRecord(uint64_t frame)
+{
+    // GPU 결과는 최근 몇 프레임 안에서 도착하므로 뒤에서부터 찾는다
+    for (auto it = fRecords.rbegin(); it != fRecords.rend(); ++it) {
+        if (it->frame == frame) {
+            return &*it;
+        }
+        if (it->frame < frame) {
+            break;
+        }
+    }
+    return nullptr;
+}
+
+void FrameStats::setGpuTime(uint64_t frame, double ms)
+{
+    if (frame == fCurrent.frame && frame == fFrameCount) {
+        fCurrent.ms[static_cast<int>(FrameStage::kGpu)] = ms;
+    } else if (FrameTiming *timing = findRecord(frame)) {
+        timing->ms[static_cast<int>(FrameStage::kGpu)] = ms;
+    }
+}
+
+StagePercentiles FrameStats::percentiles(FrameStage stage) const
+{
+    std::vector<double> values;
+    values.reserve(fWindow);
+    size_t count = std::min(fWindow, fRecords.size());
+    for (auto it = fRecords.end() - count; it != fRecords.end(); ++it) {
+        double ms = stage == FrameStage::kCount ? it->totalMs : it->ms[static_cast<int>(stage)];
+        if (ms >= 0) {
+            values.push_back(ms);
+        }
+    }
+
+    StagePercentiles result;
+    result.samples = values.size();
+    if (values.empty()) {
+        return result;
+    }
+    auto pick = [&values](double p) {
+        size_t index = std::min(values.size() - 1, static_cast<size_t>(p * (values.size() - 1) + 0.5));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    };
+    result.p50 = pick(0.50);
+    result.p95 = pick(0.95);
+    result.p99 = pick(0.99);
+    return result;
+}
+
+void FrameStats::printSummary(std::ostream &os) const
+{
+    os << "Frame stats (" << fFrameCount << " frames, last " << std::min(fWindow, fRecords.size())
+       << " used)" << std::endl;
+    os << std::fixed << std::setprecision(3);
+    for (int i = 0; i <= kStageCount; ++i) {
+        FrameStage stage = static_cast<FrameStage>(i);
+        StagePercentiles p = percentiles(stage);
+        if (p.samples == 0) {
+            continue;
+        }
+        os << "  " << std::setw(8) << (stage == FrameStage::kCount ? "frame" : frameStageName(stage))
+           << "  p50 " << p.p50 << " ms  p95 " << p.p95 << " ms  p99 " << p.p99 << " ms" << std::endl;
+    }
+    if (fFirstFrameMs >= 0) {
+        StagePercentiles frame = percentiles(FrameStage::kCount);
+        os << "  first frame " << fFirstFrameMs << " ms";
+        if (frame.p50 > 0) {
+            os << " (" << fFirstFrameMs / frame.p50 << "x p50)";
+        }
+        if (fTimeToFirstFrameMs >= 0) {
+            os << ", time to first frame " << fTimeToFirstFrameMs << " ms";
+        }
+        os << std::endl;
+    }
+    os << std::defaultfloat;
+}
+
+bool FrameStats::writeCsv(const std::string &path) const
+{
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << "frame,total_ms";
+    for (int i = 0; i < kStageCount; ++i) {
+        out << "," << frameStageName(static_cast<FrameStage>(i)) << "_ms";
+    }
+    out << "\n";
+    for (const auto &timing : fRecords) {
+        out << timing.frame << ",";
+        if (timing.totalMs >= 0) {
+            out << timing.totalMs;
+        }
+        for (int i = 0; i < kStageCount; ++i) {
+            out << ",";
+            if (timing.ms[i] >= 0) {
+                out << timing.ms[i];
+            }
+        }
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+bool FrameStats::writeJson(const std::string &path) const
+{
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << "{\n  \"summary\": {";
+    for (int i = 0; i <= kStageCount; ++i) {
+        FrameStage stage = static_cast<FrameStage>(i);
+        StagePercentiles p = percentiles(stage);
+        out << (i ? ", " : "") << "\"" << (stage == FrameStage::kCount ? "frame" : frameStageName(stage))
+            << "\": {\"p50\": " << p.p50 << ", \"p95\": " << p.p95 << ", \"p99\": " << p.p99
+            << ", \"samples\": " << p.samples << "}";
+    }
+    out << "},\n  \"startup\": {\"time_to_first_frame_ms\": ";
+    if (fTimeToFirstFrameMs >= 0) {
+        out << fTimeToFirstFrameMs;
+    } else {
+        out << "null";
+    }
+    out << ", \"first_frame_ms\": ";
+    if (fFirstFrameMs >= 0) {
+        out << fFirstFrameMs;
+    } else {
+        out << "null";
+    }
+    out << "},\n  \"frames\": [";
+    bool first = true;
+    for (const auto &timing : fRecords) {
+        out << (first ? "\n" : ",\n") << "    {\"frame\": " << timing.frame << ", \"total_ms\": ";
+        if (timing.totalMs >= 0) {
+            out << timing.totalMs;
+        } else {
+            out << "null";
+        }
+        for (int i = 0; i < kStageCount; ++i) {
+            out << ", \"" << frameStageName(static_cast<FrameStage>(i)) << "_ms\": ";
+            if (timing.ms[i] >= 0) {
+                out << timing.ms[i];
+            } else {
+                out << "null";
+            }
+        }
+        out << "}";
+        first = false;
+    }
+    out << "\n  ]\n}\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <string>
+
+#include "event_tracer.h"
+
+// 프레임 단계 (CSV/JSON 컬럼 순서와 동일)
+enum class FrameStage
+{
+    kAcquire,   // vkAcquireNextImageKHR / fence 대기
+    kRecord,    // drawFrame() - SkCanvas 기록
+    kFlush,     // GrDirectContext flush + submit
+    kPresent,   // vkQueuePresentKHR / glfwSwapBuffers
+    kGpu,       // GPU 실행 시간 (timestamp / GL_TIME_ELAPSED), 늦게 도착함
+    kCount,
+};
+
+const char *frameStageName(FrameStage stage);
+
+struct FrameTiming
+{
+    uint64_t frame = 0;
+    double ms[static_cast<int>(FrameStage::kCount)] = {};   // 측정 안 된 값은 -1
+    double totalMs = -1;                                    // CPU 측 프레임 간격 (이전 프레임이 없으면 -1)
+};
+
+struct StagePercentiles
+{
+    double p50 = 0;
+    double p95 = 0;
+    double p99 = 0;
+    size_t samples = 0;
+};
+
+// 프레임별 단계 시간을 모아 rolling percentile 을 계산하고 CSV/JSON 으로 덤프
+class FrameStats
+{
+public:
+    // window: percentile 계산에 쓰는 최근 프레임 수
+    // maxRecords: 덤프용으로 보관하는 최대 프레임 수 (초과 시 오래된 것부터 버림)
+    explicit FrameStats(size_t window = 240, size_t maxRecords = 100000);
+
+    uint64_t beginFrame();
+    // 렌더 루프가 이벤트를 기다리느라 쉬었을 때: 다음 프레임의 간격(totalMs)을 재지 않는다
+    void markIdle() { fHasLastFrame = false; }
+    // beginFrame 한 프레임을 그리지 못했을 때 (acquire 실패, swapchain 재생성): 기록하지 않고 닫는다.
+    // 같은 frame 번호는 다음 beginFrame 이 다시 쓰고, 그 프레임의 간격은 재지 않는다
+    void cancelFrame();
+    void record(FrameStage stage, double ms);
+    void endFrame();
+
+    // 프로세스 시작 시각: 첫 프레임까지 걸린 시간(time-to-first-frame) 계산용
+    void setStartTime(std::chrono::steady_clock::time_point start);
+    double timeToFirstFrameMs() const { return fTimeToFirstFrameMs; }
+    // 첫 프레임의 beginFrame ~ endFrame (shader 컴파일 hitch 가 여기 몰림)
+    double firstFrameMs() const { return fFirstFrameMs; }
+
+    // GPU 시간은 fence/query 완료 후에야 알 수 있으므로 frame 번호로 뒤늦게 채운다
+    void setGpuTime(uint64_t frame, double ms);
+
+    // FrameStage::kCount 를 넘기면 프레임 간격(totalMs) 기준
+    StagePercentiles percentiles(FrameStage stage) const;
+    uint64_t frameCount() const { return fFrameCount; }
+
+    void printSummary(std::ostream &os) const;
+    bool writeCsv(const std::string &path) const;
+    bool writeJson(const std::string &path) const;
+
+private:
+    FrameTiming *findRecord(uint64_t frame);
+
+    size_t fWindow;
+    size_t fMaxRecords;
+    uint64_t fFrameCount = 0;
+    FrameTiming fCurrent;
+    std::chrono::steady_clock::time_point fLastFrameStart;
+    bool fHasLastFrame = false;
+    std::chrono::steady_clock::time_point fStartTime;
+    bool fHasStartTime = false;
+    double fTimeToFirstFrameMs = -1;
+    double fFirstFrameMs = -1;
+    std::deque<FrameTiming> fRecords;
+};
+
+// 범위 시간을 FrameStats 의 단계에 기록
+class ScopedStageTimer
+{
+public:
+    ScopedStageTimer(FrameStats &stats, FrameStage stage)
+        : fStats(stats), fStage(stage), fStart(std::chrono::steady_clock::now()), fSpan(frameStageName(stage)) {}
+    ~ScopedStageTimer()
+    {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - fStart;
+        fStats.record(fStage, elapsed.count());
+    }
+
+private:
+    FrameStats &fStats;
+    FrameStage fStage;
+    std::chrono::steady_clock::time_point fStart;
+    TraceSpan fSpan;    // --trace 가 켜져 있으면 같은 구간을 trace 에도 기록
+};
@@ -0,0 +1,82 @@
+#include "gl_gpu_timer.h"
+
+#include <iostream>
+
+#include "frame_stats.h"
+
+bool GlGpuTimer::init(int depth)
+{
+    if (!GLEW_VERSION_3_3 && !GLEW_ARB_timer_query) {
+        std::cout << "GL_TIME_ELAPSED queries not supported" << std::endl;
+        return false;
+    }
+    fQueries.resize(depth > 0 ? depth : 1);
+    for (auto &query : fQueries) {
+        glGenQueries(1, &query.id);
+    }
+    return true;
+}
+
+void GlGpuTimer::destroy()
+{
+    for (auto &query : fQueries) {
+        glDeleteQueries(1, &query.id);
+    }
+    fQueries.clear();
+}
+
+void GlGpuTimer::begin(uint64_t frame)
+{
+    fActive = false;
+    if (fQueries.empty()) {
+        return;
+    }
+    Query &query = fQueries[fNext];
+    if (query.pending) {
+        return;
+    }
+    query.frame = frame;
+    glBeginQuery(GL_TIME_ELAPSED, query.id);
+    fActive = true;
+}
+
+void GlGpuTimer::end()
+{
+    if (!fActive) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    fQueries[fNext].pending = true;
+    fNext = (fNext + 1) % fQueries.size();
+    fActive = false;
+}
+
+void GlGpuTimer::collect(FrameStats &stats)
+{
+    collect(stats, false);
+}
+
+void GlGpuTimer::drain(FrameStats &stats)
+{
+    collect(stats, true);
+}
+
+void GlGpuTimer::collect(FrameStats &stats, bool wait)
+{
+    for (auto &query : fQueries) {
+        if (!query.pending) {
+            continue;
+        }
+        GLint available = GL_FALSE;
+        if (!wait) {
+            glGetQueryObjectiv(query.id, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                continue;
+            }
+        }
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(query.id, GL_QUERY_RESULT, &elapsedNs);
+        stats.setGpuTime(query.frame, elapsedNs / 1e6);
+        query.pending = false;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+
+class FrameStats;
+
+// GL_TIME_ELAPSED query 링. 결과는 몇 프레임 뒤에 polling 으로 수거하며,
+// 다음 query 가 아직 끝나지 않았으면 그 프레임은 측정을 건너뛴다 (CPU 가 블록되지 않도록).
+class GlGpuTimer
+{
+public:
+    bool init(int depth = 4);
+    void destroy();
+
+    // Skia flushAndSubmit 앞뒤로 호출
+    void begin(uint64_t frame);
+    void end();
+
+    // 완료된 query 결과를 stats 에 반영
+    void collect(FrameStats &stats);
+    // 종료 시: 남은 query 결과를 모두 기다려 반영
+    void drain(FrameStats &stats);
+
+private:
+    struct Query
+    {
+        GLuint id = 0;
+        uint64_t frame = 0;
+        bool pending = false;
+    };
+
+    void collect(FrameStats &stats, bool wait);
+
+    std::vector<Query> fQueries;
+    size_t fNext = 0;
+    bool fActive = false;
+};
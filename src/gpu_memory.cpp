@@ -0,0 +1,173 @@
+#include "gpu_memory.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "include/gpu/ganesh/GrDirectContext.h"
+
+bool parseGpuMemoryArg(const char *arg, GpuMemoryOptions &options)
+{
+    if (strncmp(arg, "--gpu-cache-mb=", 15) == 0) {
+        options.cacheLimitBytes = static_cast<size_t>(atoll(arg + 15)) << 20;
+    } else if (strncmp(arg, "--gpu-idle-purge=", 17) == 0) {
+        options.idlePurgeSeconds = atof(arg + 17);
+    } else if (strncmp(arg, "--gpu-memory-json=", 18) == 0) {
+        options.countersPath = arg + 18;
+    } else if (strncmp(arg, "--gpu-memory-interval=", 22) == 0) {
+        options.reportIntervalFrames = atoi(arg + 22);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// --- CategoryMemoryDump ---
+
+void CategoryMemoryDump::dumpNumericValue(const char *dumpName, const char *valueName, const char *, uint64_t value)
+{
+    if (strcmp(valueName, "size") == 0) {
+        fResources[dumpName].bytes = value;
+    } else if (strcmp(valueName, "purgeable_size") == 0) {
+        fResources[dumpName].purgeableBytes = value;
+    }
+}
+
+void CategoryMemoryDump::dumpStringValue(const char *dumpName, const char *valueName, const char *value)
+{
+    if (strcmp(valueName, "type") == 0) {
+        fResources[dumpName].type = value;
+    } else if (strcmp(valueName, "category") == 0) {
+        fResources[dumpName].category = value;
+    }
+}
+
+void CategoryMemoryDump::dumpWrappedState(const char *dumpName, bool isWrappedObject)
+{
+    fResources[dumpName].wrapped = isWrappedObject;
+}
+
+void CategoryMemoryDump::dumpBudgetedState(const char *dumpName, bool isBudgeted)
+{
+    fResources[dumpName].budgeted = isBudgeted;
+}
+
+void CategoryMemoryDump::aggregate()
+{
+    fCategories.clear();
+    fTypes.clear();
+    fBudgetedBytes = 0;
+    fWrappedBytes = 0;
+    for (const auto &[name, resource] : fResources) {
+        for (Usage *usage : {&fCategories[resource.category], &fTypes[resource.type]}) {
+            usage->bytes += resource.bytes;
+            usage->purgeableBytes += resource.purgeableBytes;
+            ++usage->count;
+        }
+        if (resource.budgeted) {
+            fBudgetedBytes += resource.bytes;
+        }
+        if (resource.wrapped) {
+            fWrappedBytes += resource.bytes;
+        }
+    }
+}
+
+// --- GpuMemoryManager ---
+
+GpuMemoryManager::GpuMemoryManager(GrDirectContext *context, const GpuMemoryOptions &options)
+    : fContext(context), fOptions(options)
+{
+    if (fOptions.cacheLimitBytes > 0) {
+        fContext->setResourceCacheLimit(fOptions.cacheLimitBytes);
+    }
+}
+
+void GpuMemoryManager::endFrame()
+{
+    ++fFrame;
+    if (fOptions.cleanupIntervalFrames > 0 && fFrame % fOptions.cleanupIntervalFrames == 0) {
+        auto notUsed = std::chrono::milliseconds(static_cast<int64_t>(fOptions.idlePurgeSeconds * 1000));
+        fContext->performDeferredCleanup(notUsed);
+    }
+    if (fOptions.reportIntervalFrames > 0 && fFrame % fOptions.reportIntervalFrames == 0) {
+        report();
+    }
+}
+
+void GpuMemoryManager::onIdle()
+{
+    auto notUsed = std::chrono::milliseconds(static_cast<int64_t>(fOptions.idlePurgeSeconds * 1000));
+    fContext->performDeferredCleanup(notUsed);
+    // 다음 프레임에 다시 만들 수 있는 scratch 만 버리고, 캐시된 이미지/path 등은 유지
+    fContext->purgeUnlockedResources(GrPurgeResourceOptions::kScratchResourcesOnly);
+    ++fIdlePurges;
+}
+
+void GpuMemoryManager::finish()
+{
+    report();
+}
+
+static void writeUsageMap(std::ostream &os, const std::map<std::string, CategoryMemoryDump::Usage> &usages)
+{
+    os << "{";
+    bool first = true;
+    for (const auto &[name, usage] : usages) {
+        os << (first ? "" : ", ") << "\"" << name << "\": {\"bytes\": " << usage.bytes
+           << ", \"purgeable_bytes\": " << usage.purgeableBytes << ", \"count\": " << usage.count << "}";
+        first = false;
+    }
+    os << "}";
+}
+
+void GpuMemoryManager::writeCounters(std::ostream &os) const
+{
+    int resourceCount = 0;
+    size_t usedBytes = 0;
+    fContext->getResourceCacheUsage(&resourceCount, &usedBytes);
+
+    CategoryMemoryDump dump;
+    fContext->dumpMemoryStatistics(&dump);
+    dump.aggregate();
+
+    os << "{\"frame\": " << fFrame << ", \"limit_bytes\": " << fContext->getResourceCacheLimit()
+       << ", \"used_bytes\": " << usedBytes << ", \"resource_count\": " << resourceCount
+       << ", \"purgeable_bytes\": " << fContext->getResourceCachePurgeableBytes()
+       << ", \"budgeted_bytes\": " << dump.budgetedBytes() << ", \"wrapped_bytes\": " << dump.wrappedBytes()
+       << ", \"idle_purges\": " << fIdlePurges << ", \"categories\": ";
+    writeUsageMap(os, dump.categories());
+    os << ", \"types\": ";
+    writeUsageMap(os, dump.types());
+    os << "}";
+}
+
+void GpuMemoryManager::report() const
+{
+    if (fOptions.countersPath.empty()) {
+        return;
+    }
+    if (fOptions.countersPath == "-") {
+        // 한 줄에 JSON 하나 (JSON Lines) 로 stdout 에 흘려 scrape
+        writeCounters(std::cout);
+        std::cout << std::endl;
+        return;
+    }
+    // 파일은 항상 최신 스냅샷 하나만: 임시 파일에 쓰고 rename 해 읽는 쪽이 반쯤 쓴 파일을 보지 않게
+    const std::string tmpPath = fOptions.countersPath + ".tmp";
+    {
+        std::ofstream out(tmpPath);
+        writeCounters(out);
+        out << "\n";
+        if (!out) {
+            std::cerr << "Failed to write " << tmpPath << std::endl;
+            return;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), fOptions.countersPath.c_str()) != 0) {
+        std::cerr << "Failed to write " << fOptions.countersPath << std::endl;
+    }
+}
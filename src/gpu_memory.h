@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+
+#include "include/core/SkTraceMemoryDump.h"
+
+class GrDirectContext;
+
+struct GpuMemoryOptions
+{
+    size_t cacheLimitBytes = 0;     // 0 이면 Skia 기본 budget 유지
+    double idlePurgeSeconds = 5.0;  // 이 시간 이상 쓰이지 않은 리소스는 정리 대상
+    int cleanupIntervalFrames = 120;    // idle 이 없는 루프(headless/GL)에서 주기적 정리
+    std::string countersPath;       // JSON counters 출력 ("-" 이면 stdout, 비어 있으면 출력 안 함)
+    int reportIntervalFrames = 0;   // N 프레임마다 counters 출력, 0 이면 종료 시에만
+};
+
+// --gpu-cache-mb=N, --gpu-idle-purge=SEC, --gpu-memory-json=FILE|-, --gpu-memory-interval=N 을 처리하면 true
+bool parseGpuMemoryArg(const char *arg, GpuMemoryOptions &options);
+
+// SkTraceMemoryDump 로 받은 리소스별 값을 category / type 별로 합산
+class CategoryMemoryDump : public SkTraceMemoryDump
+{
+public:
+    struct Usage
+    {
+        uint64_t bytes = 0;
+        uint64_t purgeableBytes = 0;
+        int count = 0;
+    };
+
+    void dumpNumericValue(const char *dumpName, const char *valueName, const char *units, uint64_t value) override;
+    void dumpStringValue(const char *dumpName, const char *valueName, const char *value) override;
+    void setMemoryBacking(const char *, const char *, const char *) override {}
+    void setDiscardableMemoryBacking(const char *, const SkDiscardableMemory &) override {}
+    LevelOfDetail getRequestedDetails() const override { return kObjectsBreakdowns_LevelOfDetail; }
+    void dumpWrappedState(const char *dumpName, bool isWrappedObject) override;
+    void dumpBudgetedState(const char *dumpName, bool isBudgeted) override;
+
+    // dump 가 끝난 뒤 호출: 리소스별 값을 합산
+    void aggregate();
+
+    const std::map<std::string, Usage> &categories() const { return fCategories; }
+    const std::map<std::string, Usage> &types() const { return fTypes; }
+    uint64_t budgetedBytes() const { return fBudgetedBytes; }
+    uint64_t wrappedBytes() const { return fWrappedBytes; }
+
+private:
+    struct Resource
+    {
+        uint64_t bytes = 0;
+        uint64_t purgeableBytes = 0;
+        std::string type = "unknown";
+        std::string category = "unknown";
+        bool budgeted = true;
+        bool wrapped = false;
+    };
+
+    std::map<std::string, Resource> fResources;
+    std::map<std::string, Usage> fCategories;
+    std::map<std::string, Usage> fTypes;
+    uint64_t fBudgetedBytes = 0;
+    uint64_t fWrappedBytes = 0;
+};
+
+// GrDirectContext 의 리소스 캐시 budget 설정, idle/주기적 정리, 사용량 counters(JSON) 출력
+class GpuMemoryManager
+{
+public:
+    GpuMemoryManager(GrDirectContext *context, const GpuMemoryOptions &options);
+
+    // 매 프레임 끝에 호출
+    void endFrame();
+    // 렌더 루프가 이벤트를 기다리기 직전에 호출: 오래된 리소스와 unlocked scratch 리소스 정리
+    void onIdle();
+    // 종료 시 호출: 마지막 counters 출력
+    void finish();
+
+    void writeCounters(std::ostream &os) const;
+
+private:
+    void report() const;
+
+    GrDirectContext *fContext;
+    GpuMemoryOptions fOptions;
+    uint64_t fFrame = 0;
+    int fIdlePurges = 0;
+};
@@ -0,0 +1,189 @@
+#include "gpu_readback.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkYUVAInfo.h"
+#include "include/gpu/ganesh/GrDirectContext.h"
+
+namespace {
+
+SkISize chromaSize(SkISize size)
+{
+    return {(size.width() + 1) / 2, (size.height() + 1) / 2};
+}
+
+// AsyncReadResult 의 plane 을 rowBytes 없이 빽빽하게 dst 로 복사
+uint8_t *copyPlane(const SkSurface::AsyncReadResult &result, int plane, size_t rowSize, int rows, uint8_t *dst)
+{
+    const uint8_t *src = static_cast<const uint8_t *>(result.data(plane));
+    const size_t srcRowBytes = result.rowBytes(plane);
+    for (int y = 0; y < rows; ++y) {
+        memcpy(dst, src + y * srcRowBytes, rowSize);
+        dst += rowSize;
+    }
+    return dst;
+}
+
+} // namespace
+
+AsyncReadbackRing::AsyncReadbackRing(const ReadbackOptions &options) : fOptions(options)
+{
+    fOptions.slots = std::max(1, fOptions.slots);
+}
+
+AsyncReadbackRing::~AsyncReadbackRing()
+{
+    // 콜백이 슬롯 포인터를 갖고 있으므로 파괴 전에 drain() 해야 한다
+    SkASSERT(fInFlight.empty());
+}
+
+void AsyncReadbackRing::allocate(SkISize size)
+{
+    fSize = size;
+    size_t bytes = static_cast<size_t>(size.width()) * size.height();
+    if (fOptions.format == ReadbackFormat::kRGBA) {
+        bytes *= 4;
+    } else {
+        SkISize uv = chromaSize(size);
+        bytes += 2 * static_cast<size_t>(uv.width()) * uv.height();
+    }
+    fSlotBytes = bytes;
+    fSlots.clear();
+    for (int i = 0; i < fOptions.slots; ++i) {
+        auto slot = std::make_unique<Slot>();
+        slot->owner = this;
+        slot->pixels.resize(bytes);
+        fSlots.push_back(std::move(slot));
+    }
+}
+
+bool AsyncReadbackRing::request(SkSurface *surface, uint64_t frame)
+{
+    const SkISize srcSize = {surface->width(), surface->height()};
+    const SkISize dstSize = fOptions.size.isEmpty() ? srcSize : fOptions.size;
+    if (dstSize != fSize) {
+        // surface 크기가 바뀌면 진행 중인 요청이 끝난 뒤에 버퍼를 다시 할당
+        if (!fInFlight.empty()) {
+            ++fDropped;
+            return false;
+        }
+        allocate(dstSize);
+    }
+
+    auto it = std::find_if(fSlots.begin(), fSlots.end(),
+                           [](const std::unique_ptr<Slot> &slot) { return slot->state == SlotState::kFree; });
+    if (it == fSlots.end()) {
+        ++fDropped;
+        return false;
+    }
+    Slot *slot = it->get();
+    // consumer 가 버퍼를 swap 해 갔을 수 있으므로 크기를 다시 맞춘다 (같은 크기면 할당 없음)
+    slot->pixels.resize(fSlotBytes);
+    slot->state = SlotState::kPending;
+    slot->frame = frame;
+    fInFlight.push_back(slot);
+    ++fRequested;
+
+    const SkIRect srcRect = SkIRect::MakeSize(srcSize);
+    const SkSurface::RescaleMode mode =
+            dstSize == srcSize ? SkSurface::RescaleMode::kNearest : SkSurface::RescaleMode::kRepeatedLinear;
+    if (fOptions.format == ReadbackFormat::kRGBA) {
+        SkImageInfo info = SkImageInfo::Make(dstSize, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType,
+                                             surface->imageInfo().refColorSpace());
+        surface->asyncRescaleAndReadPixels(info, srcRect, SkSurface::RescaleGamma::kSrc, mode, &readbackCallback,
+                                           slot);
+    } else {
+        surface->asyncRescaleAndReadPixelsYUV420(kRec709_Limited_SkYUVColorSpace, SkColorSpace::MakeSRGB(), srcRect,
+                                                 dstSize, SkSurface::RescaleGamma::kSrc, mode, &readbackCallback,
+                                                 slot);
+    }
+    return true;
+}
+
+void AsyncReadbackRing::readbackCallback(SkSurface::ReadPixelsContext context,
+                                         std::unique_ptr<const SkSurface::AsyncReadResult> result)
+{
+    Slot *slot = static_cast<Slot *>(context);
+    if (!result) {
+        slot->state = SlotState::kFailed;
+        return;
+    }
+
+    // result 가 잡고 있는 Skia transfer buffer 는 바로 돌려주고 우리 슬롯 버퍼에 보관
+    const SkISize size = slot->owner->fSize;
+    uint8_t *dst = slot->pixels.data();
+    if (slot->owner->fOptions.format == ReadbackFormat::kRGBA) {
+        copyPlane(*result, 0, static_cast<size_t>(size.width()) * 4, size.height(), dst);
+    } else {
+        const SkISize uv = chromaSize(size);
+        dst = copyPlane(*result, 0, size.width(), size.height(), dst);
+        dst = copyPlane(*result, 1, uv.width(), uv.height(), dst);
+        copyPlane(*result, 2, uv.width(), uv.height(), dst);
+    }
+    slot->state = SlotState::kReady;
+}
+
+void AsyncReadbackRing::fillFrame(Slot &slot, ReadbackFrame *frame) const
+{
+    frame->frame = slot.frame;
+    frame->format = fOptions.format;
+    frame->storage = &slot.pixels;
+    const uint8_t *pixels = slot.pixels.data();
+    if (fOptions.format == ReadbackFormat::kRGBA) {
+        SkImageInfo info = SkImageInfo::Make(fSize, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType);
+        frame->rgba = SkPixmap(info, pixels, info.minRowBytes());
+        return;
+    }
+    const SkISize uv = chromaSize(fSize);
+    SkImageInfo yInfo = SkImageInfo::Make(fSize, kGray_8_SkColorType, kOpaque_SkAlphaType);
+    SkImageInfo uvInfo = SkImageInfo::Make(uv, kGray_8_SkColorType, kOpaque_SkAlphaType);
+    frame->planes[0] = SkPixmap(yInfo, pixels, yInfo.minRowBytes());
+    pixels += yInfo.computeMinByteSize();
+    frame->planes[1] = SkPixmap(uvInfo, pixels, uvInfo.minRowBytes());
+    pixels += uvInfo.computeMinByteSize();
+    frame->planes[2] = SkPixmap(uvInfo, pixels, uvInfo.minRowBytes());
+}
+
+int AsyncReadbackRing::poll(GrDirectContext *context, const Consumer &consumer)
+{
+    // 완료된 GPU 작업의 콜백을 이 스레드에서 실행
+    context->checkAsyncWorkCompletion();
+
+    int delivered = 0;
+    while (!fInFlight.empty() && fInFlight.front()->state != SlotState::kPending) {
+        Slot *slot = fInFlight.front();
+        fInFlight.pop_front();
+        if (slot->state == SlotState::kReady) {
+            ReadbackFrame frame;
+            fillFrame(*slot, &frame);
+            if (consumer) {
+                consumer(frame);
+            }
+            ++fCompleted;
+            ++delivered;
+        } else {
+            std::cerr << "Readback failed for frame " << slot->frame << std::endl;
+            ++fFailed;
+        }
+        slot->state = SlotState::kFree;
+    }
+    return delivered;
+}
+
+void AsyncReadbackRing::drain(GrDirectContext *context, const Consumer &consumer)
+{
+    if (fInFlight.empty()) {
+        return;
+    }
+    context->flushAndSubmit(GrSyncCpu::kYes);
+    poll(context, consumer);
+    // 동기 submit 이후에도 남았다면 Skia 가 콜백을 주지 않은 것: 실패로 정리
+    for (Slot *slot : fInFlight) {
+        slot->state = SlotState::kFree;
+        ++fFailed;
+    }
+    fInFlight.clear();
+}
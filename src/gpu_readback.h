@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkSize.h"
+#include "include/core/SkSurface.h"
+
+class GrDirectContext;
+
+enum class ReadbackFormat
+{
+    kRGBA,      // RGBA8 unpremul
+    kYUV420,    // I420 (Y, U, V plane, BT.709 limited), 인코더/스트리밍용
+};
+
+struct ReadbackOptions
+{
+    ReadbackFormat format = ReadbackFormat::kRGBA;
+    int slots = 3;              // 동시에 진행 중일 수 있는 readback 수
+    SkISize size = {0, 0};      // 0 이면 surface 크기 그대로, 아니면 GPU 에서 rescale
+};
+
+struct ReadbackFrame
+{
+    uint64_t frame = 0;
+    ReadbackFormat format = ReadbackFormat::kRGBA;
+    SkPixmap rgba;              // kRGBA
+    SkPixmap planes[3];         // kYUV420: Y, U, V (kGray_8)
+    // pixmap 들이 가리키는 슬롯 버퍼 (빽빽한 RGBA 또는 Y|U|V). consumer 가 다른 vector 와 swap 해
+    // 복사 없이 가져갈 수 있다. 그 뒤로는 pixmap 을 쓰면 안 되고, ring 은 다음 request 때 크기를 다시 맞춘다
+    std::vector<uint8_t> *storage = nullptr;
+};
+
+// SkSurface::asyncRescaleAndReadPixels(YUV420) 기반 비동기 캡처.
+// 결과는 GrDirectContext::checkAsyncWorkCompletion() 을 부르는 스레드(= 렌더 스레드)의 콜백에서
+// 미리 할당한 슬롯 버퍼로 복사되고, poll() 이 요청 순서대로 consumer 에 넘긴다.
+// 슬롯이 모두 사용 중이면 request() 는 그 프레임을 건너뛰므로 렌더링이 readback 을 기다리지 않는다.
+class AsyncReadbackRing
+{
+public:
+    using Consumer = std::function<void(const ReadbackFrame &)>;
+
+    explicit AsyncReadbackRing(const ReadbackOptions &options);
+    ~AsyncReadbackRing();
+
+    AsyncReadbackRing(const AsyncReadbackRing &) = delete;
+    AsyncReadbackRing &operator=(const AsyncReadbackRing &) = delete;
+
+    // 그리기 후, flush/submit 전에 호출해야 같은 submit 에 전송 명령이 실린다
+    bool request(SkSurface *surface, uint64_t frame);
+
+    // 완료된 readback 을 consumer 에 전달 (pixmap 과 storage 는 consumer 안에서만 유효). 전달한 수 반환
+    int poll(GrDirectContext *context, const Consumer &consumer);
+    // 남은 요청이 모두 끝날 때까지 대기 (종료 시)
+    void drain(GrDirectContext *context, const Consumer &consumer);
+
+    uint64_t requested() const { return fRequested; }
+    uint64_t completed() const { return fCompleted; }
+    uint64_t dropped() const { return fDropped; }
+    uint64_t failed() const { return fFailed; }
+
+private:
+    enum class SlotState
+    {
+        kFree,
+        kPending,
+        kReady,
+        kFailed,
+    };
+
+    struct Slot
+    {
+        AsyncReadbackRing *owner = nullptr;
+        SlotState state = SlotState::kFree;
+        uint64_t frame = 0;
+        std::vector<uint8_t> pixels;    // RGBA 또는 Y|U|V 를 이어서 저장
+    };
+
+    static void readbackCallback(SkSurface::ReadPixelsContext context,
+                                 std::unique_ptr<const SkSurface::AsyncReadResult> result);
+    void allocate(SkISize size);
+    void fillFrame(Slot &slot, ReadbackFrame *frame) const;
+
+    ReadbackOptions fOptions;
+    SkISize fSize = {0, 0};
+    size_t fSlotBytes = 0;
+    std::vector<std::unique_ptr<Slot>> fSlots;
+    std::deque<Slot *> fInFlight;   // 요청 순서
+    uint64_t fRequested = 0;
+    uint64_t fCompleted = 0;
+    uint64_t fDropped = 0;
+    uint64_t fFailed = 0;
+};
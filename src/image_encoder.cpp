@@ -0,0 +1,493 @@
+#include "image_encoder.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <zlib.h>
+
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkStream.h"
+
+#include "thread_pool.h"
+
+namespace {
+
+constexpr size_t kDeflateWindow = 32768;
+
+struct PngParams
+{
+    int level;
+    int strategy;
+    bool adaptiveFilter;
+    bool useDictionary;
+};
+
+PngParams pngParams(EncodePreset preset)
+{
+    switch (preset) {
+    case EncodePreset::kFastest:
+        return {1, Z_DEFAULT_STRATEGY, false, false};
+    case EncodePreset::kBalanced:
+        return {6, Z_FILTERED, true, true};
+    case EncodePreset::kSmallest:
+        return {9, Z_FILTERED, true, true};
+    }
+    return {6, Z_FILTERED, true, true};
+}
+
+void putBE32(uint8_t *p, uint32_t v)
+{
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+bool writePngChunk(SkWStream *stream, const char type[4], const uint8_t *data, size_t size)
+{
+    uint8_t header[8];
+    putBE32(header, static_cast<uint32_t>(size));
+    memcpy(header + 4, type, 4);
+    uLong crc = crc32(0, reinterpret_cast<const Bytef *>(type), 4);
+    if (size > 0) {
+        crc = crc32_z(crc, data, size);
+    }
+    uint8_t trailer[4];
+    putBE32(trailer, static_cast<uint32_t>(crc));
+    return stream->write(header, sizeof(header)) && (size == 0 || stream->write(data, size)) &&
+           stream->write(trailer, sizeof(trailer));
+}
+
+// src 의 [y, y + rows) 를 RGBA8 unpremul 로 변환 (PNG/QOI 는 unpremul 을 저장)
+bool convertRows(const SkPixmap &src, int y, int rows, uint8_t *dst)
+{
+    SkImageInfo dstInfo = SkImageInfo::Make(src.width(), rows, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType);
+    return src.readPixels(dstInfo, dst, dstInfo.minRowBytes(), 0, y);
+}
+
+// --- PNG 필터 (bpp = 4) ---
+
+uint8_t paeth(int a, int b, int c)
+{
+    int p = a + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return static_cast<uint8_t>(a);
+    }
+    return static_cast<uint8_t>(pb <= pc ? b : c);
+}
+
+void filterRow(int type, const uint8_t *cur, const uint8_t *prev, size_t len, uint8_t *out)
+{
+    constexpr size_t bpp = 4;
+    for (size_t i = 0; i < len; ++i) {
+        int a = i >= bpp ? cur[i - bpp] : 0;
+        int b = prev[i];
+        int c = i >= bpp ? prev[i - bpp] : 0;
+        int predicted = 0;
+        switch (type) {
+        case 1: predicted = a; break;
+        case 2: predicted = b; break;
+        case 3: predicted = (a + b) >> 1; break;
+        case 4: predicted = paeth(a, b, c); break;
+        default: break;
+        }
+        out[i] = static_cast<uint8_t>(cur[i] - predicted);
+    }
+}
+
+uint64_t filterCost(const uint8_t *row, size_t len)
+{
+    uint64_t sum = 0;
+    for (size_t i = 0; i < len; ++i) {
+        sum += static_cast<uint64_t>(std::abs(static_cast<int8_t>(row[i])));
+    }
+    return sum;
+}
+
+// 변환된 행 하나를 필터 바이트 + 필터링된 데이터로 out 에 쓴다
+void filterScanline(const uint8_t *cur, const uint8_t *prev, size_t len, bool adaptive, std::vector<uint8_t> &scratch,
+                    uint8_t *out)
+{
+    if (!adaptive) {
+        out[0] = 2;     // Up
+        filterRow(2, cur, prev, len, out + 1);
+        return;
+    }
+    scratch.resize(len);
+    uint64_t bestCost = UINT64_MAX;
+    for (int type = 0; type < 5; ++type) {
+        filterRow(type, cur, prev, len, scratch.data());
+        uint64_t cost = filterCost(scratch.data(), len);
+        if (cost < bestCost) {
+            bestCost = cost;
+            out[0] = static_cast<uint8_t>(type);
+            memcpy(out + 1, scratch.data(), len);
+        }
+    }
+}
+
+// raw deflate. 마지막 strip 이 아니면 sync flush 로 byte 경계에서 끝내 다음 strip 을 이어 붙일 수 있게 한다
+bool deflateStrip(const uint8_t *in, size_t size, const uint8_t *dict, size_t dictSize, const PngParams &params,
+                  bool last, std::vector<uint8_t> &out)
+{
+    z_stream zs{};
+    if (deflateInit2(&zs, params.level, Z_DEFLATED, -15, 8, params.strategy) != Z_OK) {
+        return false;
+    }
+    if (dictSize > 0 && deflateSetDictionary(&zs, dict, static_cast<uInt>(dictSize)) != Z_OK) {
+        deflateEnd(&zs);
+        return false;
+    }
+
+    const size_t prefix = out.size();
+    out.resize(prefix + deflateBound(&zs, static_cast<uLong>(size)) + 64);
+    zs.next_in = const_cast<Bytef *>(in);
+    zs.avail_in = static_cast<uInt>(size);
+    zs.next_out = out.data() + prefix;
+    zs.avail_out = static_cast<uInt>(out.size() - prefix);
+
+    const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+    bool ok = true;
+    while (true) {
+        int ret = deflate(&zs, flush);
+        if (ret == Z_STREAM_END) {
+            break;
+        }
+        if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            ok = false;
+            break;
+        }
+        if (!last && zs.avail_in == 0 && zs.avail_out > 0) {
+            break;
+        }
+        size_t used = out.size() - zs.avail_out;
+        out.resize(out.size() * 2);
+        zs.next_out = out.data() + used;
+        zs.avail_out = static_cast<uInt>(out.size() - used);
+    }
+    out.resize(out.size() - zs.avail_out);
+    deflateEnd(&zs);
+    return ok;
+}
+
+// strip 하나의 작업 버퍼와 결과. ImageEncoder 가 호출 사이에 유지하므로 크기만 맞추고 다시 할당하지 않는다
+struct PngStrip
+{
+    std::vector<uint8_t> rgba;      // 변환된 행 (필터용 앞 행 + dictionary 행 포함)
+    std::vector<uint8_t> zeroRow;   // 첫 행의 prev
+    std::vector<uint8_t> filtered;
+    std::vector<uint8_t> scratch;   // adaptive 필터 후보
+    std::vector<uint8_t> data;      // 압축된 데이터 (strip 0 은 zlib header 포함)
+    uLong adler = 1;
+    size_t rawSize = 0;
+    bool ok = false;
+    bool done = false;
+};
+
+void encodePngStrip(const SkPixmap &pixmap, const PngParams &params, int stripRows, int stripCount, int index,
+                    PngStrip &strip)
+{
+    strip.data.clear();
+
+    const int width = pixmap.width();
+    const int height = pixmap.height();
+    const size_t rowSize = static_cast<size_t>(width) * 4;
+    const size_t lineSize = rowSize + 1;
+
+    const int y0 = index * stripRows;
+    const int y1 = std::min(height, y0 + stripRows);
+    // dictionary 로 쓸 앞 strip 의 꼬리도 직접 필터링한다 (필터 결과는 원본만으로 결정되므로 strip 간 의존 없음)
+    int dictRows = 0;
+    if (params.useDictionary && y0 > 0) {
+        dictRows = std::min<int>(y0, static_cast<int>((kDeflateWindow + lineSize - 1) / lineSize));
+    }
+    const int firstRow = y0 - dictRows;
+    const int convertRow = std::max(0, firstRow - 1);
+
+    strip.rgba.resize(static_cast<size_t>(y1 - convertRow) * rowSize);
+    if (!convertRows(pixmap, convertRow, y1 - convertRow, strip.rgba.data())) {
+        return;
+    }
+    if (firstRow == 0) {
+        strip.zeroRow.assign(rowSize, 0);
+    }
+
+    strip.filtered.resize(static_cast<size_t>(y1 - firstRow) * lineSize);
+    for (int y = firstRow; y < y1; ++y) {
+        const uint8_t *cur = strip.rgba.data() + static_cast<size_t>(y - convertRow) * rowSize;
+        const uint8_t *prev = y > 0 ? cur - rowSize : strip.zeroRow.data();
+        filterScanline(cur, prev, rowSize, params.adaptiveFilter, strip.scratch,
+                       strip.filtered.data() + static_cast<size_t>(y - firstRow) * lineSize);
+    }
+
+    const size_t dictBytes = static_cast<size_t>(dictRows) * lineSize;
+    const size_t dictSize = std::min(dictBytes, kDeflateWindow);
+    const uint8_t *input = strip.filtered.data() + dictBytes;
+    strip.rawSize = static_cast<size_t>(y1 - y0) * lineSize;
+    strip.adler = adler32_z(adler32(0, Z_NULL, 0), input, strip.rawSize);
+
+    if (index == 0) {
+        // CMF = deflate/32K window, FLG 의 FLEVEL 은 정보용
+        uint8_t flg = params.level <= 1 ? 0x01 : (params.level >= 9 ? 0xDA : 0x9C);
+        strip.data.assign({0x78, flg});
+    }
+    strip.ok = deflateStrip(input, strip.rawSize, input - dictSize, dictSize, params, index == stripCount - 1,
+                            strip.data);
+}
+
+bool encodePng(const SkPixmap &pixmap, const EncodeOptions &options, ThreadPool *pool, SkWStream *stream,
+               std::vector<PngStrip> &strips)
+{
+    const PngParams params = pngParams(options.preset);
+    const int width = pixmap.width();
+    const int height = pixmap.height();
+
+    int stripRows = options.stripRows;
+    if (stripRows <= 0) {
+        // 스레드당 4개 정도로 나눠 부하를 고르게, 단 strip 이 너무 작으면 경계 비용이 커진다
+        int threads = pool ? pool->threadCount() : 1;
+        stripRows = std::max(16, (height + threads * 4 - 1) / (threads * 4));
+    }
+    const int stripCount = (height + stripRows - 1) / stripRows;
+
+    static const uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    uint8_t ihdr[13];
+    putBE32(ihdr, static_cast<uint32_t>(width));
+    putBE32(ihdr + 4, static_cast<uint32_t>(height));
+    ihdr[8] = 8;    // bit depth
+    ihdr[9] = 6;    // RGBA
+    ihdr[10] = 0;   // deflate
+    ihdr[11] = 0;   // adaptive filtering
+    ihdr[12] = 0;   // no interlace
+    if (!stream->write(kSignature, sizeof(kSignature)) || !writePngChunk(stream, "IHDR", ihdr, sizeof(ihdr))) {
+        return false;
+    }
+
+    if (strips.size() < static_cast<size_t>(stripCount)) {
+        strips.resize(stripCount);
+    }
+    for (int i = 0; i < stripCount; ++i) {
+        strips[i].ok = false;
+        strips[i].done = false;
+    }
+    std::mutex mutex;
+    std::condition_variable doneCv;
+    if (pool) {
+        for (int i = 0; i < stripCount; ++i) {
+            pool->submit([&, i] {
+                encodePngStrip(pixmap, params, stripRows, stripCount, i, strips[i]);
+                std::lock_guard<std::mutex> lock(mutex);
+                strips[i].done = true;
+                doneCv.notify_all();
+            });
+        }
+    }
+
+    // 압축이 끝난 strip 부터 순서대로 IDAT 로 내보낸다 (쓰기와 나머지 strip 압축이 겹침)
+    bool ok = true;
+    uLong adler = adler32(0, Z_NULL, 0);
+    for (int i = 0; i < stripCount; ++i) {
+        PngStrip &strip = strips[i];
+        if (pool) {
+            std::unique_lock<std::mutex> lock(mutex);
+            doneCv.wait(lock, [&strip] { return strip.done; });
+        } else {
+            encodePngStrip(pixmap, params, stripRows, stripCount, i, strip);
+        }
+        if (!ok) {
+            continue;   // 남은 작업이 strips 를 참조하므로 끝까지 기다린다
+        }
+        if (!strip.ok) {
+            std::cerr << "Failed to compress PNG strip " << i << std::endl;
+            ok = false;
+            continue;
+        }
+        adler = adler32_combine(adler, strip.adler, static_cast<z_off_t>(strip.rawSize));
+        if (i == stripCount - 1) {
+            uint8_t trailer[4];
+            putBE32(trailer, static_cast<uint32_t>(adler));
+            strip.data.insert(strip.data.end(), trailer, trailer + 4);
+        }
+        ok = writePngChunk(stream, "IDAT", strip.data.data(), strip.data.size());
+    }
+    return ok && writePngChunk(stream, "IEND", nullptr, 0);
+}
+
+// --- QOI (https://qoiformat.org/qoi-specification.pdf) ---
+
+bool encodeQoi(const SkPixmap &pixmap, ThreadPool *pool, SkWStream *stream, std::vector<uint8_t> &rgba,
+               std::vector<uint8_t> &out)
+{
+    const int width = pixmap.width();
+    const int height = pixmap.height();
+    const size_t rowSize = static_cast<size_t>(width) * 4;
+    rgba.resize(rowSize * height);
+
+    // 변환만 병렬로, 인코딩은 앞 픽셀에 의존하므로 순차
+    constexpr int kConvertRows = 64;
+    const int blocks = (height + kConvertRows - 1) / kConvertRows;
+    std::vector<char> converted(blocks, 0);
+    auto convertBlock = [&](int i) {
+        int y = i * kConvertRows;
+        int rows = std::min(kConvertRows, height - y);
+        converted[i] = convertRows(pixmap, y, rows, rgba.data() + y * rowSize);
+    };
+    if (pool) {
+        pool->parallelFor(blocks, convertBlock);
+    } else {
+        for (int i = 0; i < blocks; ++i) {
+            convertBlock(i);
+        }
+    }
+    if (std::find(converted.begin(), converted.end(), 0) != converted.end()) {
+        return false;
+    }
+
+    out.clear();
+    out.reserve(1 << 16);
+    bool ok = true;
+    auto flushOut = [&](bool force) {
+        if (out.size() >= (1 << 16) || (force && !out.empty())) {
+            ok = ok && stream->write(out.data(), out.size());
+            out.clear();
+        }
+    };
+
+    uint8_t header[14] = {'q', 'o', 'i', 'f'};
+    putBE32(header + 4, static_cast<uint32_t>(width));
+    putBE32(header + 8, static_cast<uint32_t>(height));
+    header[12] = 4;     // RGBA
+    header[13] = 0;     // sRGB + linear alpha
+    out.insert(out.end(), header, header + sizeof(header));
+
+    uint8_t index[64][4] = {};
+    uint8_t prev[4] = {0, 0, 0, 255};
+    int run = 0;
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        const uint8_t *px = rgba.data() + i * 4;
+        if (memcmp(px, prev, 4) == 0) {
+            ++run;
+            if (run == 62 || i == pixelCount - 1) {
+                out.push_back(static_cast<uint8_t>(0xC0 | (run - 1)));
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0) {
+            out.push_back(static_cast<uint8_t>(0xC0 | (run - 1)));
+            run = 0;
+        }
+
+        int hash = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+        if (memcmp(index[hash], px, 4) == 0) {
+            out.push_back(static_cast<uint8_t>(hash));
+        } else {
+            memcpy(index[hash], px, 4);
+            if (px[3] == prev[3]) {
+                int dr = static_cast<int8_t>(px[0] - prev[0]);
+                int dg = static_cast<int8_t>(px[1] - prev[1]);
+                int db = static_cast<int8_t>(px[2] - prev[2]);
+                int drg = dr - dg;
+                int dbg = db - dg;
+                if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                    out.push_back(static_cast<uint8_t>(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+                } else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                    out.push_back(static_cast<uint8_t>(0x80 | (dg + 32)));
+                    out.push_back(static_cast<uint8_t>((drg + 8) << 4 | (dbg + 8)));
+                } else {
+                    out.insert(out.end(), {0xFE, px[0], px[1], px[2]});
+                }
+            } else {
+                out.insert(out.end(), {0xFF, px[0], px[1], px[2], px[3]});
+            }
+        }
+        memcpy(prev, px, 4);
+        flushOut(false);
+    }
+    out.insert(out.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+    flushOut(true);
+    return ok;
+}
+
+} // namespace
+
+struct ImageEncoder::Scratch
+{
+    std::vector<PngStrip> strips;
+    std::vector<uint8_t> qoiRgba;
+    std::vector<uint8_t> qoiOut;
+};
+
+ImageEncoder::ImageEncoder() : fScratch(std::make_unique<Scratch>()) {}
+
+ImageEncoder::~ImageEncoder() = default;
+
+bool ImageEncoder::encode(const SkPixmap &pixmap, const EncodeOptions &options, ThreadPool *pool, SkWStream *stream)
+{
+    if (!pixmap.addr() || pixmap.width() <= 0 || pixmap.height() <= 0) {
+        std::cerr << "Cannot encode empty pixmap" << std::endl;
+        return false;
+    }
+    if (options.format == EncodeFormat::kQoi) {
+        return encodeQoi(pixmap, pool, stream, fScratch->qoiRgba, fScratch->qoiOut);
+    }
+    return encodePng(pixmap, options, pool, stream, fScratch->strips);
+}
+
+const char *encodeFormatName(EncodeFormat format)
+{
+    return format == EncodeFormat::kQoi ? "qoi" : "png";
+}
+
+const char *encodePresetName(EncodePreset preset)
+{
+    switch (preset) {
+    case EncodePreset::kFastest: return "fastest";
+    case EncodePreset::kBalanced: return "balanced";
+    case EncodePreset::kSmallest: return "smallest";
+    }
+    return "balanced";
+}
+
+bool parseEncodeFormat(const std::string &name, EncodeFormat *format)
+{
+    if (name == "png") {
+        *format = EncodeFormat::kPng;
+    } else if (name == "qoi") {
+        *format = EncodeFormat::kQoi;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseEncodePreset(const std::string &name, EncodePreset *preset)
+{
+    if (name == "fastest") {
+        *preset = EncodePreset::kFastest;
+    } else if (name == "balanced") {
+        *preset = EncodePreset::kBalanced;
+    } else if (name == "smallest") {
+        *preset = EncodePreset::kSmallest;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool encodeImage(const SkPixmap &pixmap, const EncodeOptions &options, ThreadPool *pool, SkWStream *stream)
+{
+    ImageEncoder encoder;
+    return encoder.encode(pixmap, options, pool, stream);
+}
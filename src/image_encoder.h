@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+class SkPixmap;
+class SkWStream;
+class ThreadPool;
+
+enum class EncodeFormat
+{
+    kPng,
+    kQoi,   // 빠른 무손실 포맷 (중간 프레임 덤프용)
+};
+
+// PNG 속도/크기 trade-off
+//  kFastest : Up 필터 고정 + zlib level 1, strip 끼리 독립 압축
+//  kBalanced: 행마다 5개 필터 중 선택 (minimum sum of absolute differences) + level 6
+//  kSmallest: balanced 필터 + level 9
+// balanced/smallest 는 이전 strip 의 마지막 32KB 를 dictionary 로 써서 경계 손실을 줄인다 (pigz 방식)
+enum class EncodePreset
+{
+    kFastest,
+    kBalanced,
+    kSmallest,
+};
+
+struct EncodeOptions
+{
+    EncodeFormat format = EncodeFormat::kPng;
+    EncodePreset preset = EncodePreset::kBalanced;
+    int stripRows = 0;  // 0 이면 이미지 높이와 스레드 수로 결정
+};
+
+const char *encodeFormatName(EncodeFormat format);
+const char *encodePresetName(EncodePreset preset);
+// "png"/"qoi", "fastest"/"balanced"/"smallest" 를 파싱. 모르는 이름이면 false
+bool parseEncodeFormat(const std::string &name, EncodeFormat *format);
+bool parseEncodePreset(const std::string &name, EncodePreset *preset);
+
+// pixmap 을 RGBA8 unpremul 로 변환해 stream 에 쓴다.
+// PNG 는 row strip 을 pool 에서 병렬로 필터링/압축한 뒤 하나의 zlib stream 으로 이어 붙인다.
+// pool 이 nullptr 이면 호출 스레드에서 순차 처리. QOI 는 항상 순차.
+// 변환/필터/압축 버퍼는 encoder 가 들고 있다가 다음 호출에 재사용하므로, 같은 크기 프레임을 이어서
+// 인코딩하면 두 번째 프레임부터는 할당이 없다. 한 번에 한 스레드에서만 encode() 할 것.
+class ImageEncoder
+{
+public:
+    ImageEncoder();
+    ~ImageEncoder();
+
+    ImageEncoder(const ImageEncoder &) = delete;
+    ImageEncoder &operator=(const ImageEncoder &) = delete;
+
+    bool encode(const SkPixmap &pixmap, const EncodeOptions &options, ThreadPool *pool, SkWStream *stream);
+
+private:
+    struct Scratch;
+    std::unique_ptr<Scratch> fScratch;
+};
+
+// 한 장만 인코딩할 때 (매번 버퍼를 새로 할당)
+bool encodeImage(const SkPixmap &pixmap, const EncodeOptions &options, ThreadPool *pool, SkWStream *stream);
@@ -0,0 +1,205 @@
+#include "image_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "include/codec/SkCodec.h"
+#include "include/codec/SkJpegDecoder.h"
+#include "include/codec/SkPngDecoder.h"
+#include "include/core/SkData.h"
+#include "include/core/SkPixmap.h"
+#include "include/gpu/ganesh/GrDirectContext.h"
+#include "include/gpu/ganesh/SkImageGanesh.h"
+
+#include "vk_context.h"
+
+ImageManager::ImageManager(GrDirectContext *context, const VulkanContext *vkCtx, const ImageManagerOptions &options)
+    : fContext(context)
+    , fOptions(options)
+{
+    if (vkCtx && options.transferQueue) {
+        fUploader = VkImageUploader::Make(*vkCtx, &fPool);
+    }
+    fDecoders.reset(new ThreadPool(options.decodeThreads));
+}
+
+ImageManager::~ImageManager()
+{
+    // decode 가 fDecoded / fUploader 에 넣는 중일 수 있으므로 먼저 끝낸다
+    fDecoders.reset();
+    fUploader.reset();
+}
+
+int ImageManager::load(const std::string &path)
+{
+    int id = static_cast<int>(fEntries.size());
+    fEntries.push_back({path});
+    ++fPending;
+    fDecoders->submit([this, id, path] { decode(id, path); });
+    return id;
+}
+
+sk_sp<SkImage> ImageManager::image(int handle) const
+{
+    if (handle < 0 || handle >= static_cast<int>(fEntries.size())) {
+        return nullptr;
+    }
+    return fEntries[handle].image;
+}
+
+bool ImageManager::failed(int handle) const
+{
+    return handle >= 0 && handle < static_cast<int>(fEntries.size()) && fEntries[handle].failed;
+}
+
+void ImageManager::decode(int id, const std::string &path)
+{
+    auto start = std::chrono::steady_clock::now();
+    DecodedImage decoded;
+    decoded.id = id;
+
+    const SkCodecs::Decoder decoders[] = {SkPngDecoder::Decoder(), SkJpegDecoder::Decoder()};
+    sk_sp<SkData> data = SkData::MakeFromFileName(path.c_str());
+    std::unique_ptr<SkCodec> codec = data ? SkCodec::MakeFromData(data, decoders) : nullptr;
+    if (!codec) {
+        std::cerr << "Failed to open image: " << path << std::endl;
+        decoded.failed = true;
+    } else {
+        // VkImageUploader 의 텍스처 포맷(R8G8B8A8) 에 맞춘다. 색공간 변환은 하지 않음
+        decoded.info = codec->getInfo()
+                               .makeColorType(kRGBA_8888_SkColorType)
+                               .makeAlphaType(kPremul_SkAlphaType)
+                               .makeColorSpace(nullptr);
+        decoded.rowBytes = decoded.info.minRowBytes();
+        decoded.pixels = fPool.acquire(decoded.info.computeByteSize(decoded.rowBytes));
+        SkCodec::Result result = codec->getPixels(decoded.info, decoded.pixels.data.get(), decoded.rowBytes);
+        if (result != SkCodec::kSuccess && result != SkCodec::kIncompleteInput) {
+            std::cerr << "Failed to decode image: " << path << " (" << SkCodec::ResultToString(result) << ")"
+                      << std::endl;
+            fPool.release(std::move(decoded.pixels));
+            decoded.pixels = PixelBuffer();
+            decoded.failed = true;
+        }
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    fDecodeUs.fetch_add(static_cast<int64_t>(elapsed.count()), std::memory_order_relaxed);
+
+    if (fUploader) {
+        // 실패한 것도 업로더를 거쳐 render 스레드로 전달된다
+        fUploader->enqueue(std::move(decoded));
+    } else {
+        std::lock_guard<std::mutex> lock(fDecodedMutex);
+        fDecoded.push_back(std::move(decoded));
+    }
+}
+
+void ImageManager::finish(int id, sk_sp<SkImage> image)
+{
+    Entry &entry = fEntries[id];
+    entry.done = true;
+    entry.failed = !image;
+    entry.image = std::move(image);
+    --fPending;
+    if (entry.failed) {
+        ++fFailed;
+    } else {
+        ++fLoaded;
+    }
+}
+
+int ImageManager::pollUploader()
+{
+    fUploaded.clear();
+    fUploader->collect(&fUploaded);
+    for (const UploadedTexture &texture : fUploaded) {
+        sk_sp<SkImage> image;
+        if (texture.image != VK_NULL_HANDLE) {
+            image = fUploader->wrap(fContext, texture);
+            fUploadedBytes += texture.size;
+        }
+        finish(texture.id, std::move(image));
+    }
+    return static_cast<int>(fUploaded.size());
+}
+
+namespace {
+
+struct PooledPixels
+{
+    PixelBufferPool *pool;
+    PixelBuffer buffer;
+};
+
+void releasePooledPixels(const void *, void *context)
+{
+    PooledPixels *pixels = static_cast<PooledPixels *>(context);
+    pixels->pool->release(std::move(pixels->buffer));
+    delete pixels;
+}
+
+} // namespace
+
+int ImageManager::pollDecoded()
+{
+    // 한 프레임에 올리는 양을 예산으로 제한한다 (최소 한 장은 진행)
+    int count = 0;
+    size_t bytes = 0;
+    while (true) {
+        DecodedImage decoded;
+        {
+            std::lock_guard<std::mutex> lock(fDecodedMutex);
+            if (fDecoded.empty() || (count > 0 && bytes >= fOptions.uploadBudgetBytes)) {
+                break;
+            }
+            decoded = std::move(fDecoded.front());
+            fDecoded.pop_front();
+        }
+        ++count;
+        if (decoded.failed) {
+            finish(decoded.id, nullptr);
+            continue;
+        }
+        size_t size = decoded.info.computeByteSize(decoded.rowBytes);
+        SkPixmap pixmap(decoded.info, decoded.pixels.data.get(), decoded.rowBytes);
+        auto *pixels = new PooledPixels{&fPool, std::move(decoded.pixels)};
+        sk_sp<SkImage> raster = SkImages::RasterFromPixmap(pixmap, releasePooledPixels, pixels);
+        sk_sp<SkImage> texture =
+                raster ? SkImages::TextureFromImage(fContext, raster, skgpu::Mipmapped::kNo, skgpu::Budgeted::kYes)
+                       : nullptr;
+        if (texture) {
+            bytes += size;
+            fUploadedBytes += size;
+        }
+        // raster 가 해제되면서 버퍼는 풀로 돌아간다
+        finish(decoded.id, std::move(texture));
+    }
+    return count;
+}
+
+int ImageManager::poll()
+{
+    if (fPending == 0) {
+        return 0;
+    }
+    auto start = std::chrono::steady_clock::now();
+    int ready = fUploader ? pollUploader() : pollDecoded();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    if (!fUploader) {
+        fRenderThreadUploadMs += elapsed.count();
+    }
+    fMaxPollMs = std::max(fMaxPollMs, elapsed.count());
+    return ready;
+}
+
+void ImageManager::printStats(std::ostream &os) const
+{
+    os << "Images: " << fLoaded << " loaded, " << fFailed << " failed, " << fPending << " pending ("
+       << (fUploader ? "transfer queue" : "render thread") << " upload)" << std::endl;
+    os << "  decode " << fDecodeUs.load(std::memory_order_relaxed) / 1000.0 << " ms total, uploaded "
+       << fUploadedBytes / (1024.0 * 1024.0) << " MiB, max poll " << fMaxPollMs << " ms";
+    if (!fUploader) {
+        os << ", render thread upload " << fRenderThreadUploadMs << " ms total";
+    }
+    os << std::endl;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "include/core/SkImage.h"
+#include "include/core/SkRefCnt.h"
+
+#include "pixel_buffer_pool.h"
+#include "thread_pool.h"
+#include "vk_image_uploader.h"
+
+class GrDirectContext;
+struct VulkanContext;
+
+struct ImageManagerOptions
+{
+    int decodeThreads = 2;                  // <= 0 이면 hardware_concurrency
+    size_t uploadBudgetBytes = 8 << 20;     // render 스레드 업로드 시 poll() 한 번에 올릴 최대 바이트
+    bool transferQueue = true;              // Vulkan 전용 transfer queue 사용 (없으면 render 스레드 업로드)
+};
+
+// 이미지 파일을 worker 스레드에서 SkCodec 으로 decode 하고 GPU 텍스처로 올린다.
+// Vulkan 에 graphics 와 다른 transfer queue family 가 있으면 VkImageUploader 스레드가 업로드하고,
+// 없으면 (GL 포함) poll() 에서 프레임당 uploadBudgetBytes 만큼씩 SkImages::TextureFromImage 로 올린다.
+// load / image / poll 은 render 스레드에서만 호출한다. poll() 은 decode/업로드를 기다리지 않는다.
+class ImageManager
+{
+public:
+    // vkCtx 가 nullptr 이면 (GL) render 스레드 업로드
+    ImageManager(GrDirectContext *context, const VulkanContext *vkCtx,
+                 const ImageManagerOptions &options = ImageManagerOptions());
+    ~ImageManager();
+
+    ImageManager(const ImageManager &) = delete;
+    ImageManager &operator=(const ImageManager &) = delete;
+
+    // decode 를 예약하고 handle 을 돌려준다
+    int load(const std::string &path);
+    // 아직 준비되지 않았거나 실패했으면 nullptr
+    sk_sp<SkImage> image(int handle) const;
+    bool failed(int handle) const;
+
+    // 매 프레임 render 스레드에서 호출: 끝난 업로드를 받아 SkImage 로 만든다. 새로 준비된 이미지 수를 반환
+    int poll();
+
+    int imageCount() const { return static_cast<int>(fEntries.size()); }
+    int pendingCount() const { return fPending; }
+    bool usesTransferQueue() const { return fUploader != nullptr; }
+
+    void printStats(std::ostream &os) const;
+
+private:
+    struct Entry
+    {
+        std::string path;
+        sk_sp<SkImage> image;
+        bool done = false;
+        bool failed = false;
+    };
+
+    void decode(int id, const std::string &path);
+    int pollUploader();
+    int pollDecoded();
+    void finish(int id, sk_sp<SkImage> image);
+
+    GrDirectContext *fContext;
+    ImageManagerOptions fOptions;
+    PixelBufferPool fPool;
+    std::unique_ptr<VkImageUploader> fUploader;
+    std::unique_ptr<ThreadPool> fDecoders;  // 소멸자에서 가장 먼저 reset (남은 decode 를 끝내고 join)
+
+    // 업로더가 없을 때 decode 스레드 -> render 스레드
+    std::mutex fDecodedMutex;
+    std::deque<DecodedImage> fDecoded;
+
+    std::vector<Entry> fEntries;
+    std::vector<UploadedTexture> fUploaded;
+    int fPending = 0;
+    int fLoaded = 0;
+    int fFailed = 0;
+    uint64_t fUploadedBytes = 0;
+    double fRenderThreadUploadMs = 0;
+    double fMaxPollMs = 0;
+    std::atomic<int64_t> fDecodeUs{0};
+};
@@ -0,0 +1,54 @@
+#include "path_registry.h"
+
+PathRegistry::PathRegistry(size_t capacity)
+    : fCapacity(capacity > 0 ? capacity : 1)
+{
+}
+
+// FNV-1a 64
+static uint64_t hashBytes(const uint8_t *data, size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+SkPath PathRegistry::intern(const SkPath &path)
+{
+    fScratch.resize(path.writeToMemory(nullptr));
+    path.writeToMemory(fScratch.data());
+    const uint64_t hash = hashBytes(fScratch.data(), fScratch.size());
+
+    auto it = fIndex.find(hash);
+    if (it != fIndex.end()) {
+        // hash 충돌이면 내용 비교에서 걸러져 아래에서 새 path 로 교체된다
+        if (it->second->second == path) {
+            ++fHits;
+            fLru.splice(fLru.begin(), fLru, it->second);
+            return it->second->second;
+        }
+        fLru.erase(it->second);
+        fIndex.erase(it);
+    }
+
+    ++fMisses;
+    SkPath interned = path;
+    interned.setIsVolatile(false);
+    fLru.emplace_front(hash, interned);
+    fIndex.emplace(hash, fLru.begin());
+    if (fLru.size() > fCapacity) {
+        fIndex.erase(fLru.back().first);
+        fLru.pop_back();
+        ++fEvictions;
+    }
+    return interned;
+}
+
+void PathRegistry::printStats(std::ostream &os) const
+{
+    uint64_t total = fHits + fMisses;
+    os << "Path registry: " << fLru.size() << " paths, " << fHits << " hits / " << fMisses << " misses ("
+       << (total ? 100.0 * fHits / total : 0.0) << "% hit), " << fEvictions << " evictions" << std::endl;
+}
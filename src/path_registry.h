@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "include/core/SkPath.h"
+
+// 내용이 같은 path 를 하나의 SkPath(같은 SkPathRef, 같은 generation ID) 로 모은다.
+// 매 프레임 새로 만든 SkPath 는 내용이 같아도 generation ID 가 달라 Ganesh 의 path mask / tessellation
+// 캐시 key 가 매번 바뀐다. intern() 이 돌려준 path 를 그리면 프레임 사이, 한 프레임 안의 반복 도형 모두
+// 처음 한 번만 tessellate 된다. 내용 hash 는 writeToMemory() 직렬화 결과(verb/point/conic/fill type) 기준.
+// 한 스레드에서만 사용할 것.
+class PathRegistry
+{
+public:
+    explicit PathRegistry(size_t capacity = 4096);
+
+    // 같은 내용의 path 가 등록되어 있으면 그것을, 없으면 path 를 immutable 로 등록해 반환.
+    // 반환값은 SkPathRef 를 공유하는 복사본이라 eviction 이후에도 유효하다.
+    SkPath intern(const SkPath &path);
+
+    uint64_t hits() const { return fHits; }
+    uint64_t misses() const { return fMisses; }
+    uint64_t evictions() const { return fEvictions; }
+    size_t size() const { return fLru.size(); }
+
+    void printStats(std::ostream &os) const;
+
+private:
+    using Entry = std::pair<uint64_t, SkPath>;
+
+    size_t fCapacity;
+    std::list<Entry> fLru;     // 앞쪽이 최근 사용
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> fIndex;
+    std::vector<uint8_t> fScratch;
+    uint64_t fHits = 0;
+    uint64_t fMisses = 0;
+    uint64_t fEvictions = 0;
+};
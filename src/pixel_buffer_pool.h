@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "include/core/SkImageInfo.h"
+
+struct PixelBuffer
+{
+    std::unique_ptr<uint8_t[]> data;
+    size_t capacity = 0;
+};
+
+// decode 결과를 담는 픽셀 버퍼 재사용 풀. 크기를 2 의 거듭제곱으로 올려 같은 크기끼리 재사용하고,
+// 풀에 쌓인 총량이 maxPooledBytes 를 넘으면 반환된 버퍼는 그냥 해제한다. 여러 스레드에서 사용 가능.
+class PixelBufferPool
+{
+public:
+    explicit PixelBufferPool(size_t maxPooledBytes = 64 << 20) : fMaxPooledBytes(maxPooledBytes) {}
+
+    PixelBuffer acquire(size_t size)
+    {
+        size_t capacity = 64 << 10;
+        while (capacity < size) {
+            capacity <<= 1;
+        }
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            auto it = fFree.find(capacity);
+            if (it != fFree.end() && !it->second.empty()) {
+                PixelBuffer buffer = std::move(it->second.back());
+                it->second.pop_back();
+                fPooledBytes -= capacity;
+                return buffer;
+            }
+        }
+        return {std::unique_ptr<uint8_t[]>(new uint8_t[capacity]), capacity};
+    }
+
+    void release(PixelBuffer buffer)
+    {
+        if (!buffer.data) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(fMutex);
+        if (fPooledBytes + buffer.capacity > fMaxPooledBytes) {
+            return;
+        }
+        fPooledBytes += buffer.capacity;
+        fFree[buffer.capacity].push_back(std::move(buffer));
+    }
+
+private:
+    std::mutex fMutex;
+    std::map<size_t, std::vector<PixelBuffer>> fFree;
+    size_t fPooledBytes = 0;
+    size_t fMaxPooledBytes;
+};
+
+// decode 스레드 -> 업로드 단계로 넘기는 결과 (failed 면 pixels 없음)
+struct DecodedImage
+{
+    int id = -1;
+    SkImageInfo info;
+    size_t rowBytes = 0;
+    PixelBuffer pixels;
+    bool failed = false;
+};
@@ -0,0 +1,139 @@
+#include "primitive_batch.h"
+
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkSurface.h"
+#include "include/core/SkVertices.h"
+
+// sprite 의 원 반지름 (크게 확대해도 가장자리가 흐려지지 않을 정도)
+static constexpr float kSpriteRadius = 32;
+// bilinear 샘플링이 이웃으로 번지지 않도록 한 픽셀 여백
+static constexpr float kSpritePad = 1;
+
+PrimitiveBatcher::PrimitiveBatcher()
+{
+    const int size = static_cast<int>(2 * (kSpriteRadius + kSpritePad));
+    sk_sp<SkSurface> surface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(size, size));
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorWHITE);
+    surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+    surface->getCanvas()->drawCircle(size * 0.5f, size * 0.5f, kSpriteRadius, paint);
+    fCircleSprite = surface->makeImageSnapshot();
+}
+
+void PrimitiveBatcher::addPolygon(const SkPoint pts[], int count, SkColor color)
+{
+    if (count < 3) {
+        return;
+    }
+    if (fMeshPositions.size() + 3 * (count - 2) > kMaxMeshVertices) {
+        flushMesh(nullptr);
+    }
+    for (int i = 1; i + 1 < count; ++i) {
+        fMeshPositions.push_back(pts[0]);
+        fMeshPositions.push_back(pts[i]);
+        fMeshPositions.push_back(pts[i + 1]);
+    }
+    fMeshColors.insert(fMeshColors.end(), 3 * (count - 2), color);
+}
+
+void PrimitiveBatcher::addRect(const SkRect &rect, SkColor color)
+{
+    SkPoint quad[4];
+    rect.toQuad(quad);
+    addPolygon(quad, 4, color);
+}
+
+void PrimitiveBatcher::addCircle(SkPoint center, float radius, SkColor color)
+{
+    addSprite(center, radius, color);
+}
+
+void PrimitiveBatcher::addSprite(SkPoint center, float radius, SkColor color)
+{
+    const float scale = radius / kSpriteRadius;
+    const float offset = scale * (kSpriteRadius + kSpritePad);
+    fCircleXforms.push_back(SkRSXform::Make(scale, 0, center.fX - offset, center.fY - offset));
+    fCircleRects.push_back(SkRect::MakeWH(fCircleSprite->width(), fCircleSprite->height()));
+    fCircleColors.push_back(color);
+}
+
+void PrimitiveBatcher::addPoint(SkPoint point, float size, SkColor color)
+{
+    if (!fCurrentRun.points.empty() && (fCurrentRun.color != color || fCurrentRun.size != size)) {
+        endPointRun();
+    }
+    fCurrentRun.color = color;
+    fCurrentRun.size = size;
+    fCurrentRun.points.push_back(point);
+}
+
+void PrimitiveBatcher::endPointRun()
+{
+    if (fCurrentRun.points.size() >= kMinPointRun) {
+        fPointRuns.push_back(fCurrentRun);
+    } else {
+        // 색마다 drawPoints 를 따로 내지 않도록 sprite 별 색을 쓰는 atlas 로 보낸다
+        for (SkPoint point : fCurrentRun.points) {
+            addSprite(point, fCurrentRun.size * 0.5f, fCurrentRun.color);
+        }
+    }
+    fCurrentRun.points.clear();
+}
+
+// 모인 삼각형을 SkVertices 로 만들어 둔다 (canvas 가 있으면 지금까지 만든 메시를 모두 그림)
+void PrimitiveBatcher::flushMesh(SkCanvas *canvas)
+{
+    if (!fMeshPositions.empty()) {
+        fMeshes.push_back(SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode,
+                                               static_cast<int>(fMeshPositions.size()), fMeshPositions.data(),
+                                               nullptr, fMeshColors.data()));
+        fMeshPositions.clear();
+        fMeshColors.clear();
+    }
+    if (!canvas) {
+        return;
+    }
+    // paint 에 shader 가 없으면 정점 색이 그대로 쓰인다
+    SkPaint paint;
+    for (const sk_sp<const SkVertices> &mesh : fMeshes) {
+        canvas->drawVertices(mesh, SkBlendMode::kModulate, paint);
+        ++fDrawCalls;
+    }
+    fMeshes.clear();
+}
+
+void PrimitiveBatcher::flush(SkCanvas *canvas)
+{
+    flushMesh(canvas);
+    endPointRun();
+
+    if (!fCircleXforms.empty()) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        canvas->drawAtlas(fCircleSprite.get(), fCircleXforms.data(), fCircleRects.data(), fCircleColors.data(),
+                          static_cast<int>(fCircleXforms.size()), SkBlendMode::kModulate,
+                          SkSamplingOptions(SkFilterMode::kLinear), nullptr, &paint);
+        ++fDrawCalls;
+        fCircleXforms.clear();
+        fCircleRects.clear();
+        fCircleColors.clear();
+    }
+
+    for (const PointRun &run : fPointRuns) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(run.color);
+        paint.setStrokeWidth(run.size);
+        paint.setStrokeCap(SkPaint::kRound_Cap);
+        canvas->drawPoints(SkCanvas::kPoints_PointMode, run.points.size(), run.points.data(), paint);
+        ++fDrawCalls;
+    }
+    fPointRuns.clear();
+
+    fLastDrawCalls = fDrawCalls;
+    fDrawCalls = 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+#include "include/core/SkColor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRSXform.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+
+class SkCanvas;
+class SkVertices;
+
+// 작은 도형 수만 개를 도형마다 drawPath 하는 대신 종류별로 모아 몇 번의 draw 로 제출한다.
+//  - 다각형/사각형: 삼각형으로 쪼개 정점 색을 가진 SkVertices 메시 하나 (AA 없음)
+//  - 원: 미리 그린 AA 원 sprite 하나를 drawAtlas 로 (크기는 RSXform, 색은 sprite 별 modulate)
+//  - 점: 원과 같은 sprite 로 atlas 에 합친다 (반지름 size/2). 색/크기가 같은 점이 kMinPointRun 개 이상
+//        연달아 들어오면 그 run 만 drawPoints 한 번으로 그린다
+// flush() 는 메시 → atlas → 점 순서로 그리므로 종류가 다른 도형 사이의 겹침 순서는 보장하지 않는다.
+// 순서가 중요하면 그 사이에 flush() 를 호출할 것. 버퍼는 프레임 사이에 재사용된다.
+class PrimitiveBatcher
+{
+public:
+    PrimitiveBatcher();
+
+    // 볼록 다각형 (fan 으로 삼각형 분할)
+    void addPolygon(const SkPoint pts[], int count, SkColor color);
+    void addRect(const SkRect &rect, SkColor color);
+    void addCircle(SkPoint center, float radius, SkColor color);
+    void addPoint(SkPoint point, float size, SkColor color);
+
+    void flush(SkCanvas *canvas);
+
+    // 직전 flush() 가 낸 draw 호출 수 (batching 효과 확인용)
+    int lastDrawCalls() const { return fLastDrawCalls; }
+
+private:
+    // 도형 수가 많아도 정점 버퍼가 너무 커지지 않도록 이 수를 넘으면 메시를 나눈다
+    static constexpr size_t kMaxMeshVertices = 3 * 65536;
+    // 이보다 짧은 같은 paint 점 run 은 drawPoints 로 따로 그리지 않고 atlas 에 합친다
+    static constexpr size_t kMinPointRun = 64;
+
+    struct PointRun
+    {
+        SkColor color;
+        float size;
+        std::vector<SkPoint> points;
+    };
+
+    void flushMesh(SkCanvas *canvas);
+    void addSprite(SkPoint center, float radius, SkColor color);
+    // 진행 중인 점 run 을 길이에 따라 fPointRuns 또는 atlas 로 넘긴다
+    void endPointRun();
+
+    std::vector<SkPoint> fMeshPositions;
+    std::vector<SkColor> fMeshColors;
+    std::vector<sk_sp<const SkVertices>> fMeshes;
+
+    sk_sp<SkImage> fCircleSprite;
+    std::vector<SkRSXform> fCircleXforms;
+    std::vector<SkRect> fCircleRects;
+    std::vector<SkColor> fCircleColors;
+
+    PointRun fCurrentRun{};
+    std::vector<PointRun> fPointRuns;
+
+    int fDrawCalls = 0;
+    int fLastDrawCalls = 0;
+};
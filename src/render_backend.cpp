@@ -0,0 +1,510 @@
+#define GLFW_INCLUDE_VULKAN
+#include "render_backend.h"
+
+#include <iostream>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkSurface.h"
+#include "include/gpu/ganesh/GrBackendSemaphore.h"
+#include "include/gpu/ganesh/GrBackendSurface.h"
+#include "include/gpu/ganesh/GrContextOptions.h"
+#include "include/gpu/ganesh/GrDirectContext.h"
+#include "include/gpu/ganesh/SkSurfaceGanesh.h"
+#include "include/gpu/ganesh/gl/GrGLBackendSurface.h"
+#include "include/gpu/ganesh/gl/GrGLDirectContext.h"
+#include "include/gpu/ganesh/gl/GrGLInterface.h"
+#include "include/gpu/ganesh/vk/GrVkBackendSemaphore.h"
+
+#include "frame_stats.h"
+#include "gl_gpu_timer.h"
+#include "vk_gpu_timer.h"
+
+bool RenderBackend::resize(int width, int height)
+{
+    fWidth = width;
+    fHeight = height;
+    return true;
+}
+
+namespace {
+
+class RasterBackend : public RenderBackend
+{
+public:
+    bool init(const BackendConfig &config)
+    {
+        fWidth = config.width;
+        fHeight = config.height;
+        fSurface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(fWidth, fHeight));
+        return fSurface != nullptr;
+    }
+
+    const char *name() const override { return "raster"; }
+    SkCanvas *beginFrame(FrameStats &, uint64_t) override { return fSurface->getCanvas(); }
+    void endFrame(FrameStats &, uint64_t) override {}
+    void finish(FrameStats &) override {}
+    bool readPixels(const SkPixmap &dst) override { return fSurface->readPixels(dst, 0, 0); }
+
+    bool resize(int width, int height) override
+    {
+        RenderBackend::resize(width, height);
+        fSurface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(width, height));
+        return fSurface != nullptr;
+    }
+
+private:
+    sk_sp<SkSurface> fSurface;
+};
+
+// picture 기록은 record 단계, 타일 병렬 재생은 flush 단계로 잰다
+class TiledBackend : public RenderBackend
+{
+public:
+    explicit TiledBackend(const BackendConfig &config)
+        : fOptions(config.tiles)
+        , fRenderer(std::make_unique<TiledRasterRenderer>(
+                  SkImageInfo::MakeN32Premul(config.width, config.height), config.tiles))
+        , fName("tiled_t" + std::to_string(fRenderer->threadCount()))
+    {
+        fWidth = config.width;
+        fHeight = config.height;
+    }
+
+    const char *name() const override { return fName.c_str(); }
+    SkCanvas *beginFrame(FrameStats &, uint64_t) override
+    {
+        return fRecorder.beginRecording(SkRect::MakeIWH(fWidth, fHeight));
+    }
+
+    void endFrame(FrameStats &stats, uint64_t) override
+    {
+        ScopedStageTimer timer(stats, FrameStage::kFlush);
+        sk_sp<SkPicture> picture = fRecorder.finishRecordingAsPicture();
+        fRenderer->render(picture.get());
+    }
+
+    void finish(FrameStats &) override {}
+    bool readPixels(const SkPixmap &dst) override { return fRenderer->bitmap().readPixels(dst); }
+
+    bool resize(int width, int height) override
+    {
+        RenderBackend::resize(width, height);
+        fRenderer = std::make_unique<TiledRasterRenderer>(SkImageInfo::MakeN32Premul(width, height), fOptions);
+        return true;
+    }
+
+private:
+    TiledRasterOptions fOptions;
+    SkPictureRecorder fRecorder;
+    std::unique_ptr<TiledRasterRenderer> fRenderer;
+    std::string fName;
+};
+
+// headless 면 숨긴 창의 GL context 로 offscreen RenderTarget 에, 아니면 창의 기본 framebuffer 에 그린다
+class GlBackend : public RenderBackend
+{
+public:
+    ~GlBackend() override
+    {
+        if (fWindow) {
+            glfwMakeContextCurrent(fWindow);
+            fGpuTimer.destroy();
+            fSurface.reset();
+            fContext.reset();
+            glfwDestroyWindow(fWindow);
+        }
+    }
+
+    bool init(const BackendConfig &config)
+    {
+        fWidth = config.width;
+        fHeight = config.height;
+        fHeadless = config.headless;
+        fAa = config.aa;
+        glfwDefaultWindowHints();
+        glfwWindowHint(GLFW_VISIBLE, fHeadless ? GLFW_FALSE : GLFW_TRUE);
+        if (!fHeadless && fAa.mode == AaMode::kMsaa) {
+            glfwWindowHint(GLFW_SAMPLES, fAa.samples);
+        }
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        fWindow = glfwCreateWindow(fWidth, fHeight, config.title.c_str(), nullptr, nullptr);
+        if (!fWindow) {
+            std::cerr << "Failed to create GL context" << std::endl;
+            return false;
+        }
+        glfwMakeContextCurrent(fWindow);
+        glfwSwapInterval(fHeadless ? 0 : 1);
+
+        glewExperimental = GL_TRUE;
+        if (glewInit() != GLEW_OK) {
+            std::cerr << "Failed to initialize GLEW." << std::endl;
+            return false;
+        }
+
+        GrContextOptions contextOptions;
+        fAa.apply(&contextOptions);
+        fContext = GrDirectContexts::MakeGL(GrGLMakeNativeInterface(), contextOptions);
+        if (!fContext) {
+            std::cerr << "Failed to create Skia GrDirectContext for OpenGL!" << std::endl;
+            return false;
+        }
+        if (!createSurface()) {
+            return false;
+        }
+        fGpuTimer.init();
+        return true;
+    }
+
+    const char *name() const override { return "gl"; }
+    GrDirectContext *directContext() const override { return fContext.get(); }
+    GLFWwindow *window() const override { return fHeadless ? nullptr : fWindow; }
+
+    SkCanvas *beginFrame(FrameStats &stats, uint64_t) override
+    {
+        fGpuTimer.collect(stats);
+        return fSurface->getCanvas();
+    }
+
+    void endFrame(FrameStats &stats, uint64_t frame) override
+    {
+        ScopedStageTimer timer(stats, FrameStage::kFlush);
+        fGpuTimer.begin(frame);
+        fContext->flushAndSubmit();
+        fGpuTimer.end();
+    }
+
+    void present(FrameStats &stats) override
+    {
+        if (!fHeadless) {
+            ScopedStageTimer timer(stats, FrameStage::kPresent);
+            glfwSwapBuffers(fWindow);
+        }
+    }
+
+    void finish(FrameStats &stats) override
+    {
+        fContext->flushAndSubmit(GrSyncCpu::kYes);
+        fGpuTimer.drain(stats);
+    }
+
+    bool readPixels(const SkPixmap &dst) override { return fSurface->readPixels(dst, 0, 0); }
+
+    bool resize(int width, int height) override
+    {
+        RenderBackend::resize(width, height);
+        fSurface.reset();
+        return createSurface();
+    }
+
+private:
+    bool createSurface()
+    {
+        SkSurfaceProps props(fAa.surfaceFlags(), kUnknown_SkPixelGeometry);
+        if (fHeadless) {
+            // sampleCount > 1 이면 Skia 가 MSAA render target + resolve texture 를 만든다
+            fSurface = SkSurfaces::RenderTarget(fContext.get(), skgpu::Budgeted::kNo,
+                                                SkImageInfo::MakeN32Premul(fWidth, fHeight), fAa.sampleCount(),
+                                                kTopLeft_GrSurfaceOrigin, &props);
+        } else {
+            GLint samples = 0;
+            glGetIntegerv(GL_SAMPLES, &samples);
+            GrGLFramebufferInfo framebufferInfo;
+            framebufferInfo.fFBOID = 0;
+            framebufferInfo.fFormat = GL_RGBA8;
+            GrBackendRenderTarget backendRT =
+                    GrBackendRenderTargets::MakeGL(fWidth, fHeight, samples, 8, framebufferInfo);
+            fSurface = SkSurfaces::WrapBackendRenderTarget(fContext.get(), backendRT, kBottomLeft_GrSurfaceOrigin,
+                                                           kRGBA_8888_SkColorType, nullptr, &props);
+        }
+        if (!fSurface) {
+            std::cerr << "Failed to create GL render target" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    GLFWwindow *fWindow = nullptr;
+    bool fHeadless = true;
+    AaOptions fAa;
+    sk_sp<GrDirectContext> fContext;
+    sk_sp<SkSurface> fSurface;
+    GlGpuTimer fGpuTimer;
+};
+
+// headless 면 offscreen VkImage 들을 돌려 쓰고, 아니면 swapchain acquire / present
+class VulkanBackend : public RenderBackend
+{
+public:
+    ~VulkanBackend() override
+    {
+        if (fVkCtx.device != VK_NULL_HANDLE) {
+            vkDeviceWaitIdle(fVkCtx.device);
+            fGpuTimer.destroy(fVkCtx.device);
+        }
+        destroyVulkan(fVkCtx, fContext);
+        if (fWindow) {
+            glfwDestroyWindow(fWindow);
+        }
+    }
+
+    bool init(const BackendConfig &backendConfig)
+    {
+        fWidth = backendConfig.width;
+        fHeight = backendConfig.height;
+        VulkanConfig config;
+        config.headless = backendConfig.headless;
+        config.width = backendConfig.width;
+        config.height = backendConfig.height;
+        config.device = backendConfig.device;
+        config.aa = backendConfig.aa;
+        if (!config.headless) {
+            glfwDefaultWindowHints();
+            glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+            fWindow = glfwCreateWindow(fWidth, fHeight, backendConfig.title.c_str(), nullptr, nullptr);
+            if (!fWindow) {
+                std::cerr << "Failed to create window" << std::endl;
+                return false;
+            }
+        }
+        if (!setupVulkan(fWindow, config, fVkCtx, fContext)) {
+            std::cerr << "Failed Vulkan setup" << std::endl;
+            return false;
+        }
+        // 측정 구간에 wrap 비용이 섞이지 않도록 미리 전부 wrap
+        for (uint32_t i = 0; i < fVkCtx.images.size(); ++i) {
+            if (!surfaceForImage(fVkCtx, fContext.get(), i)) {
+                return false;
+            }
+        }
+        fGpuTimer.init(fVkCtx);
+        return true;
+    }
+
+    // lavapipe 등 software device (auto 선택에서 GL 보다 뒤로 미룬다)
+    bool isSoftwareDevice() const
+    {
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(fVkCtx.physicalDevice, &props);
+        return props.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU;
+    }
+
+    const char *name() const override { return "vulkan"; }
+    GrDirectContext *directContext() const override { return fContext.get(); }
+    GLFWwindow *window() const override { return fWindow; }
+
+    SkCanvas *beginFrame(FrameStats &stats, uint64_t frame) override
+    {
+        fSlot = fVkCtx.frameIndex;
+        FrameSync *sync;
+        VkResult result = VK_SUCCESS;
+        {
+            ScopedStageTimer timer(stats, FrameStage::kAcquire);
+            sync = &waitForFrameSlot(fVkCtx);
+            if (fVkCtx.headless) {
+                fImageIndex = static_cast<uint32_t>(frame % fVkCtx.images.size());
+            } else {
+                result = vkAcquireNextImageKHR(fVkCtx.device, fVkCtx.swapchain, UINT64_MAX, sync->acquireSemaphore,
+                                               VK_NULL_HANDLE, &fImageIndex);
+            }
+        }
+        collect(stats, fSlot);
+        if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+            resizeToWindow();
+            return nullptr;
+        }
+        if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+            std::cerr << "Failed to acquire swapchain image (VkResult " << result << ")" << std::endl;
+            fFailed = true;
+            return nullptr;
+        }
+        SkSurface *surface = surfaceForImage(fVkCtx, fContext.get(), fImageIndex);
+        if (!surface) {
+            fFailed = true;
+            return nullptr;
+        }
+        fAcquireSemaphore = fVkCtx.headless ? VK_NULL_HANDLE : sync->acquireSemaphore;
+        return surface->getCanvas();
+    }
+
+    void endFrame(FrameStats &stats, uint64_t frame) override
+    {
+        ScopedStageTimer timer(stats, FrameStage::kFlush);
+        bool timerWaited = fGpuTimer.begin(fVkCtx.queue, fSlot, frame, fAcquireSemaphore);
+        if (fVkCtx.headless) {
+            fContext->flushAndSubmit();
+        } else {
+            // 이미지가 실제로 사용 가능해진 뒤에 Skia 명령이 실행되도록 GPU 측 대기.
+            // GPU timer 가 acquire 를 대신 기다렸으면 그 submit 을 기다린다 (GPU 시간에 acquire 대기 제외)
+            VkSemaphore skiaWait = timerWaited ? fGpuTimer.startedSemaphore(fSlot) : fAcquireSemaphore;
+            GrBackendSemaphore waitSemaphore = GrBackendSemaphores::MakeVk(skiaWait);
+            fVkCtx.skSurfaces[fImageIndex]->wait(1, &waitSemaphore, /*deleteSemaphoresAfterWait=*/false);
+            GrBackendSemaphore renderSemaphore = GrBackendSemaphores::MakeVk(fVkCtx.renderSemaphores[fImageIndex]);
+            GrFlushInfo flushInfo;
+            flushInfo.fNumSemaphores = 1;
+            flushInfo.fSignalSemaphores = &renderSemaphore;
+            fSubmitted = fContext->flush(fVkCtx.skSurfaces[fImageIndex].get(),
+                                         SkSurfaces::BackendSurfaceAccess::kPresent, flushInfo);
+            fContext->submit();
+        }
+        fGpuTimer.end(fVkCtx.queue, fSlot);
+        submitFrameFence(fVkCtx);
+    }
+
+    void present(FrameStats &stats) override
+    {
+        if (fVkCtx.headless) {
+            return;
+        }
+        VkPresentInfoKHR presentInfo{VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
+        if (fSubmitted == GrSemaphoresSubmitted::kYes) {
+            presentInfo.waitSemaphoreCount = 1;
+            presentInfo.pWaitSemaphores = &fVkCtx.renderSemaphores[fImageIndex];
+        }
+        presentInfo.swapchainCount = 1;
+        presentInfo.pSwapchains = &fVkCtx.swapchain;
+        presentInfo.pImageIndices = &fImageIndex;
+        VkResult result;
+        {
+            ScopedStageTimer timer(stats, FrameStage::kPresent);
+            result = vkQueuePresentKHR(fVkCtx.queue, &presentInfo);
+        }
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+            resizeToWindow();
+        }
+    }
+
+    void finish(FrameStats &stats) override
+    {
+        fContext->flushAndSubmit(GrSyncCpu::kYes);
+        vkDeviceWaitIdle(fVkCtx.device);
+        for (uint32_t slot = 0; slot < fVkCtx.frames.size(); ++slot) {
+            collect(stats, slot);
+        }
+    }
+
+    bool readPixels(const SkPixmap &dst) override
+    {
+        SkSurface *surface = surfaceForImage(fVkCtx, fContext.get(), fImageIndex);
+        return surface && surface->readPixels(dst, 0, 0);
+    }
+
+    bool resize(int width, int height) override
+    {
+        RenderBackend::resize(width, height);
+        if (fVkCtx.headless) {
+            std::cerr << "Resizing headless Vulkan targets is not supported" << std::endl;
+            return false;
+        }
+        if (!recreateSwapchain(fVkCtx, fContext.get(), width, height)) {
+            std::cerr << "Failed to recreate swapchain" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    // 최소화(0x0) 중이면 다음 acquire 때 다시 시도
+    void resizeToWindow()
+    {
+        int width = 0, height = 0;
+        glfwGetFramebufferSize(fWindow, &width, &height);
+        if (width > 0 && height > 0) {
+            resize(width, height);
+        }
+    }
+
+    void collect(FrameStats &stats, uint32_t slot)
+    {
+        uint64_t gpuFrame;
+        double gpuMs;
+        if (fGpuTimer.collect(fVkCtx.device, slot, &gpuFrame, &gpuMs)) {
+            stats.setGpuTime(gpuFrame, gpuMs);
+        }
+    }
+
+    GLFWwindow *fWindow = nullptr;
+    VulkanContext fVkCtx{};
+    sk_sp<GrDirectContext> fContext;
+    VkGpuTimer fGpuTimer;
+    uint32_t fSlot = 0;
+    uint32_t fImageIndex = 0;
+    VkSemaphore fAcquireSemaphore = VK_NULL_HANDLE;
+    GrSemaphoresSubmitted fSubmitted = GrSemaphoresSubmitted::kNo;
+};
+
+std::unique_ptr<RenderBackend> makeAutoBackend(const BackendConfig &config)
+{
+    // GPU 가 있으면 Vulkan. Vulkan 이 software device 뿐이면 headless 에서는 GL 을 먼저 시도
+    // (창 모드는 창을 두 개 만들지 않도록 그대로 사용), 마지막으로 raster
+    std::unique_ptr<RenderBackend> software;
+    auto vulkan = std::make_unique<VulkanBackend>();
+    if (vulkan->init(config)) {
+        if (!vulkan->isSoftwareDevice()) {
+            return vulkan;
+        }
+        software = std::move(vulkan);
+    } else {
+        vulkan.reset();
+    }
+    if (!software || config.headless) {
+        if (std::unique_ptr<RenderBackend> gl = makeRenderBackend("gl", config)) {
+            return gl;
+        }
+    }
+    if (software) {
+        return software;
+    }
+    if (!config.headless) {
+        std::cerr << "No GPU backend available for a window" << std::endl;
+        return nullptr;
+    }
+    return makeRenderBackend("raster", config);
+}
+
+} // namespace
+
+const std::vector<std::string> &renderBackendNames()
+{
+    static const std::vector<std::string> names = {"raster", "tiled", "gl", "vulkan"};
+    return names;
+}
+
+std::unique_ptr<RenderBackend> makeRenderBackend(const std::string &name, const BackendConfig &config)
+{
+    if (name == "auto") {
+        return makeAutoBackend(config);
+    }
+    if ((name == "raster" || name == "tiled") && !config.headless) {
+        std::cerr << name << " backend renders offscreen only (use --headless)" << std::endl;
+        return nullptr;
+    }
+    if (name == "tiled") {
+        return std::make_unique<TiledBackend>(config);
+    } else if (name == "raster") {
+        auto backend = std::make_unique<RasterBackend>();
+        if (backend->init(config)) {
+            return backend;
+        }
+    } else if (name == "gl") {
+        auto backend = std::make_unique<GlBackend>();
+        if (backend->init(config)) {
+            return backend;
+        }
+    } else if (name == "vulkan") {
+        auto backend = std::make_unique<VulkanBackend>();
+        if (backend->init(config)) {
+            return backend;
+        }
+    } else {
+        std::cerr << "Unknown backend: " << name << std::endl;
+    }
+    return nullptr;
+}
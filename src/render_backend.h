@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "aa_mode.h"
+#include "tiled_raster.h"
+#include "vk_context.h"
+
+class FrameStats;
+class GrDirectContext;
+class SkCanvas;
+class SkPixmap;
+struct GLFWwindow;
+
+struct BackendConfig
+{
+    int width = WIDTH;
+    int height = HEIGHT;
+    bool headless = true;           // false 면 창을 만들어 present (gl / vulkan 만)
+    std::string title = "Skia";
+    DeviceSelection device;         // vulkan
+    TiledRasterOptions tiles;       // tiled
+    AaOptions aa;                   // gl / vulkan (raster 는 항상 analytic AA)
+};
+
+// CPU raster / GL / Vulkan 렌더 타깃을 같은 인터페이스로 다룬다.
+// 프레임마다 beginFrame -> (canvas 에 기록) -> endFrame -> present 순서로 호출.
+// gl / vulkan 은 GLFW 창(headless 면 숨긴 창 또는 창 없음)을 직접 만들므로 glfwInit() 이후에 생성할 것.
+class RenderBackend
+{
+public:
+    virtual ~RenderBackend() = default;
+
+    virtual const char *name() const = 0;
+    // GPU 백엔드의 Skia context (raster 는 nullptr)
+    virtual GrDirectContext *directContext() const { return nullptr; }
+    // headless 가 아니면 표시용 창 (이벤트 처리 / 종료 확인용)
+    virtual GLFWwindow *window() const { return nullptr; }
+    int width() const { return fWidth; }
+    int height() const { return fHeight; }
+
+    // 필요한 대기(이전 프레임 GPU 완료, swapchain acquire) 후 그릴 canvas. nullptr 이면 이번 프레임은 건너뜀
+    // (failed() 가 true 가 되었으면 다시 시도해도 소용없으므로 루프를 끝낼 것)
+    virtual SkCanvas *beginFrame(FrameStats &stats, uint64_t frame) = 0;
+    // 기록한 명령을 제출 (tiled 는 여기서 타일 병렬 재생)
+    virtual void endFrame(FrameStats &stats, uint64_t frame) = 0;
+    // 창이 있으면 화면에 표시
+    virtual void present(FrameStats &) {}
+    // 남은 GPU 작업을 모두 끝내고 GPU 시간 수거
+    virtual void finish(FrameStats &stats) = 0;
+    // 마지막으로 그린 프레임을 dst 로 읽어 온다 (finish() 이후)
+    virtual bool readPixels(const SkPixmap &dst) = 0;
+    // 창 크기가 바뀌었을 때 (0x0 은 호출하지 말 것)
+    virtual bool resize(int width, int height);
+    // 복구할 수 없는 오류(swapchain acquire 실패 등)로 더 그릴 수 없음
+    bool failed() const { return fFailed; }
+
+protected:
+    int fWidth = 0;
+    int fHeight = 0;
+    bool fFailed = false;
+};
+
+// raster | tiled | gl | vulkan. "auto" 는 vulkan -> gl -> raster 순으로 처음 초기화되는 것.
+// 실패하면 nullptr (원인은 stderr)
+std::unique_ptr<RenderBackend> makeRenderBackend(const std::string &name, const BackendConfig &config);
+const std::vector<std::string> &renderBackendNames();
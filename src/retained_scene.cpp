@@ -0,0 +1,79 @@
+#include "retained_scene.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPictureRecorder.h"
+
+int RetainedScene::addStatic(DrawFn draw)
+{
+    return addNode(std::move(draw), true);
+}
+
+int RetainedScene::addDynamic(DrawFn draw)
+{
+    return addNode(std::move(draw), false);
+}
+
+int RetainedScene::addNode(DrawFn draw, bool isStatic)
+{
+    fNodes.push_back({std::move(draw), isStatic, true, nullptr});
+    // static run 경계가 바뀔 수 있으므로 직전 노드의 run 도 다시 기록
+    if (fNodes.size() > 1) {
+        fNodes[fNodes.size() - 2].dirty = true;
+    }
+    return static_cast<int>(fNodes.size()) - 1;
+}
+
+void RetainedScene::setBounds(const SkRect &bounds)
+{
+    if (bounds == fBounds) {
+        return;
+    }
+    fBounds = bounds;
+    for (Node &node : fNodes) {
+        node.dirty = true;
+    }
+}
+
+void RetainedScene::invalidate(int node)
+{
+    if (node >= 0 && node < static_cast<int>(fNodes.size())) {
+        fNodes[node].dirty = true;
+    }
+}
+
+void RetainedScene::draw(SkCanvas *canvas, int frame)
+{
+    size_t i = 0;
+    while (i < fNodes.size()) {
+        if (!fNodes[i].isStatic) {
+            fNodes[i].draw(canvas, frame);
+            ++i;
+            continue;
+        }
+
+        // [i, end) 가 하나의 static run
+        size_t end = i;
+        bool dirty = false;
+        while (end < fNodes.size() && fNodes[end].isStatic) {
+            dirty |= fNodes[end].dirty;
+            ++end;
+        }
+
+        Node &head = fNodes[i];
+        if (dirty || !head.picture) {
+            SkPictureRecorder recorder;
+            SkCanvas *recordingCanvas = recorder.beginRecording(fBounds);
+            for (size_t n = i; n < end; ++n) {
+                fNodes[n].draw(recordingCanvas, frame);
+                fNodes[n].dirty = false;
+                if (n != i) {
+                    fNodes[n].picture.reset();
+                }
+            }
+            head.picture = recorder.finishRecordingAsPicture();
+            ++fRecordCount;
+        }
+        canvas->drawPicture(head.picture);
+        i = end;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "include/core/SkPicture.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+
+class SkCanvas;
+
+// 변하지 않는 내용은 SkPicture 로 한 번만 기록해 두고 매 프레임 재생하는 scene.
+// 연속된 static 노드는 하나의 picture 로 묶이고, dynamic 노드만 매 프레임 다시 그린다.
+// picture 안의 SkPath 는 같은 객체가 유지되므로 Ganesh 의 path/tessellation 캐시가 hit 한다.
+class RetainedScene
+{
+public:
+    using DrawFn = std::function<void(SkCanvas *canvas, int frame)>;
+
+    explicit RetainedScene(const SkRect &bounds) : fBounds(bounds) {}
+
+    // picture 의 cull rect. 바뀌면 (창 크기 변경 등) 모든 static run 을 다시 기록
+    void setBounds(const SkRect &bounds);
+    const SkRect &bounds() const { return fBounds; }
+
+    // 반환값은 invalidate() 에 넘기는 노드 id
+    int addStatic(DrawFn draw);
+    int addDynamic(DrawFn draw);
+
+    // static 노드 내용이 바뀌었을 때: 해당 노드가 속한 picture 만 다시 기록
+    void invalidate(int node);
+
+    void draw(SkCanvas *canvas, int frame);
+
+    // picture 를 새로 기록한 횟수 (캐시 동작 확인용)
+    int recordCount() const { return fRecordCount; }
+
+private:
+    struct Node
+    {
+        DrawFn draw;
+        bool isStatic;
+        bool dirty;
+        sk_sp<SkPicture> picture;   // static run 의 첫 노드에만 저장
+    };
+
+    int addNode(DrawFn draw, bool isStatic);
+
+    SkRect fBounds;
+    std::vector<Node> fNodes;
+    int fRecordCount = 0;
+};
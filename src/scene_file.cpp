@@ -0,0 +1,170 @@
+#include "scene_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <iostream>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkRect.h"
+
+SceneFile::~SceneFile()
+{
+    close();
+}
+
+bool SceneFile::open(const std::string &path)
+{
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open scene " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(SceneHeader))) {
+        std::cerr << "Invalid scene file " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    fSize = static_cast<size_t>(st.st_size);
+    void *data = mmap(nullptr, fSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "Failed to mmap scene " << path << std::endl;
+        fSize = 0;
+        return false;
+    }
+    // 첫 draw 에서 전체를 읽으므로 미리 page-in 요청
+    madvise(data, fSize, MADV_WILLNEED);
+    fData = static_cast<const uint8_t *>(data);
+    fHeader = reinterpret_cast<const SceneHeader *>(fData);
+
+    if (!validate()) {
+        std::cerr << "Corrupt scene file " << path << std::endl;
+        close();
+        return false;
+    }
+
+    const ScenePaint *paints = section<ScenePaint>(fHeader->paints);
+    fPaints.resize(fHeader->paints.count);
+    for (size_t i = 0; i < fPaints.size(); ++i) {
+        SkPaint &paint = fPaints[i];
+        paint.setColor(paints[i].color);
+        paint.setAntiAlias(paints[i].antiAlias != 0);
+        paint.setStyle(static_cast<SkPaint::Style>(paints[i].style));
+        paint.setStrokeWidth(paints[i].strokeWidth);
+        paint.setStrokeMiter(paints[i].miterLimit);
+        paint.setStrokeCap(static_cast<SkPaint::Cap>(paints[i].cap));
+        paint.setStrokeJoin(static_cast<SkPaint::Join>(paints[i].join));
+    }
+    return true;
+}
+
+void SceneFile::close()
+{
+    if (fData) {
+        munmap(const_cast<uint8_t *>(fData), fSize);
+    }
+    fData = nullptr;
+    fSize = 0;
+    fHeader = nullptr;
+    fPaints.clear();
+    fPaths.clear();
+    fPathBuilt.clear();
+}
+
+// 이후 접근은 검사 없이 하므로 모든 index / 범위를 여기서 확인
+bool SceneFile::validate() const
+{
+    const SceneHeader &h = *fHeader;
+    if (h.magic != kSceneMagic || h.version != kSceneVersion) {
+        return false;
+    }
+    auto fits = [this](const SceneSection &s, uint64_t elementSize) {
+        return s.offset % 4 == 0 && s.offset <= fSize && s.count <= (fSize - s.offset) / elementSize;
+    };
+    if (!fits(h.paints, sizeof(ScenePaint)) || !fits(h.paths, sizeof(ScenePath)) ||
+        !fits(h.draws, sizeof(SceneDraw)) || !fits(h.points, 2 * sizeof(float)) ||
+        !fits(h.conics, sizeof(float)) || !fits(h.verbs, 1)) {
+        return false;
+    }
+
+    const ScenePaint *paints = section<ScenePaint>(h.paints);
+    for (uint64_t i = 0; i < h.paints.count; ++i) {
+        if (paints[i].style > SkPaint::kStrokeAndFill_Style || paints[i].cap > SkPaint::kLast_Cap ||
+            paints[i].join > SkPaint::kLast_Join) {
+            return false;
+        }
+    }
+    const ScenePath *paths = section<ScenePath>(h.paths);
+    for (uint64_t i = 0; i < h.paths.count; ++i) {
+        const ScenePath &p = paths[i];
+        if (uint64_t(p.firstPoint) + p.pointCount > h.points.count ||
+            uint64_t(p.firstVerb) + p.verbCount > h.verbs.count ||
+            uint64_t(p.firstConic) + p.conicCount > h.conics.count ||
+            p.fillType > static_cast<uint32_t>(SkPathFillType::kInverseEvenOdd)) {
+            return false;
+        }
+    }
+    const SceneDraw *draws = section<SceneDraw>(h.draws);
+    for (uint64_t i = 0; i < h.draws.count; ++i) {
+        const SceneDraw &d = draws[i];
+        if (d.op > kSceneDrawCircle || d.paint >= h.paints.count ||
+            (d.op == kSceneDrawPath && d.path >= h.paths.count)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const SkPath &SceneFile::path(uint32_t index)
+{
+    if (fPaths.empty()) {
+        fPaths.resize(fHeader->paths.count);
+        fPathBuilt.assign(fHeader->paths.count, 0);
+    }
+    if (!fPathBuilt[index]) {
+        const ScenePath &p = section<ScenePath>(fHeader->paths)[index];
+        const SkPoint *points = section<SkPoint>(fHeader->points) + p.firstPoint;
+        const uint8_t *verbs = section<uint8_t>(fHeader->verbs) + p.firstVerb;
+        const float *conics = section<float>(fHeader->conics) + p.firstConic;
+        // verb / point 수가 맞지 않으면 SkPath::Make 가 빈 path 를 돌려준다
+        fPaths[index] = SkPath::Make(points, p.pointCount, verbs, p.verbCount, conics, p.conicCount,
+                                     static_cast<SkPathFillType>(p.fillType));
+        fPathBuilt[index] = 1;
+    }
+    return fPaths[index];
+}
+
+void SceneFile::draw(SkCanvas *canvas)
+{
+    if (!isOpen()) {
+        return;
+    }
+    if (SkColorGetA(fHeader->clearColor) != 0) {
+        canvas->clear(fHeader->clearColor);
+    }
+    const SceneDraw *draws = section<SceneDraw>(fHeader->draws);
+    for (uint64_t i = 0; i < fHeader->draws.count; ++i) {
+        const SceneDraw &d = draws[i];
+        const SkPaint &paint = fPaints[d.paint];
+        switch (d.op) {
+            case kSceneDrawPath:
+                canvas->drawPath(path(d.path), paint);
+                break;
+            case kSceneDrawRect:
+                canvas->drawRect(SkRect::MakeLTRB(d.rect[0], d.rect[1], d.rect[2], d.rect[3]), paint);
+                break;
+            case kSceneDrawOval:
+                canvas->drawOval(SkRect::MakeLTRB(d.rect[0], d.rect[1], d.rect[2], d.rect[3]), paint);
+                break;
+            case kSceneDrawCircle:
+                canvas->drawCircle(d.rect[0], d.rect[1], d.rect[2], paint);
+                break;
+        }
+    }
+}
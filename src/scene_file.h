@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+
+#include "scene_format.h"
+
+class SkCanvas;
+
+// .skscene 파일을 읽기 전용 mmap 으로 열어 그대로 그린다.
+// 읽기/파싱 단계가 없으므로 로드 시간은 section 범위 검사뿐이고, 여러 프로세스가 같은 파일을 열면
+// page cache 를 공유한다. SkPath 는 처음 그릴 때 mmap 된 point/verb 배열에서 만들어 캐시한다.
+class SceneFile
+{
+public:
+    SceneFile() = default;
+    ~SceneFile();
+
+    SceneFile(const SceneFile &) = delete;
+    SceneFile &operator=(const SceneFile &) = delete;
+
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpen() const { return fHeader != nullptr; }
+    float width() const { return fHeader->width; }
+    float height() const { return fHeader->height; }
+    size_t pathCount() const { return fHeader->paths.count; }
+    size_t drawCount() const { return fHeader->draws.count; }
+    size_t mappedBytes() const { return fSize; }
+
+    // 첫 호출 시 SkPath 를 만든다 (main 스레드에서; 동시 호출은 안전하지 않음)
+    void draw(SkCanvas *canvas);
+
+private:
+    bool validate() const;
+    const SkPath &path(uint32_t index);
+
+    template <typename T>
+    const T *section(const SceneSection &s) const
+    {
+        return reinterpret_cast<const T *>(fData + s.offset);
+    }
+
+    const uint8_t *fData = nullptr;
+    size_t fSize = 0;
+    const SceneHeader *fHeader = nullptr;
+    std::vector<SkPaint> fPaints;
+    std::vector<SkPath> fPaths;
+    std::vector<uint8_t> fPathBuilt;
+};
@@ -0,0 +1,145 @@
+#include "scene_format.h"
+
+#include <cstdio>
+#include <iostream>
+
+void SceneBuilder::setSize(float width, float height)
+{
+    fWidth = width;
+    fHeight = height;
+}
+
+uint32_t SceneBuilder::addPaint(const ScenePaint &paint)
+{
+    fPaints.push_back(paint);
+    return static_cast<uint32_t>(fPaints.size() - 1);
+}
+
+void SceneBuilder::beginPath(uint32_t fillType)
+{
+    fCurrent = {};
+    fCurrent.firstPoint = static_cast<uint32_t>(fPoints.size() / 2);
+    fCurrent.firstVerb = static_cast<uint32_t>(fVerbs.size());
+    fCurrent.firstConic = static_cast<uint32_t>(fConics.size());
+    fCurrent.fillType = fillType;
+}
+
+void SceneBuilder::addPoint(float x, float y)
+{
+    fPoints.push_back(x);
+    fPoints.push_back(y);
+}
+
+void SceneBuilder::moveTo(float x, float y)
+{
+    fVerbs.push_back(kSceneMove);
+    addPoint(x, y);
+}
+
+void SceneBuilder::lineTo(float x, float y)
+{
+    fVerbs.push_back(kSceneLine);
+    addPoint(x, y);
+}
+
+void SceneBuilder::quadTo(float x1, float y1, float x2, float y2)
+{
+    fVerbs.push_back(kSceneQuad);
+    addPoint(x1, y1);
+    addPoint(x2, y2);
+}
+
+void SceneBuilder::conicTo(float x1, float y1, float x2, float y2, float weight)
+{
+    fVerbs.push_back(kSceneConic);
+    addPoint(x1, y1);
+    addPoint(x2, y2);
+    fConics.push_back(weight);
+}
+
+void SceneBuilder::cubicTo(float x1, float y1, float x2, float y2, float x3, float y3)
+{
+    fVerbs.push_back(kSceneCubic);
+    addPoint(x1, y1);
+    addPoint(x2, y2);
+    addPoint(x3, y3);
+}
+
+void SceneBuilder::close()
+{
+    fVerbs.push_back(kSceneClose);
+}
+
+uint32_t SceneBuilder::endPath()
+{
+    fCurrent.pointCount = static_cast<uint32_t>(fPoints.size() / 2) - fCurrent.firstPoint;
+    fCurrent.verbCount = static_cast<uint32_t>(fVerbs.size()) - fCurrent.firstVerb;
+    fCurrent.conicCount = static_cast<uint32_t>(fConics.size()) - fCurrent.firstConic;
+    fPaths.push_back(fCurrent);
+    return static_cast<uint32_t>(fPaths.size() - 1);
+}
+
+static uint64_t align8(uint64_t offset)
+{
+    return (offset + 7) & ~uint64_t(7);
+}
+
+bool SceneBuilder::write(const std::string &path) const
+{
+    SceneHeader header = {};
+    header.magic = kSceneMagic;
+    header.version = kSceneVersion;
+    header.width = fWidth;
+    header.height = fHeight;
+    header.clearColor = fClearColor;
+
+    uint64_t offset = sizeof(SceneHeader);
+    auto place = [&offset](SceneSection &section, uint64_t count, uint64_t elementSize) {
+        offset = align8(offset);
+        section.offset = offset;
+        section.count = count;
+        offset += count * elementSize;
+    };
+    place(header.paints, fPaints.size(), sizeof(ScenePaint));
+    place(header.paths, fPaths.size(), sizeof(ScenePath));
+    place(header.draws, fDraws.size(), sizeof(SceneDraw));
+    place(header.points, fPoints.size() / 2, 2 * sizeof(float));
+    place(header.conics, fConics.size(), sizeof(float));
+    place(header.verbs, fVerbs.size(), sizeof(uint8_t));
+
+    // 다른 프로세스가 mmap 중일 수 있으므로 임시 파일에 쓰고 rename
+    const std::string tmpPath = path + ".tmp";
+    FILE *file = fopen(tmpPath.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Failed to open " << tmpPath << std::endl;
+        return false;
+    }
+    uint64_t written = 0;
+    bool ok = true;
+    auto writeAt = [&](const SceneSection &section, const void *data, uint64_t bytes) {
+        static const uint8_t kZeros[8] = {};
+        if (section.offset > written) {
+            ok &= fwrite(kZeros, 1, section.offset - written, file) == section.offset - written;
+        }
+        if (bytes > 0) {
+            ok &= fwrite(data, 1, bytes, file) == bytes;
+        }
+        written = section.offset + bytes;
+    };
+    ok &= fwrite(&header, sizeof(header), 1, file) == 1;
+    written = sizeof(header);
+    writeAt(header.paints, fPaints.data(), fPaints.size() * sizeof(ScenePaint));
+    writeAt(header.paths, fPaths.data(), fPaths.size() * sizeof(ScenePath));
+    writeAt(header.draws, fDraws.data(), fDraws.size() * sizeof(SceneDraw));
+    writeAt(header.points, fPoints.data(), fPoints.size() * sizeof(float));
+    writeAt(header.conics, fConics.data(), fConics.size() * sizeof(float));
+    writeAt(header.verbs, fVerbs.data(), fVerbs.size());
+    ok &= fclose(file) == 0;
+
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to write " << path << std::endl;
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
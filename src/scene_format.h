@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// mmap 으로 바로 쓰는 binary scene 파일 (.skscene) 레이아웃. Skia 에 의존하지 않는다 (변환 도구와 공유).
+// little-endian, 모든 section 은 파일 시작 기준 offset 이며 8 byte 정렬.
+// points 는 SkPoint 와 같은 (x, y) float 쌍, verbs 는 SkPathVerb 와 같은 번호라 복사/변환 없이 SkPath::Make 에 넘긴다.
+
+constexpr uint32_t kSceneMagic = 0x4e534b53;   // "SKSN"
+constexpr uint32_t kSceneVersion = 1;
+
+enum SceneVerb : uint8_t
+{
+    kSceneMove = 0,
+    kSceneLine = 1,
+    kSceneQuad = 2,
+    kSceneConic = 3,
+    kSceneCubic = 4,
+    kSceneClose = 5,
+};
+
+enum SceneDrawOp : uint32_t
+{
+    kSceneDrawPath = 0,     // path
+    kSceneDrawRect = 1,     // rect = LTRB
+    kSceneDrawOval = 2,     // rect = LTRB
+    kSceneDrawCircle = 3,   // rect = cx, cy, radius
+};
+
+struct SceneSection
+{
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct SceneHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    float width;
+    float height;
+    uint32_t clearColor;    // ARGB, alpha 0 이면 clear 하지 않음
+    uint32_t reserved;
+    SceneSection paints;    // ScenePaint[]
+    SceneSection paths;     // ScenePath[]
+    SceneSection draws;     // SceneDraw[]
+    SceneSection points;    // float[2][]
+    SceneSection conics;    // float[]
+    SceneSection verbs;     // uint8_t[]
+};
+
+struct ScenePaint
+{
+    uint32_t color;         // ARGB
+    float strokeWidth;
+    float miterLimit;
+    uint8_t style;          // SkPaint::Style
+    uint8_t antiAlias;
+    uint8_t cap;            // SkPaint::Cap
+    uint8_t join;           // SkPaint::Join
+};
+
+struct ScenePath
+{
+    uint32_t firstPoint;
+    uint32_t pointCount;
+    uint32_t firstVerb;
+    uint32_t verbCount;
+    uint32_t firstConic;
+    uint32_t conicCount;
+    uint32_t fillType;      // SkPathFillType
+};
+
+struct SceneDraw
+{
+    uint32_t op;            // SceneDrawOp
+    uint32_t paint;
+    uint32_t path;
+    float rect[4];
+};
+
+static_assert(sizeof(SceneHeader) == 120, "scene header layout");
+static_assert(sizeof(ScenePaint) == 16, "scene paint layout");
+static_assert(sizeof(ScenePath) == 28, "scene path layout");
+static_assert(sizeof(SceneDraw) == 28, "scene draw layout");
+
+// 메모리에서 scene 을 만들어 .skscene 으로 저장 (변환 도구 / 테스트 scene 생성용)
+class SceneBuilder
+{
+public:
+    void setSize(float width, float height);
+    void setClearColor(uint32_t argb) { fClearColor = argb; }
+
+    uint32_t addPaint(const ScenePaint &paint);
+
+    // beginPath() ... endPath() 사이에 verb 추가. 반환값은 path index
+    void beginPath(uint32_t fillType);
+    void moveTo(float x, float y);
+    void lineTo(float x, float y);
+    void quadTo(float x1, float y1, float x2, float y2);
+    void conicTo(float x1, float y1, float x2, float y2, float weight);
+    void cubicTo(float x1, float y1, float x2, float y2, float x3, float y3);
+    void close();
+    uint32_t endPath();
+
+    void addDraw(const SceneDraw &draw) { fDraws.push_back(draw); }
+
+    size_t paintCount() const { return fPaints.size(); }
+    size_t pathCount() const { return fPaths.size(); }
+    size_t drawCount() const { return fDraws.size(); }
+
+    bool write(const std::string &path) const;
+
+private:
+    void addPoint(float x, float y);
+
+    float fWidth = 0;
+    float fHeight = 0;
+    uint32_t fClearColor = 0;
+    std::vector<ScenePaint> fPaints;
+    std::vector<ScenePath> fPaths;
+    std::vector<SceneDraw> fDraws;
+    std::vector<float> fPoints;
+    std::vector<float> fConics;
+    std::vector<uint8_t> fVerbs;
+    ScenePath fCurrent = {};
+};
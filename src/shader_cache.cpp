@@ -0,0 +1,274 @@
+#include "shader_cache.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkMilestone.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkString.h"
+#include "include/core/SkSurface.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/gpu/ganesh/GrDirectContext.h"
+#include "include/gpu/ganesh/SkSurfaceGanesh.h"
+
+namespace {
+
+constexpr uint32_t kFormatVersion = 1;
+constexpr char kMagic[4] = {'S', 'K', 'S', 'C'};
+
+uint64_t fnv1a(const void *data, size_t size, uint64_t hash = 0xcbf29ce484222325ull)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+std::string toHex(uint64_t value)
+{
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(value));
+    return buf;
+}
+
+struct EntryHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t keySize;
+    uint32_t dataSize;
+};
+
+} // namespace
+
+DiskShaderCache::DiskShaderCache(const std::string &root, const std::string &identity)
+{
+    fDir = root + "/v" + std::to_string(kFormatVersion) + "-m" + std::to_string(SK_MILESTONE) + "/" +
+           toHex(fnv1a(identity.data(), identity.size()));
+    std::error_code ec;
+    std::filesystem::create_directories(fDir, ec);
+    fValid = !ec;
+    if (!fValid) {
+        std::cerr << "Failed to create shader cache directory " << fDir << ": " << ec.message() << std::endl;
+    }
+}
+
+std::string DiskShaderCache::entryPath(const SkData &key) const
+{
+    return fDir + "/" + toHex(fnv1a(key.data(), key.size())) + ".bin";
+}
+
+sk_sp<SkData> DiskShaderCache::readEntry(const std::string &path, const SkData *key, std::string *storedKey)
+{
+    std::ifstream in(path, std::ios::binary);
+    EntryHeader header;
+    if (!in || !in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kFormatVersion ||
+        (key && header.keySize != key->size())) {
+        return nullptr;
+    }
+    // 손상된 entry 의 크기 필드로 큰 버퍼를 잡지 않도록 할당 전에 실제 파일 크기와 맞춰 본다
+    std::error_code ec;
+    const uintmax_t fileSize = std::filesystem::file_size(path, ec);
+    if (ec || fileSize != sizeof(header) + uintmax_t(header.keySize) + header.dataSize) {
+        return nullptr;
+    }
+
+    // 해시 충돌이면 key 가 다르므로 miss 처리
+    std::string entryKey(header.keySize, '\0');
+    if (!in.read(entryKey.data(), entryKey.size()) ||
+        (key && memcmp(entryKey.data(), key->data(), key->size()) != 0)) {
+        return nullptr;
+    }
+    sk_sp<SkData> data = SkData::MakeUninitialized(header.dataSize);
+    if (!in.read(static_cast<char *>(data->writable_data()), header.dataSize)) {
+        return nullptr;
+    }
+    if (storedKey) {
+        *storedKey = std::move(entryKey);
+    }
+    return data;
+}
+
+void DiskShaderCache::preload()
+{
+    if (!fValid) {
+        return;
+    }
+    std::unordered_map<std::string, sk_sp<SkData>> entries;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(fDir, ec)) {
+        if (entry.path().extension() != ".bin") {
+            continue;
+        }
+        std::string key;
+        if (sk_sp<SkData> data = readEntry(entry.path().string(), nullptr, &key)) {
+            entries.emplace(std::move(key), std::move(data));
+        }
+    }
+    std::lock_guard<std::mutex> lock(fMutex);
+    fPreloaded.merge(entries);
+}
+
+sk_sp<SkData> DiskShaderCache::load(const SkData &key)
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (!fValid) {
+        return nullptr;
+    }
+    auto it = fPreloaded.find(std::string(static_cast<const char *>(key.data()), key.size()));
+    if (it != fPreloaded.end()) {
+        ++fHits;
+        return it->second;
+    }
+    sk_sp<SkData> data = readEntry(entryPath(key), &key, nullptr);
+    if (data) {
+        ++fHits;
+    } else {
+        ++fMisses;
+    }
+    return data;
+}
+
+void DiskShaderCache::store(const SkData &key, const SkData &data, const SkString &)
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (!fValid) {
+        return;
+    }
+    fPreloaded.erase(std::string(static_cast<const char *>(key.data()), key.size()));
+    // 다른 프로세스가 동시에 읽어도 반쯤 쓴 파일이 보이지 않도록 임시 파일에 쓰고 rename
+    const std::string path = entryPath(key);
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        EntryHeader header;
+        memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kFormatVersion;
+        header.keySize = static_cast<uint32_t>(key.size());
+        header.dataSize = static_cast<uint32_t>(data.size());
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(static_cast<const char *>(key.data()), key.size());
+        out.write(static_cast<const char *>(data.data()), data.size());
+        if (!out) {
+            std::cerr << "Failed to write shader cache entry " << tmpPath << std::endl;
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (!ec) {
+        ++fStores;
+    }
+}
+
+void DiskShaderCache::printStats(std::ostream &os) const
+{
+    os << "Shader cache: " << fHits << " hits, " << fMisses << " misses, " << fStores << " stores (" << fDir << ")"
+       << std::endl;
+}
+
+std::string defaultShaderCacheDir()
+{
+    if (const char *xdg = getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+        return std::string(xdg) + "/skia-sample";
+    }
+    if (const char *home = getenv("HOME"); home && *home) {
+        return std::string(home) + "/.cache/skia-sample";
+    }
+    return ".skia-sample-cache";
+}
+
+double warmUpShaders(GrDirectContext *context, SkColorType colorType, int sampleCount, const SkSurfaceProps *props)
+{
+    auto start = std::chrono::steady_clock::now();
+    SkImageInfo info = SkImageInfo::Make(256, 256, colorType, kPremul_SkAlphaType);
+    sk_sp<SkSurface> surface = SkSurfaces::RenderTarget(context, skgpu::Budgeted::kNo, info, sampleCount, props);
+    if (!surface) {
+        std::cerr << "Failed to create warm-up surface" << std::endl;
+        return 0;
+    }
+    SkCanvas *canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+
+    SkPaint paint;
+    for (bool aa : {false, true}) {
+        paint.setAntiAlias(aa);
+        paint.setStyle(SkPaint::kFill_Style);
+        paint.setColor(0xFF3366CC);
+        canvas->drawRect(SkRect::MakeXYWH(10, 10, 100, 60), paint);
+        canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(20, 80, 100, 60), 12, 12), paint);
+        canvas->drawCircle(180, 60, 40, paint);
+
+        // 반투명 AA triangle (sample 들의 주된 draw)
+        paint.setColor(0xC0FF0000);
+        SkPath triangle;
+        triangle.moveTo(128, 20);
+        triangle.lineTo(40, 230);
+        triangle.lineTo(216, 230);
+        triangle.close();
+        canvas->drawPath(triangle, paint);
+
+        // 오목 path (stencil/tessellation 경로)
+        SkPath star;
+        for (int i = 0; i < 10; ++i) {
+            float r = (i % 2) ? 30.0f : 80.0f;
+            float a = i * 3.14159265f / 5;
+            SkPoint p = SkPoint::Make(128 + r * std::cos(a), 128 + r * std::sin(a));
+            if (i == 0) {
+                star.moveTo(p);
+            } else {
+                star.lineTo(p);
+            }
+        }
+        star.close();
+        canvas->drawPath(star, paint);
+
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(3);
+        canvas->drawPath(star, paint);
+        canvas->drawLine(0, 0, 255, 255, paint);
+    }
+
+    // gradient shader
+    paint.setStyle(SkPaint::kFill_Style);
+    paint.setColor(SK_ColorBLACK);
+    const SkPoint points[2] = {{0, 0}, {256, 0}};
+    const SkColor colors[2] = {SK_ColorRED, SK_ColorBLUE};
+    paint.setShader(SkGradientShader::MakeLinear(points, colors, nullptr, 2, SkTileMode::kClamp));
+    canvas->drawRect(SkRect::MakeWH(256, 32), paint);
+    paint.setShader(SkGradientShader::MakeRadial({128, 128}, 64, colors, nullptr, 2, SkTileMode::kClamp));
+    canvas->drawCircle(128, 128, 64, paint);
+    paint.setShader(nullptr);
+
+    // 이미지 (texture 샘플링)
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(32, 32);
+    bitmap.eraseColor(SK_ColorGREEN);
+    sk_sp<SkImage> image = bitmap.asImage();
+    canvas->drawImage(image, 0, 0);
+    canvas->drawImageRect(image, SkRect::MakeXYWH(40, 40, 100, 100), SkSamplingOptions(SkFilterMode::kLinear));
+
+    // AA clip
+    canvas->save();
+    canvas->clipRRect(SkRRect::MakeOval(SkRect::MakeXYWH(30, 30, 200, 200)), true);
+    canvas->drawPaint(paint);
+    canvas->restore();
+
+    context->flushAndSubmit(surface.get(), GrSyncCpu::kYes);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
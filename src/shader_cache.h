@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include "include/core/SkImageInfo.h"
+#include "include/gpu/ganesh/GrContextOptions.h"
+
+class GrDirectContext;
+class SkSurfaceProps;
+
+// GrContextOptions::fPersistentCache 의 디스크 구현.
+// <root>/v<format>-m<Skia milestone>/<device key>/ 아래에 key 해시 이름의 파일로 저장하므로
+// Skia 나 드라이버가 바뀌면 자동으로 다른 디렉터리를 쓴다. Vulkan 은 VkPipelineCache 데이터도
+// 같은 경로로 저장된다 (GrDirectContext::storeVkPipelineCacheData).
+class DiskShaderCache : public GrContextOptions::PersistentCache
+{
+public:
+    // identity: 디바이스/드라이버를 구분하는 문자열 (UUID, 드라이버 버전 등). 해시해서 디렉터리명으로 사용
+    DiskShaderCache(const std::string &root, const std::string &identity);
+
+    sk_sp<SkData> load(const SkData &key) override;
+    void store(const SkData &key, const SkData &data, const SkString &description) override;
+
+    // 디렉터리의 entry 를 모두 메모리로 읽어 둔다. 디바이스 생성 등과 병렬로 돌려
+    // 첫 프레임의 load() 가 디스크를 기다리지 않게 한다
+    void preload();
+
+    bool isValid() const { return fValid; }
+    const std::string &directory() const { return fDir; }
+
+    int hits() const { return fHits; }
+    int misses() const { return fMisses; }
+    int stores() const { return fStores; }
+    void printStats(std::ostream &os) const;
+
+private:
+    std::string entryPath(const SkData &key) const;
+    // path 의 entry 를 읽는다. key 가 nullptr 이 아니면 저장된 key 와 비교
+    static sk_sp<SkData> readEntry(const std::string &path, const SkData *key, std::string *storedKey);
+
+    std::string fDir;
+    bool fValid = false;
+    std::mutex fMutex;
+    std::unordered_map<std::string, sk_sp<SkData>> fPreloaded;    // key bytes -> data
+    int fHits = 0;
+    int fMisses = 0;
+    int fStores = 0;
+};
+
+// $XDG_CACHE_HOME/skia-sample 또는 ~/.cache/skia-sample
+std::string defaultShaderCacheDir();
+
+// 자주 쓰는 draw 종류를 offscreen surface 에 한 번씩 그려 첫 프레임 전에 프로그램/파이프라인을 만든다.
+// 캐시가 비어 있으면 컴파일 비용을 앞당기고, 차 있으면 디스크에서 읽어 온다. 걸린 ms 반환.
+// 프로그램은 샘플 수와 DMSAA 여부에 따라 달라지므로 sampleCount / props 는 실제 frame surface 와 같게 넘길 것
+double warmUpShaders(GrDirectContext *context, SkColorType colorType, int sampleCount = 1,
+                     const SkSurfaceProps *props = nullptr);
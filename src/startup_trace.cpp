@@ -0,0 +1,75 @@
+#include "startup_trace.h"
+
+#include <algorithm>
+#include <iomanip>
+
+StartupTracer &StartupTracer::instance()
+{
+    static StartupTracer tracer;
+    return tracer;
+}
+
+StartupTracer::StartupTracer() : fOrigin(std::chrono::steady_clock::now()) {}
+
+void StartupTracer::setOrigin(std::chrono::steady_clock::time_point origin)
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    fOrigin = origin;
+}
+
+double StartupTracer::sinceOrigin() const
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fOrigin).count();
+}
+
+int StartupTracer::threadIndex()
+{
+    // 처음 기록한 스레드부터 0, 1, 2 ... (보통 0 이 main)
+    std::thread::id id = std::this_thread::get_id();
+    auto it = std::find(fThreads.begin(), fThreads.end(), id);
+    if (it != fThreads.end()) {
+        return static_cast<int>(it - fThreads.begin());
+    }
+    fThreads.push_back(id);
+    return static_cast<int>(fThreads.size() - 1);
+}
+
+int StartupTracer::begin(const char *name)
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    Phase phase;
+    phase.name = name;
+    phase.thread = threadIndex();
+    phase.startMs = sinceOrigin();
+    fPhases.push_back(phase);
+    return static_cast<int>(fPhases.size() - 1);
+}
+
+void StartupTracer::end(int phase)
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (phase >= 0 && phase < static_cast<int>(fPhases.size())) {
+        fPhases[phase].durationMs = sinceOrigin() - fPhases[phase].startMs;
+    }
+}
+
+void StartupTracer::print(std::ostream &os) const
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    std::vector<Phase> phases = fPhases;
+    std::stable_sort(phases.begin(), phases.end(),
+                     [](const Phase &a, const Phase &b) { return a.startMs < b.startMs; });
+
+    os << "Startup phases (ms since launch)" << std::endl;
+    os << std::fixed << std::setprecision(2);
+    for (const Phase &phase : phases) {
+        os << "  t" << phase.thread << "  @" << std::setw(8) << phase.startMs << "  " << std::setw(8);
+        if (phase.durationMs >= 0) {
+            os << phase.durationMs;
+        } else {
+            os << "-";
+        }
+        os << "  " << phase.name << std::endl;
+    }
+    os << std::defaultfloat;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "event_tracer.h"
+
+// 시작 단계별 소요 시간 기록 (프로세스 전역). 여러 스레드에서 동시에 기록할 수 있고,
+// print() 는 시작 시각 순으로 offset / duration / 스레드를 보여 줘 병렬화된 구간을 확인할 수 있다.
+class StartupTracer
+{
+public:
+    static StartupTracer &instance();
+
+    // 기준 시각 (기본값: 처음 instance() 를 부른 시각)
+    void setOrigin(std::chrono::steady_clock::time_point origin);
+
+    int begin(const char *name);
+    void end(int phase);
+
+    void print(std::ostream &os) const;
+
+private:
+    StartupTracer();
+
+    struct Phase
+    {
+        std::string name;
+        int thread = 0;
+        double startMs = 0;
+        double durationMs = -1;     // 아직 끝나지 않았으면 -1
+    };
+
+    double sinceOrigin() const;
+    int threadIndex();
+
+    mutable std::mutex fMutex;
+    std::chrono::steady_clock::time_point fOrigin;
+    std::vector<Phase> fPhases;
+    std::vector<std::thread::id> fThreads;
+};
+
+// 범위를 하나의 startup phase 로 기록
+class StartupPhase
+{
+public:
+    explicit StartupPhase(const char *name) : fPhase(StartupTracer::instance().begin(name)), fSpan(name) {}
+    ~StartupPhase() { StartupTracer::instance().end(fPhase); }
+
+    StartupPhase(const StartupPhase &) = delete;
+    StartupPhase &operator=(const StartupPhase &) = delete;
+
+private:
+    int fPhase;
+    TraceSpan fSpan;
+};
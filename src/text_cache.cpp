@@ -0,0 +1,116 @@
+#include "text_cache.h"
+
+#include <functional>
+#include <iostream>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkFontMgr.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkPaint.h"
+
+#include "font_manager.h"
+
+void configureStrikeCache(size_t bytes, int count)
+{
+    if (bytes > 0) {
+        SkGraphics::SetFontCacheLimit(bytes);
+    }
+    if (count > 0) {
+        SkGraphics::SetFontCacheCountLimit(count);
+    }
+}
+
+bool TextCache::BlobKey::operator==(const BlobKey &other) const
+{
+    return typefaceId == other.typefaceId && size == other.size && scaleX == other.scaleX &&
+           skewX == other.skewX && flags == other.flags && text == other.text;
+}
+
+size_t TextCache::BlobKeyHash::operator()(const BlobKey &key) const
+{
+    size_t hash = std::hash<std::string>()(key.text);
+    auto mix = [&hash](size_t value) { hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2); };
+    mix(key.typefaceId);
+    mix(std::hash<float>()(key.size));
+    mix(std::hash<float>()(key.scaleX));
+    mix(std::hash<float>()(key.skewX));
+    mix(key.flags);
+    return hash;
+}
+
+TextCache::TextCache(size_t blobCapacity)
+    : fCapacity(blobCapacity > 0 ? blobCapacity : 1)
+{
+}
+
+sk_sp<SkTypeface> TextCache::typeface(const std::string &family, SkFontStyle style)
+{
+    auto key = std::make_pair(family, (style.weight() << 16) | (style.width() << 8) | style.slant());
+    auto it = fTypefaces.find(key);
+    if (it != fTypefaces.end()) {
+        return it->second;
+    }
+    sk_sp<SkFontMgr> fontMgr = sharedFontMgr();
+    sk_sp<SkTypeface> typeface = fontMgr->matchFamilyStyle(family.empty() ? nullptr : family.c_str(), style);
+    if (!typeface) {
+        typeface = fontMgr->legacyMakeTypeface(nullptr, style);
+    }
+    fTypefaces.emplace(key, typeface);
+    return typeface;
+}
+
+SkFont TextCache::font(const std::string &family, float size, SkFontStyle style)
+{
+    SkFont font(typeface(family, style), size);
+    font.setEdging(SkFont::Edging::kAntiAlias);
+    font.setSubpixel(true);
+    return font;
+}
+
+sk_sp<SkTextBlob> TextCache::blob(const std::string &text, const SkFont &font)
+{
+    BlobKey key;
+    key.text = text;
+    key.typefaceId = font.getTypeface() ? font.getTypeface()->uniqueID() : 0;
+    key.size = font.getSize();
+    key.scaleX = font.getScaleX();
+    key.skewX = font.getSkewX();
+    key.flags = static_cast<uint32_t>(font.getEdging()) | static_cast<uint32_t>(font.getHinting()) << 4 |
+                font.isSubpixel() << 8 | font.isLinearMetrics() << 9 | font.isEmbolden() << 10 |
+                font.isForceAutoHinting() << 11 | font.isEmbeddedBitmaps() << 12 | font.isBaselineSnap() << 13;
+
+    auto it = fBlobs.find(key);
+    if (it != fBlobs.end()) {
+        ++fHits;
+        fLru.splice(fLru.begin(), fLru, it->second);
+        return it->second->second;
+    }
+
+    ++fMisses;
+    sk_sp<SkTextBlob> textBlob = SkTextBlob::MakeFromText(text.data(), text.size(), font, SkTextEncoding::kUTF8);
+    fLru.emplace_front(key, textBlob);
+    fBlobs.emplace(std::move(key), fLru.begin());
+    if (fLru.size() > fCapacity) {
+        fBlobs.erase(fLru.back().first);
+        fLru.pop_back();
+        ++fEvictions;
+    }
+    return textBlob;
+}
+
+void TextCache::drawText(SkCanvas *canvas, const std::string &text, float x, float y, const SkFont &font,
+                         const SkPaint &paint)
+{
+    // 빈 문자열이면 blob 이 nullptr
+    if (sk_sp<SkTextBlob> textBlob = blob(text, font)) {
+        canvas->drawTextBlob(textBlob, x, y, paint);
+    }
+}
+
+void TextCache::printStats(std::ostream &os) const
+{
+    uint64_t total = fHits + fMisses;
+    os << "Text cache: " << fLru.size() << " blobs, " << fTypefaces.size() << " typefaces, " << fHits << " hits / "
+       << fMisses << " misses (" << (total ? 100.0 * fHits / total : 0.0) << "% hit), " << fEvictions
+       << " evictions" << std::endl;
+}
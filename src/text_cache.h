@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "include/core/SkFont.h"
+#include "include/core/SkFontStyle.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkTextBlob.h"
+#include "include/core/SkTypeface.h"
+
+class SkCanvas;
+class SkPaint;
+
+// glyph strike 캐시 한도. 라벨/표처럼 크기와 글자 종류가 많은 화면은 Skia 기본값(2 MiB, 2048 strike)으로는
+// strike 가 계속 버려졌다 다시 래스터화된다. 0 이면 해당 한도는 기본값 유지
+constexpr size_t kDefaultStrikeCacheBytes = 16 << 20;
+constexpr int kDefaultStrikeCacheCount = 4096;
+void configureStrikeCache(size_t bytes = kDefaultStrikeCacheBytes, int count = kDefaultStrikeCacheCount);
+
+// 텍스트 overlay 용 캐시. typeface 는 (family, style) 별로 한 번만 fontconfig 에서 찾고,
+// glyph 변환/advance 계산이 끝난 SkTextBlob 은 (문자열, typeface, 크기 등 font 설정) 을 key 로 LRU 에 보관한다.
+// 같은 blob 객체를 다시 그리면 Ganesh 의 text blob 캐시(blob id 기준)도 hit 한다.
+// 한 스레드(렌더 스레드)에서만 사용할 것.
+class TextCache
+{
+public:
+    explicit TextCache(size_t blobCapacity = 4096);
+
+    // 찾지 못하면 fontconfig 기본 typeface
+    sk_sp<SkTypeface> typeface(const std::string &family, SkFontStyle style = SkFontStyle());
+    SkFont font(const std::string &family, float size, SkFontStyle style = SkFontStyle());
+
+    sk_sp<SkTextBlob> blob(const std::string &text, const SkFont &font);
+    void drawText(SkCanvas *canvas, const std::string &text, float x, float y, const SkFont &font,
+                  const SkPaint &paint);
+
+    uint64_t hits() const { return fHits; }
+    uint64_t misses() const { return fMisses; }
+    uint64_t evictions() const { return fEvictions; }
+    size_t blobCount() const { return fLru.size(); }
+
+    void printStats(std::ostream &os) const;
+
+private:
+    struct BlobKey
+    {
+        std::string text;
+        uint32_t typefaceId;
+        float size;
+        float scaleX;
+        float skewX;
+        uint32_t flags;     // edging / hinting / subpixel 등
+
+        bool operator==(const BlobKey &other) const;
+    };
+    struct BlobKeyHash
+    {
+        size_t operator()(const BlobKey &key) const;
+    };
+    using Entry = std::pair<BlobKey, sk_sp<SkTextBlob>>;
+
+    size_t fCapacity;
+    std::map<std::pair<std::string, int>, sk_sp<SkTypeface>> fTypefaces;   // (family, style 값)
+    std::list<Entry> fLru;     // 앞쪽이 최근 사용
+    std::unordered_map<BlobKey, std::list<Entry>::iterator, BlobKeyHash> fBlobs;
+    uint64_t fHits = 0;
+    uint64_t fMisses = 0;
+    uint64_t fEvictions = 0;
+};
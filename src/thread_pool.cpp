@@ -0,0 +1,112 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(int threads)
+{
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (threads <= 0) {
+            threads = 1;
+        }
+    }
+    for (int i = 0; i < threads; ++i) {
+        fQueues.push_back(std::make_unique<Queue>());
+    }
+    for (int i = 0; i < threads; ++i) {
+        fThreads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(fWakeMutex);
+        fStop = true;
+    }
+    fWake.notify_all();
+    for (auto &thread : fThreads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    // round-robin 으로 분배하고, 불균형은 work stealing 으로 해소
+    unsigned index = fNextQueue.fetch_add(1, std::memory_order_relaxed) % fQueues.size();
+    {
+        std::lock_guard<std::mutex> lock(fQueues[index]->mutex);
+        fQueues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(fWakeMutex);
+        fQueued.fetch_add(1, std::memory_order_release);
+    }
+    fWake.notify_one();
+}
+
+bool ThreadPool::popTask(int worker, std::function<void()> &task)
+{
+    // 자기 큐는 앞에서 (제출 순서대로)
+    {
+        Queue &own = *fQueues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    // 다른 worker 큐는 뒤에서 훔친다
+    for (size_t i = 1; i < fQueues.size(); ++i) {
+        Queue &victim = *fQueues[(worker + i) % fQueues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(int worker)
+{
+    std::function<void()> task;
+    while (true) {
+        if (popTask(worker, task)) {
+            fQueued.fetch_sub(1, std::memory_order_acq_rel);
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(fWakeMutex);
+        fWake.wait(lock, [this] { return fStop || fQueued.load(std::memory_order_acquire) > 0; });
+        if (fStop && fQueued.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)> &fn)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    // remaining 은 doneMutex 안에서만 바꾼다: 마지막 작업이 notify 를 마치기 전에
+    // 대기 스레드가 깨어나 스택 변수를 해제하는 일이 없도록
+    int remaining = count;
+    std::mutex doneMutex;
+    std::condition_variable done;
+    for (int i = 0; i < count; ++i) {
+        submit([&, i] {
+            fn(i);
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (--remaining == 0) {
+                done.notify_all();
+            }
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    done.wait(lock, [&] { return remaining == 0; });
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// worker 마다 자기 deque 를 갖고, 비면 다른 worker 의 뒤쪽에서 훔쳐 오는 스레드 풀
+class ThreadPool
+{
+public:
+    // threads <= 0 이면 hardware_concurrency
+    explicit ThreadPool(int threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int threadCount() const { return static_cast<int>(fThreads.size()); }
+
+    void submit(std::function<void()> task);
+
+    // fn(0) ... fn(count - 1) 을 worker 들에서 실행하고 모두 끝날 때까지 대기
+    void parallelFor(int count, const std::function<void(int)> &fn);
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool popTask(int worker, std::function<void()> &task);
+    void workerLoop(int worker);
+
+    std::vector<std::unique_ptr<Queue>> fQueues;
+    std::vector<std::thread> fThreads;
+    std::atomic<unsigned> fNextQueue{0};
+    std::atomic<int> fQueued{0};
+    std::mutex fWakeMutex;
+    std::condition_variable fWake;
+    bool fStop = false;
+};
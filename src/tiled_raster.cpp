@@ -0,0 +1,48 @@
+#include "tiled_raster.h"
+
+#include <algorithm>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPicture.h"
+
+TiledRasterRenderer::TiledRasterRenderer(const SkImageInfo &info, const TiledRasterOptions &options)
+    : fInfo(info)
+    , fTileSize(std::max(16, options.tileSize))
+    , fPool(std::make_unique<ThreadPool>(options.threads))
+{
+    fTilesX = (info.width() + fTileSize - 1) / fTileSize;
+    fTilesY = (info.height() + fTileSize - 1) / fTileSize;
+}
+
+void TiledRasterRenderer::render(const SkPicture *picture)
+{
+    if (fBitmap.isNull()) {
+        fBitmap.allocPixels(fInfo);
+    }
+    renderInto(picture, fBitmap.pixmap());
+}
+
+void TiledRasterRenderer::renderInto(const SkPicture *picture, const SkPixmap &pixmap)
+{
+    SkASSERT(pixmap.width() == fInfo.width() && pixmap.height() == fInfo.height());
+    fPool->parallelFor(tileCount(), [&](int index) {
+        int x = (index % fTilesX) * fTileSize;
+        int y = (index / fTilesX) * fTileSize;
+        int w = std::min(fTileSize, pixmap.width() - x);
+        int h = std::min(fTileSize, pixmap.height() - y);
+
+        // 공유 버퍼의 타일 영역을 그대로 canvas 로 사용 (rowBytes 는 전체 이미지 기준)
+        std::unique_ptr<SkCanvas> canvas = SkCanvas::MakeRasterDirect(
+                pixmap.info().makeWH(w, h), pixmap.writable_addr(x, y), pixmap.rowBytes());
+        // 새 raster surface 와 같게 투명으로 시작
+        canvas->clear(SK_ColorTRANSPARENT);
+        canvas->translate(-x, -y);
+        canvas->drawPicture(picture);
+    });
+}
+
+sk_sp<SkImage> TiledRasterRenderer::makeImage() const
+{
+    return SkImages::RasterFromPixmap(fBitmap.pixmap(), nullptr, nullptr);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRefCnt.h"
+
+#include "thread_pool.h"
+
+class SkImage;
+class SkPicture;
+
+struct TiledRasterOptions
+{
+    int tileSize = 256;
+    int threads = 0;    // 0 이면 hardware_concurrency
+};
+
+// scene 을 SkPicture 로 한 번 기록한 뒤 타일 단위로 여러 스레드에서 재생하는 CPU 렌더러.
+// 각 타일은 공유 픽셀 버퍼의 해당 영역을 직접 가리키는 canvas 에 그리므로 합성 단계가 없다.
+class TiledRasterRenderer
+{
+public:
+    TiledRasterRenderer(const SkImageInfo &info, const TiledRasterOptions &options);
+
+    // 내부 bitmap 에 그린다. bitmap 은 처음 render() 할 때 할당 (renderInto 만 쓰면 할당하지 않음)
+    void render(const SkPicture *picture);
+    // 내부 bitmap 대신 호출자 버퍼에 그린다. target 크기는 생성 시 info 와 같아야 함
+    void renderInto(const SkPicture *picture, const SkPixmap &target);
+
+    // render() 전에는 비어 있음
+    const SkBitmap &bitmap() const { return fBitmap; }
+    // 픽셀을 복사하지 않는 이미지 (다음 render() 전까지만 유효)
+    sk_sp<SkImage> makeImage() const;
+
+    int tileCount() const { return fTilesX * fTilesY; }
+    int threadCount() const { return fPool->threadCount(); }
+
+private:
+    SkImageInfo fInfo;
+    SkBitmap fBitmap;
+    int fTileSize;
+    int fTilesX;
+    int fTilesY;
+    std::unique_ptr<ThreadPool> fPool;
+};
@@ -0,0 +1,910 @@
+#define GLFW_INCLUDE_VULKAN
+
+#include "vk_context.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <GLFW/glfw3.h>
+
+#include "include/core/SkColorSpace.h"
+#include "include/gpu/ganesh/GrBackendSurface.h"
+#include "include/gpu/ganesh/SkSurfaceGanesh.h"
+#include "include/gpu/ganesh/vk/GrVkBackendSurface.h"
+#include "include/gpu/ganesh/vk/GrVkDirectContext.h"
+#include "include/gpu/ganesh/vk/GrVkTypes.h"
+#include "include/gpu/vk/VulkanBackendContext.h"
+
+#include "startup_trace.h"
+
+const VkAllocationCallbacks *hostAllocationCallbacks(const VulkanContext &vkCtx)
+{
+    return vkCtx.hostTracker ? vkCtx.hostTracker->callbacks() : nullptr;
+}
+
+void printVulkanMemoryStats(const VulkanContext &vkCtx, std::ostream &os)
+{
+    if (vkCtx.memoryAllocator) {
+        vkCtx.memoryAllocator->printStats(os);
+    }
+    if (vkCtx.hostTracker) {
+        vkCtx.hostTracker->printStats(os);
+    }
+}
+
+static bool createInstance(bool headless, VulkanContext &vkCtx)
+{
+    // --- Vulkan Instance ---
+    VkApplicationInfo appInfo{VK_STRUCTURE_TYPE_APPLICATION_INFO};
+    appInfo.pApplicationName = "Skia Vulkan Example";
+    appInfo.apiVersion = VK_API_VERSION_1_3;
+
+    // headless 에서는 surface 확장이 필요 없음 (디스플레이 없는 노드에서 GLFW 미사용)
+    uint32_t glfwExtCount = 0;
+    const char **glfwExts = nullptr;
+    if (!headless) {
+        glfwExts = glfwGetRequiredInstanceExtensions(&glfwExtCount);
+    }
+
+    VkInstanceCreateInfo instInfo{VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+    instInfo.pApplicationInfo = &appInfo;
+    instInfo.enabledExtensionCount = glfwExtCount;
+    instInfo.ppEnabledExtensionNames = glfwExts;
+
+    if (vkCreateInstance(&instInfo, hostAllocationCallbacks(vkCtx), &vkCtx.instance) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create Vulkan instance\n";
+        return false;
+    }
+    return true;
+}
+
+// graphics (+ surface 가 있으면 present) 를 지원하는 queue family, 없으면 -1
+static int findQueueFamily(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface)
+{
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+    for (uint32_t i = 0; i < queueFamilyCount; ++i) {
+        if (!(queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+            continue;
+        }
+        VkBool32 presentSupport = VK_TRUE;
+        if (surface != VK_NULL_HANDLE) {
+            vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
+        }
+        if (presentSupport) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// graphics family 와 다른, transfer 를 지원하는 family (DMA 엔진). graphics/compute 가 없는 것을 우선, 없으면 -1
+static int findTransferQueueFamily(VkPhysicalDevice physicalDevice, uint32_t graphicsFamily)
+{
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+    int best = -1;
+    for (uint32_t i = 0; i < queueFamilyCount; ++i) {
+        VkQueueFlags flags = queueFamilies[i].queueFlags;
+        if (i == graphicsFamily || queueFamilies[i].queueCount == 0 ||
+            !(flags & (VK_QUEUE_TRANSFER_BIT | VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+            continue;
+        }
+        if (!(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+            return static_cast<int>(i);
+        }
+        if (best < 0) {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+static std::string uuidToString(const uint8_t uuid[VK_UUID_SIZE])
+{
+    std::string str;
+    char hex[3];
+    for (int i = 0; i < VK_UUID_SIZE; ++i) {
+        snprintf(hex, sizeof(hex), "%02x", uuid[i]);
+        str += hex;
+    }
+    return str;
+}
+
+static std::string normalizeUuid(const std::string &uuid)
+{
+    std::string str;
+    for (char c : uuid) {
+        if (c != '-') {
+            str += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    return str;
+}
+
+static int deviceTypeRank(VkPhysicalDeviceType type, const DeviceSelection &selection)
+{
+    switch (selection.preference) {
+        case DevicePreference::kDiscrete:
+            if (type == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) return 10;
+            break;
+        case DevicePreference::kIntegrated:
+            if (type == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU) return 10;
+            break;
+        case DevicePreference::kCpu:
+            if (type == VK_PHYSICAL_DEVICE_TYPE_CPU) return 10;
+            break;
+        case DevicePreference::kAuto:
+            break;
+    }
+    switch (type) {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   return 4;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return 3;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    return 2;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:            return 1;
+        default:                                     return 0;
+    }
+}
+
+static bool selectPhysicalDevice(const DeviceSelection &selection, VulkanContext &vkCtx)
+{
+    // --- Physical Device ---
+    uint32_t deviceCount = 0;
+    vkEnumeratePhysicalDevices(vkCtx.instance, &deviceCount, nullptr);
+    std::vector<VkPhysicalDevice> devices(deviceCount);
+    vkEnumeratePhysicalDevices(vkCtx.instance, &deviceCount, devices.data());
+    vkCtx.physicalDevice = VK_NULL_HANDLE;
+
+    const std::string forcedUuid = normalizeUuid(selection.forcedUuid);
+    const bool forced = !selection.forcedName.empty() || !forcedUuid.empty();
+    const bool allowCpu = selection.allowCpu || selection.preference == DevicePreference::kCpu;
+
+    VkPhysicalDevice bestDevice = VK_NULL_HANDLE;
+    int bestRank = 0;
+    for (auto device : devices) {
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(device, &props);
+
+        std::string uuid;
+        if (props.apiVersion >= VK_API_VERSION_1_1) {
+            VkPhysicalDeviceIDProperties idProps{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES};
+            VkPhysicalDeviceProperties2 props2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+            props2.pNext = &idProps;
+            vkGetPhysicalDeviceProperties2(device, &props2);
+            uuid = uuidToString(idProps.deviceUUID);
+        }
+        if (vkCtx.verbose) {
+            std::cout << "Device: " << props.deviceName << " (type=" << props.deviceType
+                      << ", uuid=" << uuid << ")" << std::endl;
+        }
+
+        if (findQueueFamily(device, vkCtx.surface) < 0) {
+            continue;
+        }
+
+        if (forced) {
+            bool nameMatch = !selection.forcedName.empty() &&
+                             std::string(props.deviceName).find(selection.forcedName) != std::string::npos;
+            bool uuidMatch = !forcedUuid.empty() && uuid == forcedUuid;
+            if (nameMatch || uuidMatch) {
+                bestDevice = device;
+                break;
+            }
+            continue;
+        }
+
+        if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU && !allowCpu) {
+            if (vkCtx.verbose) {
+                std::cout << "Ignore Software GPU (llvmpipe)" << std::endl;
+            }
+            continue;
+        }
+
+        int rank = deviceTypeRank(props.deviceType, selection);
+        if (rank > bestRank) {
+            bestRank = rank;
+            bestDevice = device;
+        }
+    }
+    if (bestDevice == VK_NULL_HANDLE) {
+        if (forced) {
+            std::cerr << "Requested device not found: " << selection.forcedName << selection.forcedUuid << std::endl;
+        } else {
+            std::cerr << "No suitable hardware GPU found!" << std::endl;
+        }
+        return false;
+    }
+    vkCtx.physicalDevice = bestDevice;
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(bestDevice, &props);
+    vkCtx.apiVersion = std::min<uint32_t>(props.apiVersion, VK_API_VERSION_1_3);
+    vkCtx.deviceName = props.deviceName;
+    return true;
+}
+
+static bool hasDeviceExtension(VkPhysicalDevice physicalDevice, const char *name)
+{
+    uint32_t extCount = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extCount, nullptr);
+    std::vector<VkExtensionProperties> exts(extCount);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extCount, exts.data());
+    for (const auto &ext : exts) {
+        if (strcmp(ext.extensionName, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool createDevice(VulkanContext &vkCtx)
+{
+    // --- Queue Family ---
+    int family = findQueueFamily(vkCtx.physicalDevice, vkCtx.surface);
+    if (family < 0) {
+        std::cerr << "No suitable queue family\n";
+        return false;
+    }
+    vkCtx.queueFamilyIndex = static_cast<uint32_t>(family);
+
+    // 이미지 업로드는 별도 family 의 큐에서 (render 큐와 병렬로 복사)
+    int transferFamily = findTransferQueueFamily(vkCtx.physicalDevice, vkCtx.queueFamilyIndex);
+    vkCtx.transferQueueFamilyIndex =
+            transferFamily >= 0 ? static_cast<uint32_t>(transferFamily) : VK_QUEUE_FAMILY_IGNORED;
+    vkCtx.transferQueue = VK_NULL_HANDLE;
+
+    float queuePriority = 1.0f;
+    VkDeviceQueueCreateInfo queueInfos[2] = {{VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO},
+                                             {VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO}};
+    queueInfos[0].queueFamilyIndex = vkCtx.queueFamilyIndex;
+    queueInfos[0].queueCount = 1;
+    queueInfos[0].pQueuePriorities = &queuePriority;
+    queueInfos[1].queueFamilyIndex = vkCtx.transferQueueFamilyIndex;
+    queueInfos[1].queueCount = 1;
+    queueInfos[1].pQueuePriorities = &queuePriority;
+
+    std::vector<const char *> deviceExts;
+    vkCtx.incrementalPresent = false;
+    if (!vkCtx.headless) {
+        deviceExts.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        // damage 영역을 compositor 에 전달 (지원할 때만)
+        if (hasDeviceExtension(vkCtx.physicalDevice, VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME)) {
+            deviceExts.push_back(VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME);
+            vkCtx.incrementalPresent = true;
+        }
+    }
+    if (vkCtx.verbose) {
+        std::cout << "VK_KHR_incremental_present: " << (vkCtx.incrementalPresent ? "yes" : "no") << std::endl;
+        std::cout << "Transfer queue family: ";
+        if (transferFamily >= 0) {
+            std::cout << transferFamily << std::endl;
+        } else {
+            std::cout << "none (images upload on the render thread)" << std::endl;
+        }
+    }
+
+    VkDeviceCreateInfo deviceInfo{VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+    deviceInfo.queueCreateInfoCount = transferFamily >= 0 ? 2 : 1;
+    deviceInfo.pQueueCreateInfos = queueInfos;
+    deviceInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExts.size());
+    deviceInfo.ppEnabledExtensionNames = deviceExts.data();
+
+    if (vkCreateDevice(vkCtx.physicalDevice, &deviceInfo, hostAllocationCallbacks(vkCtx), &vkCtx.device) != VK_SUCCESS) {
+        std::cerr << "Failed to create device" << std::endl;
+        return false;
+    }
+    vkGetDeviceQueue(vkCtx.device, vkCtx.queueFamilyIndex, 0, &vkCtx.queue);
+    if (transferFamily >= 0) {
+        vkGetDeviceQueue(vkCtx.device, vkCtx.transferQueueFamilyIndex, 0, &vkCtx.transferQueue);
+    }
+    return true;
+}
+
+static const char *presentModeName(VkPresentModeKHR mode)
+{
+    switch (mode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:    return "IMMEDIATE";
+        case VK_PRESENT_MODE_MAILBOX_KHR:      return "MAILBOX";
+        case VK_PRESENT_MODE_FIFO_KHR:         return "FIFO";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO_RELAXED";
+        default:                               return "UNKNOWN";
+    }
+}
+
+static void chooseSurfaceFormat(VulkanContext &vkCtx)
+{
+    uint32_t formatCount;
+    vkGetPhysicalDeviceSurfaceFormatsKHR(vkCtx.physicalDevice, vkCtx.surface, &formatCount, nullptr);
+    std::vector<VkSurfaceFormatKHR> formats(formatCount);
+    vkGetPhysicalDeviceSurfaceFormatsKHR(vkCtx.physicalDevice, vkCtx.surface, &formatCount, formats.data());
+
+    // UNORM format 우선 (SRGB는 Skia wrap 설정이 어려움, 생성 실패할 수 있음)
+    vkCtx.format = formats[0].format;
+    vkCtx.colorSpace = formats[0].colorSpace;
+
+    for (const auto &fmt : formats)
+    {
+        if (vkCtx.verbose) {
+            std::cout << "Available: format=" << fmt.format << ", colorSpace=" << fmt.colorSpace << std::endl;
+        }
+        // BGRA UNORM 우선, 없으면 RGBA UNORM, 둘 다 없으면 첫 번째 format
+        if (fmt.format == VK_FORMAT_B8G8R8A8_UNORM || fmt.format == VK_FORMAT_R8G8B8A8_UNORM)
+        {
+            vkCtx.format = fmt.format;
+            vkCtx.colorSpace = fmt.colorSpace;
+            break;
+        }
+    }
+}
+
+// 요청한 present mode 가 없으면 항상 지원되는 FIFO 로 대체
+static VkPresentModeKHR choosePresentMode(const VulkanContext &vkCtx)
+{
+    uint32_t modeCount = 0;
+    vkGetPhysicalDeviceSurfacePresentModesKHR(vkCtx.physicalDevice, vkCtx.surface, &modeCount, nullptr);
+    std::vector<VkPresentModeKHR> modes(modeCount);
+    vkGetPhysicalDeviceSurfacePresentModesKHR(vkCtx.physicalDevice, vkCtx.surface, &modeCount, modes.data());
+
+    for (auto mode : modes) {
+        if (mode == vkCtx.requestedPresentMode) {
+            return mode;
+        }
+    }
+    std::cout << presentModeName(vkCtx.requestedPresentMode) << " not supported, fallback to FIFO" << std::endl;
+    return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+// vkCtx.swapchain 이 있으면 oldSwapchain 으로 넘기고, 새 swapchain 생성 후 파괴한다
+static bool createSwapchain(VulkanContext &vkCtx, uint32_t width, uint32_t height)
+{
+    // --- Swapchain ---
+    VkSurfaceCapabilitiesKHR surfCaps;
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(vkCtx.physicalDevice, vkCtx.surface, &surfCaps);
+
+    // currentExtent 가 0xFFFFFFFF 이면 surface 크기를 swapchain 이 결정
+    if (surfCaps.currentExtent.width != UINT32_MAX) {
+        vkCtx.extent = surfCaps.currentExtent;
+    } else {
+        vkCtx.extent.width = std::clamp(width, surfCaps.minImageExtent.width, surfCaps.maxImageExtent.width);
+        vkCtx.extent.height = std::clamp(height, surfCaps.minImageExtent.height, surfCaps.maxImageExtent.height);
+    }
+
+    uint32_t minImageCount = vkCtx.requestedImageCount ? vkCtx.requestedImageCount
+                                                       : surfCaps.minImageCount + 1;
+    minImageCount = std::max(minImageCount, surfCaps.minImageCount);
+    if (surfCaps.maxImageCount > 0) {
+        minImageCount = std::min(minImageCount, surfCaps.maxImageCount);
+    }
+    vkCtx.presentMode = choosePresentMode(vkCtx);
+
+    VkSwapchainKHR oldSwapchain = vkCtx.swapchain;
+
+    VkSwapchainCreateInfoKHR swapInfo{VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR};
+    swapInfo.surface = vkCtx.surface;
+    swapInfo.minImageCount = minImageCount;
+    swapInfo.imageFormat = vkCtx.format;
+    swapInfo.imageColorSpace = vkCtx.colorSpace;
+    swapInfo.imageExtent = vkCtx.extent;
+    swapInfo.imageArrayLayers = 1;
+    // readback(asyncRescaleAndReadPixels) 용 TRANSFER_SRC 는 surface 가 지원할 때만.
+    // MSAA 는 swapchain 이미지를 resolve 대상 texture 로 wrap 하므로 SAMPLED 도 필요
+    VkImageUsageFlags optionalUsage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    if (vkCtx.sampleCount > 1) {
+        optionalUsage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+    }
+    vkCtx.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | (surfCaps.supportedUsageFlags & optionalUsage);
+    swapInfo.imageUsage = vkCtx.imageUsage;
+    swapInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    swapInfo.preTransform = surfCaps.currentTransform;
+    swapInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+    swapInfo.presentMode = vkCtx.presentMode;
+    swapInfo.clipped = VK_TRUE;
+    swapInfo.oldSwapchain = oldSwapchain;
+
+    const VkAllocationCallbacks *callbacks = hostAllocationCallbacks(vkCtx);
+    VkResult result = vkCreateSwapchainKHR(vkCtx.device, &swapInfo, callbacks, &vkCtx.swapchain);
+    if (oldSwapchain != VK_NULL_HANDLE) {
+        vkDestroySwapchainKHR(vkCtx.device, oldSwapchain, callbacks);
+    }
+    if (result != VK_SUCCESS)
+    {
+        vkCtx.swapchain = VK_NULL_HANDLE;
+        std::cerr << "Failed to create swapchain\n";
+        return false;
+    }
+
+    uint32_t imageCount;
+    vkGetSwapchainImagesKHR(vkCtx.device, vkCtx.swapchain, &imageCount, nullptr);
+    vkCtx.images.resize(imageCount);
+    vkGetSwapchainImagesKHR(vkCtx.device, vkCtx.swapchain, &imageCount, vkCtx.images.data());
+
+    if (vkCtx.verbose) {
+        std::cout << "SurfCaps imageCount: " << surfCaps.minImageCount
+                  << ", Swapchain imageCount: " << imageCount
+                  << ", extent: " << vkCtx.extent.width << "x" << vkCtx.extent.height
+                  << ", presentMode: " << presentModeName(vkCtx.presentMode) << std::endl;
+    }
+    return true;
+}
+
+bool findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeBits, VkMemoryPropertyFlags flags,
+                    uint32_t *typeIndex)
+{
+    VkPhysicalDeviceMemoryProperties memProps;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProps);
+    for (uint32_t i = 0; i < memProps.memoryTypeCount; ++i) {
+        if ((typeBits & (1u << i)) && (memProps.memoryTypes[i].propertyFlags & flags) == flags) {
+            *typeIndex = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// swapchain 대신 사용할 offscreen 렌더 타깃 (headless).
+// --vk-allocator=pooled 면 Skia 의 이미지와 같은 allocator 에서 받아 memory 통계에 함께 잡힌다
+static bool createOffscreenImages(const VulkanConfig &config, VulkanContext &vkCtx)
+{
+    const VkAllocationCallbacks *callbacks = hostAllocationCallbacks(vkCtx);
+    vkCtx.format = VK_FORMAT_R8G8B8A8_UNORM;
+    vkCtx.extent = {config.width, config.height};
+
+    uint32_t count = std::max(1u, config.offscreenImageCount);
+    vkCtx.images.resize(count, VK_NULL_HANDLE);
+    vkCtx.imageMemory.resize(count, VK_NULL_HANDLE);
+    vkCtx.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                       VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    for (uint32_t i = 0; i < count; ++i) {
+        VkImageCreateInfo imageInfo{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = vkCtx.format;
+        imageInfo.extent = {vkCtx.extent.width, vkCtx.extent.height, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = vkCtx.imageUsage;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        if (vkCreateImage(vkCtx.device, &imageInfo, callbacks, &vkCtx.images[i]) != VK_SUCCESS) {
+            std::cerr << "Failed to create offscreen image " << i << std::endl;
+            return false;
+        }
+
+        if (vkCtx.memoryAllocator) {
+            skgpu::VulkanBackendMemory memory;
+            if (vkCtx.memoryAllocator->allocateImageMemory(
+                        vkCtx.images[i], skgpu::VulkanMemoryAllocator::kDedicatedAllocation_AllocationPropertyFlag,
+                        &memory) != VK_SUCCESS) {
+                std::cerr << "Failed to allocate offscreen image memory " << i << std::endl;
+                return false;
+            }
+            vkCtx.imageAllocations.push_back(memory);
+            skgpu::VulkanAlloc alloc;
+            vkCtx.memoryAllocator->getAllocInfo(memory, &alloc);
+            if (vkBindImageMemory(vkCtx.device, vkCtx.images[i], alloc.fMemory, alloc.fOffset) != VK_SUCCESS) {
+                std::cerr << "Failed to bind offscreen image memory " << i << std::endl;
+                return false;
+            }
+            continue;
+        }
+
+        VkMemoryRequirements memReqs;
+        vkGetImageMemoryRequirements(vkCtx.device, vkCtx.images[i], &memReqs);
+        VkMemoryAllocateInfo allocInfo{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+        allocInfo.allocationSize = memReqs.size;
+        // lavapipe 는 DEVICE_LOCAL 타입도 host 메모리이므로 그대로 사용 가능
+        if (!findMemoryType(vkCtx.physicalDevice, memReqs.memoryTypeBits,
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &allocInfo.memoryTypeIndex) &&
+            !findMemoryType(vkCtx.physicalDevice, memReqs.memoryTypeBits, 0, &allocInfo.memoryTypeIndex)) {
+            std::cerr << "No memory type for offscreen image" << std::endl;
+            return false;
+        }
+        if (vkAllocateMemory(vkCtx.device, &allocInfo, callbacks, &vkCtx.imageMemory[i]) != VK_SUCCESS ||
+            vkBindImageMemory(vkCtx.device, vkCtx.images[i], vkCtx.imageMemory[i], 0) != VK_SUCCESS) {
+            std::cerr << "Failed to allocate offscreen image memory " << i << std::endl;
+            return false;
+        }
+    }
+    if (vkCtx.verbose) {
+        std::cout << "Offscreen imageCount: " << count << std::endl;
+    }
+    return true;
+}
+
+SkColorType colorTypeForFormat(VkFormat format)
+{
+    if (format == VK_FORMAT_B8G8R8A8_UNORM || format == VK_FORMAT_B8G8R8A8_SRGB)
+    {
+        return kBGRA_8888_SkColorType;
+    }
+    return kRGBA_8888_SkColorType;
+}
+
+// 이미지별 SkSurface 는 처음 acquire 될 때 wrap 한다 (시작 시 전부 wrap 하지 않음)
+static void resetSurfaces(VulkanContext &vkCtx)
+{
+    vkCtx.skSurfaces.clear();
+    vkCtx.skSurfaces.resize(vkCtx.images.size());
+}
+
+SkSurface *surfaceForImage(VulkanContext &vkCtx, GrDirectContext *skContext, uint32_t index)
+{
+    if (index >= vkCtx.skSurfaces.size()) {
+        return nullptr;
+    }
+    if (vkCtx.skSurfaces[index]) {
+        return vkCtx.skSurfaces[index].get();
+    }
+
+    GrVkImageInfo imgInfo{};
+    imgInfo.fImage = vkCtx.images[index];
+    imgInfo.fImageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imgInfo.fImageTiling = VK_IMAGE_TILING_OPTIMAL;
+    imgInfo.fFormat = vkCtx.format;
+    imgInfo.fLevelCount = 1;
+    imgInfo.fSampleCount = 1;
+    imgInfo.fCurrentQueueFamily = vkCtx.queueFamilyIndex;
+    imgInfo.fImageUsageFlags = vkCtx.imageUsage;
+
+    SkSurfaceProps props(vkCtx.surfaceFlags, kUnknown_SkPixelGeometry);
+    if (vkCtx.sampleCount > 1) {
+        // 이미지는 resolve 대상, 그리기는 Skia 가 만드는 MSAA attachment 에
+        GrBackendTexture backendTex =
+                GrBackendTextures::MakeVk(vkCtx.extent.width, vkCtx.extent.height, imgInfo);
+        vkCtx.skSurfaces[index] = SkSurfaces::WrapBackendTexture(skContext, backendTex, kTopLeft_GrSurfaceOrigin,
+                                                                 vkCtx.sampleCount, colorTypeForFormat(vkCtx.format),
+                                                                 nullptr, &props);
+    } else {
+        GrBackendRenderTarget backendRT =
+                GrBackendRenderTargets::MakeVk(vkCtx.extent.width, vkCtx.extent.height, imgInfo);
+        if (!backendRT.isValid())
+        {
+            std::cerr << "Invalid GrBackendRenderTarget for image " << index << std::endl;
+            return nullptr;
+        }
+
+        vkCtx.skSurfaces[index] = SkSurfaces::WrapBackendRenderTarget(
+            skContext,
+            backendRT,
+            kTopLeft_GrSurfaceOrigin,
+            colorTypeForFormat(vkCtx.format),
+            nullptr, // colorSpace
+            &props
+        );
+    }
+    if (!vkCtx.skSurfaces[index])
+    {
+        std::cerr << "Failed to wrap surface " << index << std::endl;
+    }
+    return vkCtx.skSurfaces[index].get();
+}
+
+static bool createFrameSync(uint32_t framesInFlight, VulkanContext &vkCtx)
+{
+    VkSemaphoreCreateInfo semInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+    VkFenceCreateInfo fenceInfo{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+    // 첫 프레임에서 대기하지 않도록 signaled 상태로 생성
+    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    const VkAllocationCallbacks *callbacks = hostAllocationCallbacks(vkCtx);
+    vkCtx.frameIndex = 0;
+    vkCtx.frames.resize(std::max(1u, framesInFlight), FrameSync{VK_NULL_HANDLE, VK_NULL_HANDLE});
+    for (auto &frame : vkCtx.frames) {
+        if (!vkCtx.headless &&
+            vkCreateSemaphore(vkCtx.device, &semInfo, callbacks, &frame.acquireSemaphore) != VK_SUCCESS) {
+            std::cerr << "Failed to create acquire semaphore" << std::endl;
+            return false;
+        }
+        if (vkCreateFence(vkCtx.device, &fenceInfo, callbacks, &frame.fence) != VK_SUCCESS) {
+            std::cerr << "Failed to create frame fence" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void destroyRenderSemaphores(VulkanContext &vkCtx)
+{
+    for (auto sem : vkCtx.renderSemaphores) {
+        vkDestroySemaphore(vkCtx.device, sem, hostAllocationCallbacks(vkCtx));
+    }
+    vkCtx.renderSemaphores.clear();
+}
+
+// present 대기 semaphore 는 swapchain 이미지 단위로 두어야 재사용 시점이 보장됨
+static bool createRenderSemaphores(VulkanContext &vkCtx)
+{
+    VkSemaphoreCreateInfo semInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+    vkCtx.renderSemaphores.resize(vkCtx.images.size(), VK_NULL_HANDLE);
+    for (auto &sem : vkCtx.renderSemaphores) {
+        if (vkCreateSemaphore(vkCtx.device, &semInfo, hostAllocationCallbacks(vkCtx), &sem) != VK_SUCCESS) {
+            std::cerr << "Failed to create render semaphore" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void destroyFrameSync(VulkanContext &vkCtx)
+{
+    const VkAllocationCallbacks *callbacks = hostAllocationCallbacks(vkCtx);
+    for (auto &frame : vkCtx.frames) {
+        vkDestroySemaphore(vkCtx.device, frame.acquireSemaphore, callbacks);
+        vkDestroyFence(vkCtx.device, frame.fence, callbacks);
+    }
+    vkCtx.frames.clear();
+    destroyRenderSemaphores(vkCtx);
+}
+
+FrameSync &waitForFrameSlot(VulkanContext &vkCtx)
+{
+    FrameSync &frame = vkCtx.frames[vkCtx.frameIndex];
+    vkWaitForFences(vkCtx.device, 1, &frame.fence, VK_TRUE, UINT64_MAX);
+    return frame;
+}
+
+bool submitFrameFence(VulkanContext &vkCtx)
+{
+    FrameSync &frame = vkCtx.frames[vkCtx.frameIndex];
+    vkCtx.frameIndex = (vkCtx.frameIndex + 1) % vkCtx.frames.size();
+
+    // Skia 가 같은 큐에 먼저 제출했으므로 빈 submit 의 fence 는 그 작업 이후에 signal 됨
+    vkResetFences(vkCtx.device, 1, &frame.fence);
+    if (vkQueueSubmit(vkCtx.queue, 0, nullptr, frame.fence) != VK_SUCCESS) {
+        std::cerr << "Failed to submit frame fence" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// pipelineCacheUUID 와 드라이버 버전이 같아야 캐시된 SPIR-V / VkPipelineCache 를 재사용할 수 있다
+static std::string shaderCacheIdentity(VkPhysicalDevice physicalDevice)
+{
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    char ids[64];
+    snprintf(ids, sizeof(ids), "vk:%08x:%08x:%08x:", props.vendorID, props.deviceID, props.driverVersion);
+    return ids + uuidToString(props.pipelineCacheUUID);
+}
+
+bool createVulkanInstance(const VulkanConfig &config, VulkanContext &vkCtx)
+{
+    StartupPhase phase("vk instance");
+    vkCtx.headless = config.headless;
+    vkCtx.verbose = config.verbose;
+    if (config.memory.trackHost && !vkCtx.hostTracker) {
+        vkCtx.hostTracker = std::make_unique<VkHostAllocationTracker>();
+    }
+    return createInstance(config.headless, vkCtx);
+}
+
+bool setupVulkan(GLFWwindow *window, const VulkanConfig &config, VulkanContext &vkCtx,
+                 sk_sp<GrDirectContext> &skContext)
+{
+    vkCtx.headless = config.headless;
+    vkCtx.verbose = config.verbose;
+    vkCtx.surface = VK_NULL_HANDLE;
+    vkCtx.swapchain = VK_NULL_HANDLE;
+
+    // 창 생성과 병렬로 createVulkanInstance() 를 이미 불렀으면 건너뜀
+    if (vkCtx.instance == VK_NULL_HANDLE && !createVulkanInstance(config, vkCtx)) {
+        return false;
+    }
+
+    // --- Vulkan Surface via GLFW ---
+    if (!vkCtx.headless) {
+        StartupPhase phase("vk surface");
+        if (glfwCreateWindowSurface(vkCtx.instance, window, hostAllocationCallbacks(vkCtx), &vkCtx.surface) !=
+            VK_SUCCESS)
+        {
+            std::cerr << "Failed to create GLFW Vulkan surface\n";
+            return false;
+        }
+    }
+
+    DeviceSelection selection = config.device;
+    if (vkCtx.headless) {
+        // 렌더팜 노드는 GPU 가 없으므로 software device 도 후보로 둔다
+        selection.allowCpu = true;
+    }
+    {
+        StartupPhase phase("vk select device");
+        if (!selectPhysicalDevice(selection, vkCtx)) {
+            return false;
+        }
+    }
+
+    // 캐시 디렉터리는 디바이스별이므로 선택 직후부터 디바이스/swapchain 생성과 병렬로 읽는다
+    std::future<void> cachePreload;
+    if (!config.shaderCacheDir.empty()) {
+        vkCtx.shaderCache = std::make_unique<DiskShaderCache>(config.shaderCacheDir,
+                                                              shaderCacheIdentity(vkCtx.physicalDevice));
+        if (vkCtx.shaderCache->isValid()) {
+            DiskShaderCache *cache = vkCtx.shaderCache.get();
+            cachePreload = std::async(std::launch::async, [cache] {
+                StartupPhase phase("shader cache preload");
+                cache->preload();
+            });
+        }
+    }
+
+    {
+        StartupPhase phase("vk device");
+        if (!createDevice(vkCtx)) {
+            return false;
+        }
+    }
+
+    // headless offscreen 이미지도 같은 allocator 에서 받으므로 render target 보다 먼저 만든다
+    if (config.memory.pooled) {
+        vkCtx.memoryAllocator = VkPoolMemoryAllocator::Make(vkCtx.physicalDevice, vkCtx.device,
+                                                            hostAllocationCallbacks(vkCtx), config.memory);
+    }
+
+    vkCtx.requestedPresentMode = config.presentMode;
+    vkCtx.requestedImageCount = config.imageCount;
+    vkCtx.sampleCount = config.aa.sampleCount();
+    vkCtx.surfaceFlags = config.aa.surfaceFlags();
+    {
+        StartupPhase phase(vkCtx.headless ? "offscreen images" : "swapchain");
+        if (!vkCtx.headless) {
+            chooseSurfaceFormat(vkCtx);
+        }
+        bool targetsCreated = vkCtx.headless ? createOffscreenImages(config, vkCtx)
+                                             : createSwapchain(vkCtx, config.width, config.height);
+        if (!targetsCreated || !createFrameSync(config.framesInFlight, vkCtx) ||
+            (!vkCtx.headless && !createRenderSemaphores(vkCtx))) {
+            return false;
+        }
+    }
+
+    // --- Skia Vulkan Context ---
+    skgpu::VulkanBackendContext backendContext{};
+    backendContext.fInstance = vkCtx.instance;
+    backendContext.fPhysicalDevice = vkCtx.physicalDevice;
+    backendContext.fDevice = vkCtx.device;
+    backendContext.fQueue = vkCtx.queue;
+    backendContext.fGraphicsQueueIndex = vkCtx.queueFamilyIndex;
+    backendContext.fMaxAPIVersion = vkCtx.apiVersion;
+    backendContext.fGetProc = [](const char *procName, VkInstance inst, VkDevice dev) -> PFN_vkVoidFunction
+    {
+        PFN_vkVoidFunction func = nullptr;
+        if (dev != VK_NULL_HANDLE)
+        {
+            func = vkGetDeviceProcAddr(dev, procName);
+        }
+        if (!func && inst != VK_NULL_HANDLE)
+        {
+            func = vkGetInstanceProcAddr(inst, procName);
+        }
+        if (!func)
+        {
+            func = vkGetInstanceProcAddr(VK_NULL_HANDLE, procName);
+        }
+        return func;
+    };
+    backendContext.fMemoryAllocator = vkCtx.memoryAllocator;
+
+    GrContextOptions options;
+    if (cachePreload.valid()) {
+        // Skia 가 context 생성 중에 VkPipelineCache 데이터를 load 하므로 그 전에 합류
+        cachePreload.wait();
+        options.fPersistentCache = vkCtx.shaderCache.get();
+        options.fShaderCacheStrategy = GrContextOptions::ShaderCacheStrategy::kBackendBinary;
+    }
+    config.aa.apply(&options);
+
+    {
+        StartupPhase phase("skia context");
+        skContext = GrDirectContexts::MakeVulkan(backendContext, options);
+    }
+    if (!skContext)
+    {
+        std::cerr << "Failed to create Skia Vulkan context\n";
+        return false;
+    }
+
+    if (vkCtx.sampleCount > 1) {
+        // 디바이스 최대치로 제한, swapchain 이 SAMPLED 를 지원하지 않으면 MSAA 불가
+        int maxSamples = skContext->maxSurfaceSampleCountForColorType(colorTypeForFormat(vkCtx.format));
+        if (!(vkCtx.imageUsage & VK_IMAGE_USAGE_SAMPLED_BIT) || maxSamples <= 1) {
+            std::cerr << "MSAA unavailable for this surface, falling back to coverage AA" << std::endl;
+            vkCtx.sampleCount = 1;
+        } else {
+            vkCtx.sampleCount = std::min(vkCtx.sampleCount, maxSamples);
+        }
+    }
+
+    resetSurfaces(vkCtx);
+    std::cout << "Vulkan: " << vkCtx.deviceName << ", " << vkCtx.images.size() << " images "
+              << vkCtx.extent.width << "x" << vkCtx.extent.height;
+    if (!vkCtx.headless) {
+        std::cout << ", " << presentModeName(vkCtx.presentMode);
+    }
+    std::cout << ", " << vkCtx.frames.size() << " frames in flight";
+    if (vkCtx.sampleCount > 1) {
+        std::cout << ", msaa" << vkCtx.sampleCount;
+    } else if (vkCtx.surfaceFlags & SkSurfaceProps::kDynamicMSAA_Flag) {
+        std::cout << ", dmsaa";
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+bool recreateSwapchain(VulkanContext &vkCtx, GrDirectContext *skContext, uint32_t width, uint32_t height)
+{
+    // 이전 이미지를 참조하는 작업이 모두 끝난 뒤에 surface 를 교체 (GrDirectContext 는 유지)
+    skContext->flushAndSubmit(GrSyncCpu::kYes);
+    vkDeviceWaitIdle(vkCtx.device);
+
+    vkCtx.skSurfaces.clear();
+    destroyRenderSemaphores(vkCtx);
+
+    if (!createSwapchain(vkCtx, width, height) || !createRenderSemaphores(vkCtx)) {
+        return false;
+    }
+    resetSurfaces(vkCtx);
+    return true;
+}
+
+void destroyVulkan(VulkanContext &vkCtx, sk_sp<GrDirectContext> &skContext)
+{
+    for (auto &s : vkCtx.skSurfaces)
+        s.reset();
+    vkCtx.skSurfaces.clear();
+
+    // setup 중간에 실패한 경우에도 만들어진 것만 정리
+    if (vkCtx.device != VK_NULL_HANDLE) {
+        vkDeviceWaitIdle(vkCtx.device);
+        if (skContext && vkCtx.shaderCache) {
+            // 이번 실행에서 만든 pipeline 들을 다음 실행을 위해 persistent cache 로 내보냄
+            skContext->storeVkPipelineCacheData();
+        }
+        skContext.reset();
+        destroyFrameSync(vkCtx);
+
+        const VkAllocationCallbacks *callbacks = hostAllocationCallbacks(vkCtx);
+        if (vkCtx.headless) {
+            for (size_t i = 0; i < vkCtx.images.size(); ++i) {
+                vkDestroyImage(vkCtx.device, vkCtx.images[i], callbacks);
+                vkFreeMemory(vkCtx.device, vkCtx.imageMemory[i], callbacks);
+            }
+            for (skgpu::VulkanBackendMemory memory : vkCtx.imageAllocations) {
+                vkCtx.memoryAllocator->freeMemory(memory);
+            }
+        } else if (vkCtx.swapchain != VK_NULL_HANDLE) {
+            vkDestroySwapchainKHR(vkCtx.device, vkCtx.swapchain, callbacks);
+        }
+        // Skia 가 들고 있던 할당은 context 와 함께 돌아왔으므로 block 만 해제
+        vkCtx.memoryAllocator.reset();
+        vkDestroyDevice(vkCtx.device, hostAllocationCallbacks(vkCtx));
+    }
+    skContext.reset();
+    vkCtx.memoryAllocator.reset();
+    vkCtx.shaderCache.reset();
+    vkCtx.images.clear();
+    vkCtx.imageMemory.clear();
+    vkCtx.imageAllocations.clear();
+    vkCtx.swapchain = VK_NULL_HANDLE;
+    vkCtx.device = VK_NULL_HANDLE;
+
+    if (vkCtx.instance != VK_NULL_HANDLE) {
+        if (vkCtx.surface != VK_NULL_HANDLE) {
+            vkDestroySurfaceKHR(vkCtx.instance, vkCtx.surface, hostAllocationCallbacks(vkCtx));
+        }
+        vkDestroyInstance(vkCtx.instance, hostAllocationCallbacks(vkCtx));
+    }
+    vkCtx.surface = VK_NULL_HANDLE;
+    vkCtx.instance = VK_NULL_HANDLE;
+    vkCtx.hostTracker.reset();
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSurface.h"
+#include "include/gpu/ganesh/GrDirectContext.h"
+
+#include "aa_mode.h"
+#include "shader_cache.h"
+#include "vk_memory_allocator.h"
+
+struct GLFWwindow;
+
+#define WIDTH 800
+#define HEIGHT 600
+
+// Physical device 선택 정책
+enum class DevicePreference
+{
+    kAuto,       // discrete > integrated > virtual > cpu
+    kDiscrete,
+    kIntegrated,
+    kCpu,        // lavapipe / llvmpipe 강제
+};
+
+struct DeviceSelection
+{
+    DevicePreference preference = DevicePreference::kAuto;
+    bool allowCpu = false;    // VK_PHYSICAL_DEVICE_TYPE_CPU 후보 포함 여부
+    std::string forcedName;   // deviceName 부분 문자열 일치
+    std::string forcedUuid;   // deviceUUID (hex 32자리, '-' 무시)
+};
+
+struct VulkanConfig
+{
+    bool headless = false;
+    uint32_t width = WIDTH;
+    uint32_t height = HEIGHT;
+    uint32_t offscreenImageCount = 2;   // headless 모드의 렌더 타깃 개수
+    uint32_t framesInFlight = 2;        // CPU 가 GPU 보다 앞서 기록할 수 있는 최대 프레임 수
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    uint32_t imageCount = 0;            // swapchain 최소 이미지 수, 0 이면 minImageCount + 1
+    DeviceSelection device;
+    std::string shaderCacheDir;         // 비어 있으면 persistent shader/pipeline cache 사용 안 함
+    AaOptions aa;                       // MSAA / DMSAA / coverage AA
+    VkMemoryOptions memory;             // device memory allocator / host allocation 추적
+    bool verbose = false;               // device / format 후보 등 상세 로그
+};
+
+// frame-in-flight 슬롯마다 하나씩
+struct FrameSync
+{
+    VkSemaphore acquireSemaphore;   // vkAcquireNextImageKHR -> Skia wait
+    VkFence fence;                  // 이 슬롯에서 제출한 작업 완료 시 signal
+};
+
+// 구조체로 Vulkan 객체 관리
+struct VulkanContext
+{
+    VkInstance instance;
+    VkPhysicalDevice physicalDevice;
+    std::string deviceName;
+    VkDevice device;
+    VkSurfaceKHR surface;
+    VkQueue queue;
+    uint32_t queueFamilyIndex;
+    VkQueue transferQueue;              // graphics 와 다른 transfer 전용 family 의 큐 (없으면 VK_NULL_HANDLE)
+    uint32_t transferQueueFamilyIndex;  // 없으면 VK_QUEUE_FAMILY_IGNORED
+    uint32_t apiVersion;
+    VkSwapchainKHR swapchain;
+    VkPresentModeKHR requestedPresentMode;
+    VkPresentModeKHR presentMode;
+    uint32_t requestedImageCount;
+    VkFormat format;
+    VkColorSpaceKHR colorSpace;
+    VkExtent2D extent;
+    VkImageUsageFlags imageUsage;   // swapchain / offscreen 이미지 usage (Skia wrap 시 그대로 전달)
+    int sampleCount;                // > 1 이면 이미지를 texture 로 wrap 해서 Skia 가 MSAA attachment 에 그린 뒤 resolve
+    uint32_t surfaceFlags;          // SkSurfaceProps flags (DMSAA)
+    VkCommandPool cmdPool;
+    bool headless;
+    bool verbose;
+    bool incrementalPresent;   // VK_KHR_incremental_present 활성화 여부
+    std::vector<VkImage> images;
+    std::vector<VkDeviceMemory> imageMemory;   // headless 이미지에만 사용
+    std::vector<skgpu::VulkanBackendMemory> imageAllocations;  // headless 이미지를 memoryAllocator 에서 받았을 때
+    std::vector<sk_sp<SkSurface>> skSurfaces;  // surfaceForImage() 가 처음 쓸 때 wrap
+    std::vector<VkSemaphore> renderSemaphores;  // swapchain 이미지마다: Skia signal -> present wait
+    std::vector<FrameSync> frames;
+    uint32_t frameIndex;
+    std::unique_ptr<DiskShaderCache> shaderCache;   // GrDirectContext 보다 오래 살아야 함
+    sk_sp<VkPoolMemoryAllocator> memoryAllocator;    // --vk-allocator=pooled 일 때만, device 보다 먼저 해제
+    std::unique_ptr<VkHostAllocationTracker> hostTracker;  // instance 보다 오래 살아야 함
+};
+
+// instance 만 생성. 창 생성(glfwCreateWindow)과 다른 스레드에서 병렬로 부를 수 있다
+bool createVulkanInstance(const VulkanConfig &config, VulkanContext &vkCtx);
+// instance 가 없으면 만들고, surface / device / swapchain / Skia context 까지 생성
+bool setupVulkan(GLFWwindow *window, const VulkanConfig &config, VulkanContext &vkCtx,
+                 sk_sp<GrDirectContext> &skContext);
+void destroyVulkan(VulkanContext &vkCtx, sk_sp<GrDirectContext> &skContext);
+
+// resize / VK_ERROR_OUT_OF_DATE_KHR / VK_SUBOPTIMAL_KHR 시 호출.
+// oldSwapchain 을 넘겨 재생성하고 skSurfaces 만 다시 wrap 한다.
+bool recreateSwapchain(VulkanContext &vkCtx, GrDirectContext *skContext, uint32_t width, uint32_t height);
+
+// 현재 슬롯의 이전 제출이 끝날 때까지 대기 (fence 는 아직 reset 하지 않음)
+FrameSync &waitForFrameSlot(VulkanContext &vkCtx);
+// Skia submit 이후 호출: 현재 슬롯 fence 를 reset 하고 큐에 signal 을 건 뒤 다음 슬롯으로 이동
+bool submitFrameFence(VulkanContext &vkCtx);
+
+SkColorType colorTypeForFormat(VkFormat format);
+
+// instance / device / pooled allocator 에 넘기는 host allocation callbacks (추적하지 않으면 nullptr)
+const VkAllocationCallbacks *hostAllocationCallbacks(const VulkanContext &vkCtx);
+// pooled allocator 와 host 추적 통계 (켜져 있는 것만)
+void printVulkanMemoryStats(const VulkanContext &vkCtx, std::ostream &os);
+
+// typeBits 중 flags 를 모두 가진 메모리 타입
+bool findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeBits, VkMemoryPropertyFlags flags,
+                    uint32_t *typeIndex);
+
+// index 번째 이미지의 SkSurface. 처음 요청될 때 wrap 한다 (실패 시 nullptr)
+SkSurface *surfaceForImage(VulkanContext &vkCtx, GrDirectContext *skContext, uint32_t index);
@@ -0,0 +1,156 @@
+#include "vk_gpu_timer.h"
+
+#include <iostream>
+
+#include "vk_context.h"
+
+bool VkGpuTimer::init(VulkanContext &vkCtx)
+{
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(vkCtx.physicalDevice, &props);
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(vkCtx.physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(vkCtx.physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    uint32_t validBits = queueFamilies[vkCtx.queueFamilyIndex].timestampValidBits;
+    if (validBits == 0 || props.limits.timestampPeriod == 0.0f) {
+        std::cout << "GPU timestamps not supported on this queue" << std::endl;
+        return false;
+    }
+    fPeriodNs = props.limits.timestampPeriod;
+    fValidMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+
+    fCallbacks = hostAllocationCallbacks(vkCtx);
+    VkCommandPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    poolInfo.queueFamilyIndex = vkCtx.queueFamilyIndex;
+    if (vkCreateCommandPool(vkCtx.device, &poolInfo, fCallbacks, &fCmdPool) != VK_SUCCESS) {
+        std::cerr << "Failed to create timer command pool" << std::endl;
+        return false;
+    }
+
+    uint32_t slotCount = static_cast<uint32_t>(vkCtx.frames.size());
+    VkQueryPoolCreateInfo queryInfo{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    queryInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryInfo.queryCount = slotCount * 2;
+    if (vkCreateQueryPool(vkCtx.device, &queryInfo, fCallbacks, &fQueryPool) != VK_SUCCESS) {
+        std::cerr << "Failed to create timestamp query pool" << std::endl;
+        destroy(vkCtx.device);
+        return false;
+    }
+
+    std::vector<VkCommandBuffer> cmds(slotCount * 2);
+    VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    allocInfo.commandPool = fCmdPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = slotCount * 2;
+    if (vkAllocateCommandBuffers(vkCtx.device, &allocInfo, cmds.data()) != VK_SUCCESS) {
+        std::cerr << "Failed to allocate timer command buffers" << std::endl;
+        destroy(vkCtx.device);
+        return false;
+    }
+
+    // 내용이 매 프레임 같으므로 한 번만 기록하고 재제출 (슬롯 fence 로 재사용 시점 보장)
+    fSlots.resize(slotCount);
+    VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    VkSemaphoreCreateInfo semaphoreInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+    for (uint32_t i = 0; i < slotCount; ++i) {
+        Slot &slot = fSlots[i];
+        slot.beginCmd = cmds[i * 2];
+        slot.endCmd = cmds[i * 2 + 1];
+        if (vkCreateSemaphore(vkCtx.device, &semaphoreInfo, fCallbacks, &slot.started) != VK_SUCCESS) {
+            std::cerr << "Failed to create timer semaphore" << std::endl;
+            destroy(vkCtx.device);
+            return false;
+        }
+
+        vkBeginCommandBuffer(slot.beginCmd, &beginInfo);
+        vkCmdResetQueryPool(slot.beginCmd, fQueryPool, i * 2, 2);
+        vkCmdWriteTimestamp(slot.beginCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, fQueryPool, i * 2);
+        vkEndCommandBuffer(slot.beginCmd);
+
+        vkBeginCommandBuffer(slot.endCmd, &beginInfo);
+        vkCmdWriteTimestamp(slot.endCmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, fQueryPool, i * 2 + 1);
+        vkEndCommandBuffer(slot.endCmd);
+    }
+    return true;
+}
+
+void VkGpuTimer::destroy(VkDevice device)
+{
+    for (Slot &slot : fSlots) {
+        if (slot.started != VK_NULL_HANDLE) {
+            vkDestroySemaphore(device, slot.started, fCallbacks);
+        }
+    }
+    if (fCmdPool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(device, fCmdPool, fCallbacks);
+        fCmdPool = VK_NULL_HANDLE;
+    }
+    if (fQueryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(device, fQueryPool, fCallbacks);
+        fQueryPool = VK_NULL_HANDLE;
+    }
+    fSlots.clear();
+}
+
+bool VkGpuTimer::collect(VkDevice device, uint32_t slotIndex, uint64_t *frame, double *gpuMs)
+{
+    if (!isValid() || slotIndex >= fSlots.size() || !fSlots[slotIndex].pending) {
+        return false;
+    }
+    Slot &slot = fSlots[slotIndex];
+    slot.pending = false;
+
+    uint64_t timestamps[2] = {};
+    VkResult result = vkGetQueryPoolResults(device, fQueryPool, slotIndex * 2, 2, sizeof(timestamps),
+                                            timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) {
+        return false;
+    }
+    uint64_t ticks = ((timestamps[1] & fValidMask) - (timestamps[0] & fValidMask)) & fValidMask;
+    *frame = slot.frame;
+    *gpuMs = ticks * fPeriodNs / 1e6;
+    return true;
+}
+
+static bool submitCommandBuffer(VkQueue queue, VkCommandBuffer cmd, VkSemaphore wait = VK_NULL_HANDLE,
+                                VkSemaphore signal = VK_NULL_HANDLE)
+{
+    const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    if (wait != VK_NULL_HANDLE) {
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &wait;
+        submitInfo.pWaitDstStageMask = &waitStage;
+    }
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+    if (signal != VK_NULL_HANDLE) {
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &signal;
+    }
+    return vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) == VK_SUCCESS;
+}
+
+bool VkGpuTimer::begin(VkQueue queue, uint32_t slotIndex, uint64_t frame, VkSemaphore waitSemaphore)
+{
+    if (!isValid() || slotIndex >= fSlots.size()) {
+        return false;
+    }
+    Slot &slot = fSlots[slotIndex];
+    slot.frame = frame;
+    // acquire 대기를 이 submit 이 흡수하고, Skia 는 signal 된 started 를 기다려 순서를 이어받는다
+    VkSemaphore signal = waitSemaphore != VK_NULL_HANDLE ? slot.started : VK_NULL_HANDLE;
+    return submitCommandBuffer(queue, slot.beginCmd, waitSemaphore, signal);
+}
+
+bool VkGpuTimer::end(VkQueue queue, uint32_t slotIndex)
+{
+    if (!isValid() || slotIndex >= fSlots.size()) {
+        return false;
+    }
+    fSlots[slotIndex].pending = submitCommandBuffer(queue, fSlots[slotIndex].endCmd);
+    return fSlots[slotIndex].pending;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+struct VulkanContext;
+
+// frame-in-flight 슬롯별 timestamp query 로 Skia 가 제출한 작업의 GPU 시간을 잰다.
+// Skia 의 submit 앞뒤로 timestamp 만 쓰는 command buffer 를 같은 큐에 제출한다.
+// 창 모드에서는 begin 쪽 submit 이 acquire semaphore 를 대신 기다리므로
+// 측정값에 acquire(vsync) 대기 시간이 섞이지 않는다.
+class VkGpuTimer
+{
+public:
+    bool init(VulkanContext &vkCtx);
+    void destroy(VkDevice device);
+
+    bool isValid() const { return fQueryPool != VK_NULL_HANDLE; }
+
+    // waitForFrameSlot() 이후 호출: 이 슬롯에서 이전에 잰 결과를 가져온다.
+    // 결과가 없으면 false. frame 은 begin() 때 넘긴 번호.
+    bool collect(VkDevice device, uint32_t slot, uint64_t *frame, double *gpuMs);
+
+    // Skia submit 직전/직후에 호출. waitSemaphore 를 넘기면 begin timestamp 를 쓰기 전에
+    // 그 semaphore 를 기다리고 startedSemaphore(slot) 을 signal 한다. 이때 Skia 는
+    // waitSemaphore 대신 startedSemaphore(slot) 을 기다려야 한다 (binary semaphore 는 한 번만 wait 가능).
+    bool begin(VkQueue queue, uint32_t slot, uint64_t frame, VkSemaphore waitSemaphore = VK_NULL_HANDLE);
+    bool end(VkQueue queue, uint32_t slot);
+
+    VkSemaphore startedSemaphore(uint32_t slot) const { return fSlots[slot].started; }
+
+private:
+    struct Slot
+    {
+        VkCommandBuffer beginCmd = VK_NULL_HANDLE;
+        VkCommandBuffer endCmd = VK_NULL_HANDLE;
+        VkSemaphore started = VK_NULL_HANDLE;
+        uint64_t frame = 0;
+        bool pending = false;
+    };
+
+    VkQueryPool fQueryPool = VK_NULL_HANDLE;
+    VkCommandPool fCmdPool = VK_NULL_HANDLE;
+    const VkAllocationCallbacks *fCallbacks = nullptr;
+    double fPeriodNs = 1.0;
+    uint64_t fValidMask = ~0ull;
+    std::vector<Slot> fSlots;
+};
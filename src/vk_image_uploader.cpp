@@ -0,0 +1,310 @@
+#include "vk_image_uploader.h"
+
+#include <cstring>
+#include <iostream>
+
+#include "include/core/SkImage.h"
+#include "include/gpu/ganesh/GrBackendSurface.h"
+#include "include/gpu/ganesh/GrDirectContext.h"
+#include "include/gpu/ganesh/SkImageGanesh.h"
+#include "include/gpu/ganesh/vk/GrVkBackendSurface.h"
+#include "include/gpu/ganesh/vk/GrVkTypes.h"
+
+#include "vk_context.h"
+
+// decode 가 업로드보다 앞서 나갈 수 있는 이미지 수 (pixel buffer 사용량 상한)
+static constexpr size_t kInputDepth = 8;
+static constexpr VkFormat kTextureFormat = VK_FORMAT_R8G8B8A8_UNORM;
+static constexpr VkImageUsageFlags kTextureUsage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                                   VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+
+std::unique_ptr<VkImageUploader> VkImageUploader::Make(const VulkanContext &vkCtx, PixelBufferPool *pool)
+{
+    if (vkCtx.transferQueue == VK_NULL_HANDLE) {
+        return nullptr;
+    }
+    std::unique_ptr<VkImageUploader> uploader(new VkImageUploader(vkCtx, pool));
+    if (!uploader->init()) {
+        return nullptr;
+    }
+    return uploader;
+}
+
+VkImageUploader::VkImageUploader(const VulkanContext &vkCtx, PixelBufferPool *pool)
+    : fDevice(vkCtx.device)
+    , fPhysicalDevice(vkCtx.physicalDevice)
+    , fQueue(vkCtx.transferQueue)
+    , fQueueFamily(vkCtx.transferQueueFamilyIndex)
+    , fGraphicsQueueFamily(vkCtx.queueFamilyIndex)
+    , fCallbacks(hostAllocationCallbacks(vkCtx))
+    , fPool(pool)
+    , fInput(kInputDepth)
+{
+}
+
+bool VkImageUploader::init()
+{
+    VkCommandPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = fQueueFamily;
+    if (vkCreateCommandPool(fDevice, &poolInfo, fCallbacks, &fCmdPool) != VK_SUCCESS) {
+        std::cerr << "Failed to create transfer command pool" << std::endl;
+        return false;
+    }
+    VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    allocInfo.commandPool = fCmdPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+    VkFenceCreateInfo fenceInfo{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+    if (vkAllocateCommandBuffers(fDevice, &allocInfo, &fCmd) != VK_SUCCESS ||
+        vkCreateFence(fDevice, &fenceInfo, fCallbacks, &fFence) != VK_SUCCESS) {
+        std::cerr << "Failed to create transfer command buffer" << std::endl;
+        return false;
+    }
+    fThread = std::thread(&VkImageUploader::threadLoop, this);
+    return true;
+}
+
+VkImageUploader::~VkImageUploader()
+{
+    fInput.close();
+    if (fThread.joinable()) {
+        fThread.join();
+    }
+    // render 스레드가 가져가지 않은 텍스처
+    for (UploadedTexture &texture : fDone) {
+        destroyTexture(texture);
+    }
+    if (fStaging != VK_NULL_HANDLE) {
+        vkDestroyBuffer(fDevice, fStaging, fCallbacks);
+        vkFreeMemory(fDevice, fStagingMemory, fCallbacks);
+    }
+    if (fFence != VK_NULL_HANDLE) {
+        vkDestroyFence(fDevice, fFence, fCallbacks);
+    }
+    if (fCmdPool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(fDevice, fCmdPool, fCallbacks);
+    }
+}
+
+void VkImageUploader::enqueue(DecodedImage image)
+{
+    // 종료 중이면 버려진다 (버퍼는 그냥 해제)
+    fInput.push(std::move(image));
+}
+
+void VkImageUploader::collect(std::vector<UploadedTexture> *out)
+{
+    std::lock_guard<std::mutex> lock(fDoneMutex);
+    out->insert(out->end(), fDone.begin(), fDone.end());
+    fDone.clear();
+}
+
+void VkImageUploader::threadLoop()
+{
+    DecodedImage image;
+    while (fInput.pop(image)) {
+        UploadedTexture texture = upload(image);
+        fPool->release(std::move(image.pixels));
+        std::lock_guard<std::mutex> lock(fDoneMutex);
+        fDone.push_back(texture);
+    }
+}
+
+bool VkImageUploader::ensureStaging(VkDeviceSize size)
+{
+    if (size <= fStagingSize) {
+        return true;
+    }
+    if (fStaging != VK_NULL_HANDLE) {
+        vkDestroyBuffer(fDevice, fStaging, fCallbacks);
+        vkFreeMemory(fDevice, fStagingMemory, fCallbacks);
+        fStaging = VK_NULL_HANDLE;
+        fStagingSize = 0;
+    }
+    VkBufferCreateInfo bufferInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bufferInfo.size = size;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (vkCreateBuffer(fDevice, &bufferInfo, fCallbacks, &fStaging) != VK_SUCCESS) {
+        return false;
+    }
+    VkMemoryRequirements memReqs;
+    vkGetBufferMemoryRequirements(fDevice, fStaging, &memReqs);
+    VkMemoryAllocateInfo allocInfo{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    allocInfo.allocationSize = memReqs.size;
+    if (!findMemoryType(fPhysicalDevice, memReqs.memoryTypeBits,
+                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                        &allocInfo.memoryTypeIndex) ||
+        vkAllocateMemory(fDevice, &allocInfo, fCallbacks, &fStagingMemory) != VK_SUCCESS) {
+        vkDestroyBuffer(fDevice, fStaging, fCallbacks);
+        fStaging = VK_NULL_HANDLE;
+        return false;
+    }
+    if (vkBindBufferMemory(fDevice, fStaging, fStagingMemory, 0) != VK_SUCCESS ||
+        vkMapMemory(fDevice, fStagingMemory, 0, VK_WHOLE_SIZE, 0, &fStagingPtr) != VK_SUCCESS) {
+        vkDestroyBuffer(fDevice, fStaging, fCallbacks);
+        vkFreeMemory(fDevice, fStagingMemory, fCallbacks);
+        fStaging = VK_NULL_HANDLE;
+        return false;
+    }
+    fStagingSize = size;
+    return true;
+}
+
+void VkImageUploader::destroyTexture(UploadedTexture &texture)
+{
+    if (texture.image != VK_NULL_HANDLE) {
+        vkDestroyImage(fDevice, texture.image, fCallbacks);
+    }
+    if (texture.memory != VK_NULL_HANDLE) {
+        vkFreeMemory(fDevice, texture.memory, fCallbacks);
+    }
+    texture.image = VK_NULL_HANDLE;
+    texture.memory = VK_NULL_HANDLE;
+}
+
+UploadedTexture VkImageUploader::upload(DecodedImage &decoded)
+{
+    UploadedTexture texture;
+    texture.id = decoded.id;
+    texture.width = decoded.info.width();
+    texture.height = decoded.info.height();
+    if (decoded.failed) {
+        return texture;
+    }
+
+    const size_t tightRowBytes = decoded.info.minRowBytes();
+    const VkDeviceSize size = tightRowBytes * texture.height;
+    if (!ensureStaging(size)) {
+        std::cerr << "Failed to allocate staging buffer (" << size << " bytes)" << std::endl;
+        return texture;
+    }
+    for (int y = 0; y < texture.height; ++y) {
+        memcpy(static_cast<uint8_t *>(fStagingPtr) + y * tightRowBytes,
+               decoded.pixels.data.get() + y * decoded.rowBytes, tightRowBytes);
+    }
+
+    VkImageCreateInfo imageInfo{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = kTextureFormat;
+    imageInfo.extent = {static_cast<uint32_t>(texture.width), static_cast<uint32_t>(texture.height), 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = kTextureUsage;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (vkCreateImage(fDevice, &imageInfo, fCallbacks, &texture.image) != VK_SUCCESS) {
+        std::cerr << "Failed to create texture image " << texture.width << "x" << texture.height << std::endl;
+        texture.image = VK_NULL_HANDLE;
+        return texture;
+    }
+    VkMemoryRequirements memReqs;
+    vkGetImageMemoryRequirements(fDevice, texture.image, &memReqs);
+    VkMemoryAllocateInfo allocInfo{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    allocInfo.allocationSize = memReqs.size;
+    if ((!findMemoryType(fPhysicalDevice, memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                         &allocInfo.memoryTypeIndex) &&
+         !findMemoryType(fPhysicalDevice, memReqs.memoryTypeBits, 0, &allocInfo.memoryTypeIndex)) ||
+        vkAllocateMemory(fDevice, &allocInfo, fCallbacks, &texture.memory) != VK_SUCCESS ||
+        vkBindImageMemory(fDevice, texture.image, texture.memory, 0) != VK_SUCCESS) {
+        std::cerr << "Failed to allocate texture memory" << std::endl;
+        destroyTexture(texture);
+        return texture;
+    }
+    texture.size = memReqs.size;
+
+    VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkResetCommandBuffer(fCmd, 0);
+    vkBeginCommandBuffer(fCmd, &beginInfo);
+
+    VkImageMemoryBarrier barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = texture.image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    vkCmdPipelineBarrier(fCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, 1, &barrier);
+
+    VkBufferImageCopy region{};
+    region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.imageExtent = imageInfo.extent;
+    vkCmdCopyBufferToImage(fCmd, fStaging, texture.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    // layout 전환은 transfer 큐 안에서 먼저 끝내고, ownership release 는 layout 을 바꾸지 않는다.
+    // Skia 의 acquire barrier 는 SHADER_READ_ONLY -> SHADER_READ_ONLY 이므로 release 와 짝이 맞는다.
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    vkCmdPipelineBarrier(fCmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, 1, &barrier);
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcQueueFamilyIndex = fQueueFamily;
+    barrier.dstQueueFamilyIndex = fGraphicsQueueFamily;
+    vkCmdPipelineBarrier(fCmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+                         0, nullptr, 1, &barrier);
+    vkEndCommandBuffer(fCmd);
+
+    // staging buffer 를 하나만 쓰므로 다음 업로드 전에 완료를 기다린다 (이 스레드에서만 대기)
+    VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &fCmd;
+    vkResetFences(fDevice, 1, &fFence);
+    if (vkQueueSubmit(fQueue, 1, &submitInfo, fFence) != VK_SUCCESS ||
+        vkWaitForFences(fDevice, 1, &fFence, VK_TRUE, UINT64_MAX) != VK_SUCCESS) {
+        std::cerr << "Texture upload failed" << std::endl;
+        vkQueueWaitIdle(fQueue);
+        destroyTexture(texture);
+    }
+    return texture;
+}
+
+namespace {
+
+struct TextureRelease
+{
+    VkDevice device;
+    const VkAllocationCallbacks *callbacks;
+    VkImage image;
+    VkDeviceMemory memory;
+};
+
+void releaseTexture(void *context)
+{
+    TextureRelease *release = static_cast<TextureRelease *>(context);
+    vkDestroyImage(release->device, release->image, release->callbacks);
+    vkFreeMemory(release->device, release->memory, release->callbacks);
+    delete release;
+}
+
+} // namespace
+
+sk_sp<SkImage> VkImageUploader::wrap(GrDirectContext *context, const UploadedTexture &texture)
+{
+    GrVkImageInfo imageInfo{};
+    imageInfo.fImage = texture.image;
+    imageInfo.fAlloc = GrVkAlloc(texture.memory, 0, texture.size, 0);
+    imageInfo.fImageTiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.fImageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.fFormat = kTextureFormat;
+    imageInfo.fImageUsageFlags = kTextureUsage;
+    imageInfo.fSampleCount = 1;
+    imageInfo.fLevelCount = 1;
+    imageInfo.fCurrentQueueFamily = fQueueFamily;
+    imageInfo.fSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    GrBackendTexture backendTexture = GrBackendTextures::MakeVk(texture.width, texture.height, imageInfo);
+    auto *release = new TextureRelease{fDevice, fCallbacks, texture.image, texture.memory};
+    // 실패해도 release proc 은 호출된다
+    return SkImages::BorrowTextureFrom(context, backendTexture, kTopLeft_GrSurfaceOrigin, kRGBA_8888_SkColorType,
+                                       kPremul_SkAlphaType, nullptr, releaseTexture, release);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "include/core/SkRefCnt.h"
+
+#include "bounded_queue.h"
+#include "pixel_buffer_pool.h"
+
+class GrDirectContext;
+class SkImage;
+struct VulkanContext;
+
+// 업로드가 끝난 VkImage (render 스레드로 넘어가기 전). image 가 VK_NULL_HANDLE 이면 실패
+struct UploadedTexture
+{
+    int id = -1;
+    int width = 0;
+    int height = 0;
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize size = 0;
+};
+
+// graphics 와 다른 transfer queue family 에서 자체 스레드로 텍스처를 업로드한다.
+// staging buffer 로 복사 → VkImage 에 copy → SHADER_READ_ONLY 로 전환 후 graphics family 로 ownership release.
+// GrVkImageInfo::fCurrentQueueFamily 를 transfer family 로 두고 wrap 하면 Skia 가 처음 쓸 때 acquire barrier 를 건다.
+// render 스레드는 collect() 로 끝난 것만 가져가므로 업로드를 기다리지 않는다.
+class VkImageUploader
+{
+public:
+    // 전용 transfer queue 가 없으면 nullptr
+    static std::unique_ptr<VkImageUploader> Make(const VulkanContext &vkCtx, PixelBufferPool *pool);
+    ~VkImageUploader();
+
+    VkImageUploader(const VkImageUploader &) = delete;
+    VkImageUploader &operator=(const VkImageUploader &) = delete;
+
+    // decode 스레드에서 호출. 업로드 큐가 가득 차면 대기
+    void enqueue(DecodedImage image);
+    // render 스레드: 끝난 업로드를 out 뒤에 붙인다 (블록하지 않음)
+    void collect(std::vector<UploadedTexture> *out);
+    // render 스레드: SkImage 로 wrap. image 가 해제될 때 VkImage / 메모리도 해제된다
+    sk_sp<SkImage> wrap(GrDirectContext *context, const UploadedTexture &texture);
+
+private:
+    VkImageUploader(const VulkanContext &vkCtx, PixelBufferPool *pool);
+
+    bool init();
+    void threadLoop();
+    UploadedTexture upload(DecodedImage &image);
+    bool ensureStaging(VkDeviceSize size);
+    void destroyTexture(UploadedTexture &texture);
+
+    VkDevice fDevice;
+    VkPhysicalDevice fPhysicalDevice;
+    VkQueue fQueue;
+    uint32_t fQueueFamily;
+    uint32_t fGraphicsQueueFamily;
+    const VkAllocationCallbacks *fCallbacks;    // --vk-host-tracking 이면 tracker 의 callbacks
+    PixelBufferPool *fPool;
+
+    VkCommandPool fCmdPool = VK_NULL_HANDLE;
+    VkCommandBuffer fCmd = VK_NULL_HANDLE;
+    VkFence fFence = VK_NULL_HANDLE;
+    VkBuffer fStaging = VK_NULL_HANDLE;
+    VkDeviceMemory fStagingMemory = VK_NULL_HANDLE;
+    VkDeviceSize fStagingSize = 0;
+    void *fStagingPtr = nullptr;
+
+    BoundedQueue<DecodedImage> fInput;
+    std::mutex fDoneMutex;
+    std::vector<UploadedTexture> fDone;
+    std::thread fThread;
+};
@@ -0,0 +1,614 @@
+#include "vk_memory_allocator.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+using skgpu::VulkanAlloc;
+using skgpu::VulkanBackendMemory;
+
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static double toMiB(uint64_t bytes)
+{
+    return bytes / (1024.0 * 1024.0);
+}
+
+bool parseVkMemoryArg(const char *arg, VkMemoryOptions &options)
+{
+    if (strncmp(arg, "--vk-allocator=", 15) == 0) {
+        if (strcmp(arg + 15, "pooled") == 0) {
+            options.pooled = true;
+        } else if (strcmp(arg + 15, "skia") == 0) {
+            options.pooled = false;
+        } else {
+            std::cerr << "Unknown Vulkan allocator: " << arg + 15 << ", using skia" << std::endl;
+            options.pooled = false;
+        }
+        return true;
+    }
+    if (strncmp(arg, "--vk-block-mb=", 14) == 0) {
+        VkDeviceSize mb = std::max(1, atoi(arg + 14));
+        options.deviceBlockSize = mb << 20;
+        options.hostBlockSize = std::max<VkDeviceSize>(1, mb / 4) << 20;
+        return true;
+    }
+    if (strcmp(arg, "--vk-host-tracking") == 0) {
+        options.trackHost = true;
+        return true;
+    }
+    return false;
+}
+
+// --- VkHostAllocationTracker ---
+
+namespace {
+
+// 사용자 포인터 바로 앞에 두는 헤더. free 때 크기와 scope 를 알아야 하므로
+struct HostHeader
+{
+    void *raw;
+    size_t size;
+    VkSystemAllocationScope scope;
+};
+
+const char *scopeName(int scope)
+{
+    switch (scope) {
+    case VK_SYSTEM_ALLOCATION_SCOPE_COMMAND:
+        return "command";
+    case VK_SYSTEM_ALLOCATION_SCOPE_OBJECT:
+        return "object";
+    case VK_SYSTEM_ALLOCATION_SCOPE_CACHE:
+        return "cache";
+    case VK_SYSTEM_ALLOCATION_SCOPE_DEVICE:
+        return "device";
+    case VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE:
+        return "instance";
+    }
+    return "?";
+}
+
+}  // namespace
+
+VkHostAllocationTracker::VkHostAllocationTracker()
+{
+    fCallbacks = {};
+    fCallbacks.pUserData = this;
+    fCallbacks.pfnAllocation = onAllocate;
+    fCallbacks.pfnReallocation = onReallocate;
+    fCallbacks.pfnFree = onFree;
+    fCallbacks.pfnInternalAllocation = onInternalAllocate;
+    fCallbacks.pfnInternalFree = onInternalFree;
+}
+
+void VkHostAllocationTracker::add(VkSystemAllocationScope scope, int64_t bytes, bool internal)
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    ScopeStats &stats = fScopes[scope];
+    if (internal) {
+        stats.internalBytes += bytes;
+    } else {
+        stats.bytes += bytes;
+        stats.peakBytes = std::max(stats.peakBytes, stats.bytes);
+        if (bytes > 0) {
+            ++stats.allocations;
+        }
+    }
+    int64_t total = 0;
+    for (const ScopeStats &s : fScopes) {
+        total += s.bytes + s.internalBytes;
+    }
+    fPeakTotal = std::max(fPeakTotal, total);
+}
+
+void *VKAPI_CALL VkHostAllocationTracker::onAllocate(void *user, size_t size, size_t alignment,
+                                                     VkSystemAllocationScope scope)
+{
+    if (size == 0) {
+        return nullptr;
+    }
+    // alignment 는 2 의 거듭제곱 (spec). 헤더 자체도 정렬되도록 최소 alignof(HostHeader)
+    alignment = std::max(alignment, alignof(HostHeader));
+    void *raw = std::malloc(sizeof(HostHeader) + alignment + size);
+    if (!raw) {
+        return nullptr;
+    }
+    uintptr_t data = alignUp(reinterpret_cast<uintptr_t>(raw) + sizeof(HostHeader), alignment);
+    HostHeader *header = reinterpret_cast<HostHeader *>(data) - 1;
+    header->raw = raw;
+    header->size = size;
+    header->scope = scope;
+    static_cast<VkHostAllocationTracker *>(user)->add(scope, static_cast<int64_t>(size), false);
+    return reinterpret_cast<void *>(data);
+}
+
+void *VKAPI_CALL VkHostAllocationTracker::onReallocate(void *user, void *original, size_t size, size_t alignment,
+                                                       VkSystemAllocationScope scope)
+{
+    if (!original) {
+        return onAllocate(user, size, alignment, scope);
+    }
+    if (size == 0) {
+        onFree(user, original);
+        return nullptr;
+    }
+    void *data = onAllocate(user, size, alignment, scope);
+    if (data) {
+        const HostHeader *header = static_cast<const HostHeader *>(original) - 1;
+        memcpy(data, original, std::min(size, header->size));
+        onFree(user, original);
+    }
+    return data;
+}
+
+void VKAPI_CALL VkHostAllocationTracker::onFree(void *user, void *memory)
+{
+    if (!memory) {
+        return;
+    }
+    HostHeader *header = static_cast<HostHeader *>(memory) - 1;
+    static_cast<VkHostAllocationTracker *>(user)->add(header->scope, -static_cast<int64_t>(header->size), false);
+    std::free(header->raw);
+}
+
+void VKAPI_CALL VkHostAllocationTracker::onInternalAllocate(void *user, size_t size, VkInternalAllocationType,
+                                                            VkSystemAllocationScope scope)
+{
+    static_cast<VkHostAllocationTracker *>(user)->add(scope, static_cast<int64_t>(size), true);
+}
+
+void VKAPI_CALL VkHostAllocationTracker::onInternalFree(void *user, size_t size, VkInternalAllocationType,
+                                                        VkSystemAllocationScope scope)
+{
+    static_cast<VkHostAllocationTracker *>(user)->add(scope, -static_cast<int64_t>(size), true);
+}
+
+void VkHostAllocationTracker::printStats(std::ostream &os) const
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    os << "Vulkan host memory: peak " << fPeakTotal / 1024.0 << " KiB" << std::endl;
+    for (int scope = 0; scope <= VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE; ++scope) {
+        const ScopeStats &stats = fScopes[scope];
+        if (stats.allocations == 0 && stats.internalBytes == 0) {
+            continue;
+        }
+        os << "  " << scopeName(scope) << ": " << stats.bytes / 1024.0 << " KiB live, peak "
+           << stats.peakBytes / 1024.0 << " KiB, " << stats.allocations << " allocations";
+        if (stats.internalBytes != 0) {
+            os << ", internal " << stats.internalBytes / 1024.0 << " KiB";
+        }
+        os << std::endl;
+    }
+}
+
+// --- VkPoolMemoryAllocator ---
+
+const char *poolClassName(VkPoolMemoryAllocator::PoolClass poolClass)
+{
+    switch (poolClass) {
+    case VkPoolMemoryAllocator::PoolClass::kImage:
+        return "image";
+    case VkPoolMemoryAllocator::PoolClass::kGpuBuffer:
+        return "gpu buffer";
+    case VkPoolMemoryAllocator::PoolClass::kUpload:
+        return "upload";
+    case VkPoolMemoryAllocator::PoolClass::kReadback:
+        return "readback";
+    case VkPoolMemoryAllocator::PoolClass::kCount:
+        break;
+    }
+    return "?";
+}
+
+sk_sp<VkPoolMemoryAllocator> VkPoolMemoryAllocator::Make(VkPhysicalDevice physicalDevice, VkDevice device,
+                                                         const VkAllocationCallbacks *callbacks,
+                                                         const VkMemoryOptions &options)
+{
+    return sk_sp<VkPoolMemoryAllocator>(new VkPoolMemoryAllocator(physicalDevice, device, callbacks, options));
+}
+
+VkPoolMemoryAllocator::VkPoolMemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device,
+                                             const VkAllocationCallbacks *callbacks, const VkMemoryOptions &options)
+    : fPhysicalDevice(physicalDevice), fDevice(device), fCallbacks(callbacks), fOptions(options)
+{
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &fMemoryProperties);
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    fNonCoherentAtomSize = std::max<VkDeviceSize>(1, props.limits.nonCoherentAtomSize);
+}
+
+VkPoolMemoryAllocator::~VkPoolMemoryAllocator()
+{
+    // Skia 는 GrDirectContext 파괴 시 모든 할당을 돌려주므로 여기 남은 것은 block 뿐이어야 함
+    for (auto &entry : fPools) {
+        Pool &pool = *entry.second;
+        if (pool.stats.allocations > 0) {
+            std::cerr << "Vulkan allocator: " << pool.stats.allocations << " allocations leaked in "
+                      << poolClassName(pool.poolClass) << " pool" << std::endl;
+        }
+        for (auto &block : pool.blocks) {
+            vkFreeMemory(fDevice, block->memory, fCallbacks);
+        }
+    }
+}
+
+bool VkPoolMemoryAllocator::chooseMemoryType(uint32_t typeBits, VkMemoryPropertyFlags required,
+                                             VkMemoryPropertyFlags preferred, uint32_t *typeIndex) const
+{
+    // required 를 만족하는 타입 중 preferred 비트를 가장 많이 가진 것, 같으면 index 가 작은 것
+    int bestScore = -1;
+    for (uint32_t i = 0; i < fMemoryProperties.memoryTypeCount; ++i) {
+        VkMemoryPropertyFlags flags = fMemoryProperties.memoryTypes[i].propertyFlags;
+        if (!(typeBits & (1u << i)) || (flags & required) != required) {
+            continue;
+        }
+        int score = static_cast<int>(std::bitset<32>(flags & preferred).count());
+        if (score > bestScore) {
+            bestScore = score;
+            *typeIndex = i;
+        }
+    }
+    return bestScore >= 0;
+}
+
+VkPoolMemoryAllocator::Pool &VkPoolMemoryAllocator::pool(PoolClass poolClass, uint32_t memoryType)
+{
+    std::unique_ptr<Pool> &pool = fPools[{static_cast<int>(poolClass), memoryType}];
+    if (!pool) {
+        pool = std::make_unique<Pool>();
+        pool->poolClass = poolClass;
+        pool->memoryType = memoryType;
+        bool hostVisible =
+            fMemoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        pool->blockSize = hostVisible ? fOptions.hostBlockSize : fOptions.deviceBlockSize;
+    }
+    return *pool;
+}
+
+void VkPoolMemoryAllocator::onAllocated(PoolStats &stats, VkDeviceSize bytes, bool newMemory)
+{
+    if (newMemory) {
+        stats.allocatedBytes += bytes;
+        stats.peakAllocatedBytes = std::max(stats.peakAllocatedBytes, stats.allocatedBytes);
+        ++stats.deviceAllocations;
+    }
+}
+
+VkPoolMemoryAllocator::Block *VkPoolMemoryAllocator::createBlock(Pool &pool)
+{
+    VkMemoryAllocateInfo allocInfo{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    allocInfo.allocationSize = pool.blockSize;
+    allocInfo.memoryTypeIndex = pool.memoryType;
+    auto block = std::make_unique<Block>();
+    if (vkAllocateMemory(fDevice, &allocInfo, fCallbacks, &block->memory) != VK_SUCCESS) {
+        return nullptr;
+    }
+    if (fMemoryProperties.memoryTypes[pool.memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT &&
+        vkMapMemory(fDevice, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mapped) != VK_SUCCESS) {
+        vkFreeMemory(fDevice, block->memory, fCallbacks);
+        return nullptr;
+    }
+    block->size = pool.blockSize;
+    block->freeRanges[0] = pool.blockSize;
+    onAllocated(pool.stats, pool.blockSize, true);
+    pool.blocks.push_back(std::move(block));
+    return pool.blocks.back().get();
+}
+
+bool VkPoolMemoryAllocator::suballocate(Block &block, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize *offset)
+{
+    for (auto it = block.freeRanges.begin(); it != block.freeRanges.end(); ++it) {
+        VkDeviceSize rangeStart = it->first;
+        VkDeviceSize rangeEnd = it->first + it->second;
+        VkDeviceSize start = alignUp(rangeStart, alignment);
+        if (start + size > rangeEnd) {
+            continue;
+        }
+        block.freeRanges.erase(it);
+        // 정렬로 생긴 앞쪽 틈과 뒤쪽 나머지는 다시 free list 로
+        if (start > rangeStart) {
+            block.freeRanges[rangeStart] = start - rangeStart;
+        }
+        if (start + size < rangeEnd) {
+            block.freeRanges[start + size] = rangeEnd - start - size;
+        }
+        ++block.allocations;
+        *offset = start;
+        return true;
+    }
+    return false;
+}
+
+void VkPoolMemoryAllocator::release(Block &block, VkDeviceSize offset, VkDeviceSize size)
+{
+    auto next = block.freeRanges.lower_bound(offset);
+    if (next != block.freeRanges.end() && offset + size == next->first) {
+        size += next->second;
+        next = block.freeRanges.erase(next);
+    }
+    if (next != block.freeRanges.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            prev->second += size;
+            --block.allocations;
+            return;
+        }
+    }
+    block.freeRanges[offset] = size;
+    --block.allocations;
+}
+
+VkResult VkPoolMemoryAllocator::allocate(PoolClass poolClass, const VkMemoryRequirements &reqs,
+                                         VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred,
+                                         bool dedicated, VulkanBackendMemory *memory)
+{
+    uint32_t typeIndex = 0;
+    if (!chooseMemoryType(reqs.memoryTypeBits, required, preferred, &typeIndex)) {
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    VkMemoryPropertyFlags typeFlags = fMemoryProperties.memoryTypes[typeIndex].propertyFlags;
+    uint32_t allocFlags = 0;
+    if (typeFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        allocFlags |= VulkanAlloc::kMappable_Flag;
+        if (!(typeFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+            allocFlags |= VulkanAlloc::kNoncoherent_Flag;
+        }
+    }
+    if (typeFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) {
+        allocFlags |= VulkanAlloc::kLazilyAllocated_Flag;
+        dedicated = true;
+    }
+
+    std::lock_guard<std::mutex> lock(fMutex);
+    Pool &target = pool(poolClass, typeIndex);
+    auto allocation = std::make_unique<Allocation>();
+    allocation->pool = &target;
+    allocation->block = nullptr;
+    allocation->size = reqs.size;
+    allocation->flags = allocFlags;
+    allocation->mapped = nullptr;
+
+    if (dedicated || reqs.size > target.blockSize / 2) {
+        VkMemoryAllocateInfo allocInfo{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+        allocInfo.allocationSize = reqs.size;
+        allocInfo.memoryTypeIndex = typeIndex;
+        VkResult result = vkAllocateMemory(fDevice, &allocInfo, fCallbacks, &allocation->memory);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+        if ((allocFlags & VulkanAlloc::kMappable_Flag) &&
+            vkMapMemory(fDevice, allocation->memory, 0, VK_WHOLE_SIZE, 0, &allocation->mapped) != VK_SUCCESS) {
+            vkFreeMemory(fDevice, allocation->memory, fCallbacks);
+            return VK_ERROR_MEMORY_MAP_FAILED;
+        }
+        allocation->offset = 0;
+        onAllocated(target.stats, reqs.size, true);
+        ++target.stats.dedicated;
+    } else {
+        // noncoherent 메모리는 flush 범위가 이웃 할당과 겹치지 않도록 atom 단위로 정렬
+        VkDeviceSize alignment = std::max<VkDeviceSize>(1, reqs.alignment);
+        if (allocFlags & VulkanAlloc::kNoncoherent_Flag) {
+            alignment = std::max(alignment, fNonCoherentAtomSize);
+        }
+        Block *block = nullptr;
+        VkDeviceSize offset = 0;
+        for (auto &candidate : target.blocks) {
+            if (suballocate(*candidate, reqs.size, alignment, &offset)) {
+                block = candidate.get();
+                break;
+            }
+        }
+        if (!block) {
+            block = createBlock(target);
+            if (!block || !suballocate(*block, reqs.size, alignment, &offset)) {
+                return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+            }
+        }
+        allocation->block = block;
+        allocation->memory = block->memory;
+        allocation->offset = offset;
+    }
+
+    PoolStats &stats = target.stats;
+    stats.usedBytes += reqs.size;
+    stats.peakUsedBytes = std::max(stats.peakUsedBytes, stats.usedBytes);
+    ++stats.allocations;
+    ++stats.totalAllocations;
+    *memory = reinterpret_cast<VulkanBackendMemory>(allocation.release());
+    return VK_SUCCESS;
+}
+
+VkResult VkPoolMemoryAllocator::allocateImageMemory(VkImage image, uint32_t allocationPropertyFlags,
+                                                    VulkanBackendMemory *memory)
+{
+    VkMemoryRequirements reqs;
+    vkGetImageMemoryRequirements(fDevice, image, &reqs);
+
+    VkMemoryPropertyFlags required = 0;
+    VkMemoryPropertyFlags preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    if (allocationPropertyFlags & kLazyAllocation_AllocationPropertyFlag) {
+        preferred |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+    }
+    if (allocationPropertyFlags & kProtected_AllocationPropertyFlag) {
+        required |= VK_MEMORY_PROPERTY_PROTECTED_BIT;
+    }
+    bool dedicated = allocationPropertyFlags & kDedicatedAllocation_AllocationPropertyFlag;
+    return allocate(PoolClass::kImage, reqs, required, preferred, dedicated, memory);
+}
+
+VkResult VkPoolMemoryAllocator::allocateBufferMemory(VkBuffer buffer, BufferUsage usage,
+                                                     uint32_t allocationPropertyFlags, VulkanBackendMemory *memory)
+{
+    VkMemoryRequirements reqs;
+    vkGetBufferMemoryRequirements(fDevice, buffer, &reqs);
+
+    PoolClass poolClass = PoolClass::kGpuBuffer;
+    VkMemoryPropertyFlags required = 0;
+    VkMemoryPropertyFlags preferred = 0;
+    switch (usage) {
+    case BufferUsage::kGpuOnly:
+        preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        break;
+    case BufferUsage::kCpuWritesGpuReads:
+        // 매 프레임 쓰는 vertex / uniform: 가능하면 BAR (device-local + host-visible)
+        poolClass = PoolClass::kUpload;
+        required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        break;
+    case BufferUsage::kTransfersFromCpuToGpu:
+        poolClass = PoolClass::kUpload;
+        required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        preferred = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        break;
+    case BufferUsage::kTransfersFromGpuToCpu:
+        poolClass = PoolClass::kReadback;
+        required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        preferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        break;
+    }
+    if (allocationPropertyFlags & kProtected_AllocationPropertyFlag) {
+        required |= VK_MEMORY_PROPERTY_PROTECTED_BIT;
+    }
+    bool dedicated = allocationPropertyFlags & kDedicatedAllocation_AllocationPropertyFlag;
+    return allocate(poolClass, reqs, required, preferred, dedicated, memory);
+}
+
+void VkPoolMemoryAllocator::getAllocInfo(const VulkanBackendMemory &memory, VulkanAlloc *alloc) const
+{
+    const Allocation *allocation = reinterpret_cast<const Allocation *>(memory);
+    alloc->fMemory = allocation->memory;
+    alloc->fOffset = allocation->offset;
+    alloc->fSize = allocation->size;
+    alloc->fFlags = allocation->flags;
+    alloc->fBackendMemory = memory;
+}
+
+VkResult VkPoolMemoryAllocator::mapMemory(const VulkanBackendMemory &memory, void **data)
+{
+    // host-visible 메모리는 할당 시 이미 map 해 둠
+    const Allocation *allocation = reinterpret_cast<const Allocation *>(memory);
+    void *base = allocation->block ? allocation->block->mapped : allocation->mapped;
+    if (!base) {
+        return VK_ERROR_MEMORY_MAP_FAILED;
+    }
+    *data = static_cast<char *>(base) + allocation->offset;
+    return VK_SUCCESS;
+}
+
+void VkPoolMemoryAllocator::unmapMemory(const VulkanBackendMemory &)
+{
+}
+
+VkResult VkPoolMemoryAllocator::syncRange(const Allocation &allocation, VkDeviceSize offset, VkDeviceSize size,
+                                          bool flush)
+{
+    if (!(allocation.flags & VulkanAlloc::kNoncoherent_Flag)) {
+        return VK_SUCCESS;
+    }
+    // offset / size 는 할당 기준. VkDeviceMemory 기준으로 옮기고 nonCoherentAtomSize 로 넓힌다
+    VkDeviceSize memorySize = allocation.block ? allocation.block->size : allocation.size;
+    VkDeviceSize end = size == VK_WHOLE_SIZE ? allocation.size : std::min(allocation.size, offset + size);
+    VkMappedMemoryRange range{VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE};
+    range.memory = allocation.memory;
+    range.offset = (allocation.offset + offset) / fNonCoherentAtomSize * fNonCoherentAtomSize;
+    VkDeviceSize rangeEnd = std::min(memorySize, alignUp(allocation.offset + end, fNonCoherentAtomSize));
+    range.size = rangeEnd == memorySize ? VK_WHOLE_SIZE : rangeEnd - range.offset;
+    return flush ? vkFlushMappedMemoryRanges(fDevice, 1, &range) : vkInvalidateMappedMemoryRanges(fDevice, 1, &range);
+}
+
+VkResult VkPoolMemoryAllocator::flushMemory(const VulkanBackendMemory &memory, VkDeviceSize offset,
+                                            VkDeviceSize size)
+{
+    return syncRange(*reinterpret_cast<const Allocation *>(memory), offset, size, true);
+}
+
+VkResult VkPoolMemoryAllocator::invalidateMemory(const VulkanBackendMemory &memory, VkDeviceSize offset,
+                                                 VkDeviceSize size)
+{
+    return syncRange(*reinterpret_cast<const Allocation *>(memory), offset, size, false);
+}
+
+void VkPoolMemoryAllocator::freeMemory(const VulkanBackendMemory &memory)
+{
+    std::unique_ptr<Allocation> allocation(reinterpret_cast<Allocation *>(memory));
+    std::lock_guard<std::mutex> lock(fMutex);
+    Pool &pool = *allocation->pool;
+    pool.stats.usedBytes -= allocation->size;
+    --pool.stats.allocations;
+
+    if (!allocation->block) {
+        // 매핑된 메모리도 vkFreeMemory 가 암묵적으로 unmap
+        vkFreeMemory(fDevice, allocation->memory, fCallbacks);
+        pool.stats.allocatedBytes -= allocation->size;
+        --pool.stats.dedicated;
+        return;
+    }
+
+    Block *block = allocation->block;
+    release(*block, allocation->offset, allocation->size);
+    if (block->allocations > 0) {
+        return;
+    }
+    // 빈 block 은 하나만 남겨 다음 할당의 vkAllocateMemory 를 피한다
+    int emptyBlocks = 0;
+    for (const auto &candidate : pool.blocks) {
+        emptyBlocks += candidate->allocations == 0;
+    }
+    if (emptyBlocks > 1) {
+        vkFreeMemory(fDevice, block->memory, fCallbacks);
+        pool.stats.allocatedBytes -= block->size;
+        pool.blocks.erase(std::find_if(pool.blocks.begin(), pool.blocks.end(),
+                                       [block](const std::unique_ptr<Block> &b) { return b.get() == block; }));
+    }
+}
+
+std::pair<uint64_t, uint64_t> VkPoolMemoryAllocator::totalAllocatedAndUsedMemory() const
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    uint64_t allocated = 0, used = 0;
+    for (const auto &entry : fPools) {
+        allocated += entry.second->stats.allocatedBytes;
+        used += entry.second->stats.usedBytes;
+    }
+    return {allocated, used};
+}
+
+void VkPoolMemoryAllocator::printStats(std::ostream &os) const
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    uint64_t allocated = 0, used = 0, deviceAllocations = 0, totalAllocations = 0;
+    for (const auto &entry : fPools) {
+        allocated += entry.second->stats.allocatedBytes;
+        used += entry.second->stats.usedBytes;
+        deviceAllocations += entry.second->stats.deviceAllocations;
+        totalAllocations += entry.second->stats.totalAllocations;
+    }
+    os << "Vulkan memory: " << toMiB(allocated) << " MiB allocated, " << toMiB(used) << " MiB used, "
+       << totalAllocations << " allocations served by " << deviceAllocations << " vkAllocateMemory" << std::endl;
+
+    for (const auto &entry : fPools) {
+        const Pool &pool = *entry.second;
+        const PoolStats &stats = pool.stats;
+        // 단편화: 빈 공간 중 가장 큰 연속 구간이 차지하지 못하는 비율
+        VkDeviceSize freeBytes = 0, largestFree = 0;
+        for (const auto &block : pool.blocks) {
+            for (const auto &range : block->freeRanges) {
+                freeBytes += range.second;
+                largestFree = std::max(largestFree, range.second);
+            }
+        }
+        double fragmentation = freeBytes > 0 ? 1.0 - double(largestFree) / freeBytes : 0.0;
+        os << "  " << poolClassName(pool.poolClass) << " (type " << pool.memoryType << "): " << pool.blocks.size()
+           << " blocks + " << stats.dedicated << " dedicated, " << toMiB(stats.allocatedBytes) << " MiB allocated (peak "
+           << toMiB(stats.peakAllocatedBytes) << "), " << toMiB(stats.usedBytes) << " MiB used (peak "
+           << toMiB(stats.peakUsedBytes) << "), " << stats.allocations << " live, " << stats.deviceAllocations
+           << " vkAllocateMemory, fragmentation " << fragmentation * 100.0 << "%" << std::endl;
+    }
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "include/gpu/vk/VulkanMemoryAllocator.h"
+
+struct VkMemoryOptions
+{
+    bool pooled = false;                        // false 면 Skia 기본 allocator (VMA)
+    VkDeviceSize deviceBlockSize = 64 << 20;    // DEVICE_LOCAL 전용 pool 의 block 크기
+    VkDeviceSize hostBlockSize = 16 << 20;      // HOST_VISIBLE pool 의 block 크기
+    bool trackHost = false;                     // VkAllocationCallbacks 로 드라이버 host 메모리 추적
+};
+
+// --vk-allocator=pooled|skia, --vk-block-mb=N, --vk-host-tracking 을 처리하면 true
+bool parseVkMemoryArg(const char *arg, VkMemoryOptions &options);
+
+// 드라이버의 host 메모리 할당을 VkSystemAllocationScope 별로 집계하는 VkAllocationCallbacks.
+// 같은 callbacks 를 create / destroy 양쪽에 넘겨야 한다 (instance, device, swapchain, 동기화 객체, vkAllocateMemory 등 전부).
+class VkHostAllocationTracker
+{
+public:
+    VkHostAllocationTracker();
+
+    const VkAllocationCallbacks *callbacks() const { return &fCallbacks; }
+    void printStats(std::ostream &os) const;
+
+private:
+    struct ScopeStats
+    {
+        int64_t bytes = 0;
+        int64_t peakBytes = 0;
+        uint64_t allocations = 0;
+        int64_t internalBytes = 0;  // 드라이버가 직접 할당하고 알려 온 양
+    };
+
+    static void *VKAPI_CALL onAllocate(void *user, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    static void *VKAPI_CALL onReallocate(void *user, void *original, size_t size, size_t alignment,
+                                         VkSystemAllocationScope scope);
+    static void VKAPI_CALL onFree(void *user, void *memory);
+    static void VKAPI_CALL onInternalAllocate(void *user, size_t size, VkInternalAllocationType,
+                                              VkSystemAllocationScope scope);
+    static void VKAPI_CALL onInternalFree(void *user, size_t size, VkInternalAllocationType,
+                                          VkSystemAllocationScope scope);
+
+    void add(VkSystemAllocationScope scope, int64_t bytes, bool internal);
+
+    VkAllocationCallbacks fCallbacks;
+    mutable std::mutex fMutex;
+    ScopeStats fScopes[VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1];
+    int64_t fPeakTotal = 0;
+};
+
+// Skia 의 이미지/버퍼 메모리를 용도별 pool 에서 block 단위로 나눠 주는 allocator.
+// pool 은 (용도, memory type) 마다 있고, 각 block 은 offset 순 free list 에서 first-fit 으로 자르며
+// 해제 시 이웃 빈 구간과 합친다. 이미지(optimal)와 버퍼(linear)는 pool 을 나눠
+// bufferImageGranularity 를 신경 쓰지 않아도 되게 한다.
+// block 절반보다 큰 할당과 dedicated 요청은 별도 VkDeviceMemory. host-visible block 은 생성 시 한 번만 map.
+class VkPoolMemoryAllocator : public skgpu::VulkanMemoryAllocator
+{
+public:
+    enum class PoolClass
+    {
+        kImage,         // device-local optimal 이미지
+        kGpuBuffer,     // vertex / index / uniform (GPU 전용)
+        kUpload,        // CPU 가 쓰고 GPU 가 읽는 버퍼 (staging, dynamic vertex)
+        kReadback,      // GPU -> CPU
+        kCount,
+    };
+
+    static sk_sp<VkPoolMemoryAllocator> Make(VkPhysicalDevice physicalDevice, VkDevice device,
+                                             const VkAllocationCallbacks *callbacks, const VkMemoryOptions &options);
+    ~VkPoolMemoryAllocator() override;
+
+    VkResult allocateImageMemory(VkImage image, uint32_t allocationPropertyFlags,
+                                 skgpu::VulkanBackendMemory *memory) override;
+    VkResult allocateBufferMemory(VkBuffer buffer, BufferUsage usage, uint32_t allocationPropertyFlags,
+                                  skgpu::VulkanBackendMemory *memory) override;
+    void getAllocInfo(const skgpu::VulkanBackendMemory &memory, skgpu::VulkanAlloc *alloc) const override;
+    VkResult mapMemory(const skgpu::VulkanBackendMemory &memory, void **data) override;
+    void unmapMemory(const skgpu::VulkanBackendMemory &memory) override;
+    VkResult flushMemory(const skgpu::VulkanBackendMemory &memory, VkDeviceSize offset, VkDeviceSize size) override;
+    VkResult invalidateMemory(const skgpu::VulkanBackendMemory &memory, VkDeviceSize offset,
+                              VkDeviceSize size) override;
+    void freeMemory(const skgpu::VulkanBackendMemory &memory) override;
+    std::pair<uint64_t, uint64_t> totalAllocatedAndUsedMemory() const override;
+
+    // pool 별 block 수, 할당/사용 bytes 와 high-water, vkAllocateMemory 횟수, 단편화
+    void printStats(std::ostream &os) const;
+
+private:
+    struct Block
+    {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+        void *mapped = nullptr;
+        std::map<VkDeviceSize, VkDeviceSize> freeRanges;    // offset -> size
+        int allocations = 0;
+    };
+
+    struct PoolStats
+    {
+        uint64_t allocatedBytes = 0;    // block + dedicated VkDeviceMemory
+        uint64_t usedBytes = 0;
+        uint64_t peakAllocatedBytes = 0;
+        uint64_t peakUsedBytes = 0;
+        uint64_t allocations = 0;       // 현재 살아 있는 suballocation 수
+        uint64_t totalAllocations = 0;
+        uint64_t deviceAllocations = 0; // vkAllocateMemory 호출 수
+        uint64_t dedicated = 0;         // 현재 dedicated 할당 수
+    };
+
+    struct Pool
+    {
+        PoolClass poolClass;
+        uint32_t memoryType;
+        VkDeviceSize blockSize;
+        std::vector<std::unique_ptr<Block>> blocks;
+        PoolStats stats;
+    };
+
+    struct Allocation
+    {
+        Pool *pool;
+        Block *block;           // nullptr 이면 dedicated
+        VkDeviceMemory memory;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+        uint32_t flags;         // skgpu::VulkanAlloc::Flag
+        void *mapped;           // dedicated 를 map 했을 때
+    };
+
+    VkPoolMemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device, const VkAllocationCallbacks *callbacks,
+                          const VkMemoryOptions &options);
+
+    bool chooseMemoryType(uint32_t typeBits, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred,
+                          uint32_t *typeIndex) const;
+    VkResult allocate(PoolClass poolClass, const VkMemoryRequirements &reqs, VkMemoryPropertyFlags required,
+                      VkMemoryPropertyFlags preferred, bool dedicated, skgpu::VulkanBackendMemory *memory);
+    Pool &pool(PoolClass poolClass, uint32_t memoryType);
+    Block *createBlock(Pool &pool);
+    VkResult syncRange(const Allocation &allocation, VkDeviceSize offset, VkDeviceSize size, bool flush);
+    static bool suballocate(Block &block, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize *offset);
+    static void release(Block &block, VkDeviceSize offset, VkDeviceSize size);
+    void onAllocated(PoolStats &stats, VkDeviceSize bytes, bool newMemory);
+
+    VkPhysicalDevice fPhysicalDevice;
+    VkDevice fDevice;
+    const VkAllocationCallbacks *fCallbacks;
+    VkMemoryOptions fOptions;
+    VkPhysicalDeviceMemoryProperties fMemoryProperties;
+    VkDeviceSize fNonCoherentAtomSize;
+
+    mutable std::mutex fMutex;
+    std::map<std::pair<int, uint32_t>, std::unique_ptr<Pool>> fPools;     // (PoolClass, memory type)
+};
+
+const char *poolClassName(VkPoolMemoryAllocator::PoolClass poolClass);
@@ -0,0 +1,493 @@
+#include "workloads.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkFontMgr.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkRect.h"
+
+#include "font_manager.h"
+#include "path_registry.h"
+#include "primitive_batch.h"
+#include "retained_scene.h"
+#include "text_cache.h"
+
+namespace {
+
+// 결정적인 난수 (워크로드가 실행마다 같아야 비교 가능)
+class Lcg
+{
+public:
+    explicit Lcg(uint32_t seed) : fState(seed) {}
+    uint32_t next()
+    {
+        fState = fState * 1664525u + 1013904223u;
+        return fState;
+    }
+    float nextF(float lo, float hi) { return lo + (hi - lo) * (next() >> 8) / float(1 << 24); }
+
+private:
+    uint32_t fState;
+};
+
+// main.cpp 의 drawFrame 과 동일
+class TriangleWorkload : public Workload
+{
+public:
+    const char *name() const override { return "triangle"; }
+    void draw(SkCanvas *canvas, int) override
+    {
+        canvas->clear(SK_ColorWHITE);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setStyle(SkPaint::kFill_Style);
+        paint.setColor(SK_ColorRED);
+
+        SkPath triangle;
+        triangle.moveTo(400, 100);
+        triangle.lineTo(200, 500);
+        triangle.lineTo(600, 500);
+        triangle.close();
+
+        canvas->drawPath(triangle, paint);
+    }
+};
+
+// samples/main_cpu.cpp 와 동일
+class RectTriangleWorkload : public Workload
+{
+public:
+    const char *name() const override { return "rect_triangle"; }
+    void draw(SkCanvas *canvas, int) override
+    {
+        canvas->clear(SK_ColorWHITE);
+        SkPaint paint;
+        paint.setColor(SK_ColorBLUE);
+        paint.setAntiAlias(true);
+        canvas->drawRect(SkRect::MakeXYWH(50, 50, 300, 200), paint);
+
+        SkPath triangle;
+        triangle.moveTo(200, 300);
+        triangle.lineTo(100, 450);
+        triangle.lineTo(300, 450);
+        triangle.close();
+        paint.setColor(SK_ColorRED);
+        canvas->drawPath(triangle, paint);
+    }
+};
+
+// 작은 AA path 다수 (매 프레임 path 재생성, 회전 애니메이션)
+class StressPathsWorkload : public Workload
+{
+public:
+    StressPathsWorkload(int width, int height) : fWidth(width), fHeight(height) {}
+
+    const char *name() const override { return "stress_paths"; }
+    void draw(SkCanvas *canvas, int frame) override
+    {
+        canvas->clear(SK_ColorWHITE);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+
+        Lcg rand(1234);
+        const float angle = frame * 0.02f;
+        for (int i = 0; i < kCount; ++i) {
+            float cx = rand.nextF(0, fWidth);
+            float cy = rand.nextF(0, fHeight);
+            float r = rand.nextF(4, 24);
+            int points = 3 + rand.next() % 5;
+            paint.setColor(SkColorSetARGB(0xC0, rand.next() & 0xFF, rand.next() & 0xFF, rand.next() & 0xFF));
+
+            SkPath path;
+            for (int p = 0; p < points; ++p) {
+                float a = angle + p * 2 * 3.14159265f / points;
+                float x = cx + r * std::cos(a);
+                float y = cy + r * std::sin(a);
+                if (p == 0) {
+                    path.moveTo(x, y);
+                } else {
+                    path.lineTo(x, y);
+                }
+            }
+            path.close();
+            canvas->drawPath(path, paint);
+        }
+    }
+
+private:
+    static constexpr int kCount = 5000;
+    int fWidth;
+    int fHeight;
+};
+
+// 반투명 사각형 다수 (fill-rate / blending)
+class StressRectsWorkload : public Workload
+{
+public:
+    StressRectsWorkload(int width, int height) : fWidth(width), fHeight(height) {}
+
+    const char *name() const override { return "stress_rects"; }
+    void draw(SkCanvas *canvas, int frame) override
+    {
+        canvas->clear(SK_ColorBLACK);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+
+        Lcg rand(5678);
+        const float offset = (frame % 64) * 0.5f;
+        for (int i = 0; i < kCount; ++i) {
+            float x = rand.nextF(-32, fWidth);
+            float y = rand.nextF(-32, fHeight);
+            float w = rand.nextF(4, 64);
+            float h = rand.nextF(4, 64);
+            paint.setColor(SkColorSetARGB(0x80, rand.next() & 0xFF, rand.next() & 0xFF, rand.next() & 0xFF));
+            canvas->drawRect(SkRect::MakeXYWH(x + offset, y, w, h), paint);
+        }
+    }
+
+private:
+    static constexpr int kCount = 20000;
+    int fWidth;
+    int fHeight;
+};
+
+// immediate / retained 비교용 scene: 많은 static path + 매 프레임 회전하는 삼각형 하나.
+// registry 가 있으면 매 프레임 만든 path 를 intern 해 같은 generation ID 로 그린다
+void drawStaticPaths(SkCanvas *canvas, int width, int height, int count, PathRegistry *registry = nullptr)
+{
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    Lcg rand(4321);
+    for (int i = 0; i < count; ++i) {
+        float cx = rand.nextF(0, width);
+        float cy = rand.nextF(0, height);
+        float r = rand.nextF(4, 24);
+        paint.setColor(SkColorSetARGB(0xC0, rand.next() & 0xFF, rand.next() & 0xFF, rand.next() & 0xFF));
+
+        SkPath path;
+        path.moveTo(cx, cy - r);
+        path.lineTo(cx + r, cy + r);
+        path.lineTo(cx - r, cy + r);
+        path.close();
+        canvas->drawPath(registry ? registry->intern(path) : path, paint);
+    }
+}
+
+void drawSpinner(SkCanvas *canvas, int width, int height, int frame)
+{
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorRED);
+
+    canvas->save();
+    canvas->translate(width * 0.5f, height * 0.5f);
+    canvas->rotate(frame * 2.0f);
+    SkPath triangle;
+    triangle.moveTo(0, -100);
+    triangle.lineTo(-87, 50);
+    triangle.lineTo(87, 50);
+    triangle.close();
+    canvas->drawPath(triangle, paint);
+    canvas->restore();
+}
+
+// interned: immediate 와 똑같이 매 프레임 path 를 만들지만 PathRegistry 로 intern 한다
+class ImmediateSceneWorkload : public Workload
+{
+public:
+    ImmediateSceneWorkload(int width, int height, bool interned)
+        : fWidth(width), fHeight(height), fInterned(interned), fRegistry(2 * kStaticCount)
+    {
+    }
+
+    const char *name() const override { return fInterned ? "interned_scene" : "immediate_scene"; }
+    void draw(SkCanvas *canvas, int frame) override
+    {
+        canvas->clear(SK_ColorWHITE);
+        drawStaticPaths(canvas, fWidth, fHeight, kStaticCount, fInterned ? &fRegistry : nullptr);
+        drawSpinner(canvas, fWidth, fHeight, frame);
+    }
+
+private:
+    static constexpr int kStaticCount = 10000;
+    int fWidth;
+    int fHeight;
+    bool fInterned;
+    PathRegistry fRegistry;
+};
+
+class RetainedSceneWorkload : public Workload
+{
+public:
+    RetainedSceneWorkload(int width, int height)
+        : fScene(SkRect::MakeWH(width, height))
+    {
+        fScene.addStatic([width, height](SkCanvas *canvas, int) {
+            drawStaticPaths(canvas, width, height, kStaticCount);
+        });
+        fScene.addDynamic([width, height](SkCanvas *canvas, int frame) {
+            drawSpinner(canvas, width, height, frame);
+        });
+    }
+
+    const char *name() const override { return "retained_scene"; }
+    void draw(SkCanvas *canvas, int frame) override
+    {
+        canvas->clear(SK_ColorWHITE);
+        fScene.draw(canvas, frame);
+    }
+
+private:
+    static constexpr int kStaticCount = 10000;
+    RetainedScene fScene;
+};
+
+// 작은 다각형 / 사각형 / 원 / 점이 섞인 scene. 같은 도형을 도형마다 draw 하거나(immediate) 모아서(batched) 그린다
+struct StressShape
+{
+    enum Type { kPolygon, kRect, kCircle, kPoint } type;
+    SkPoint pts[6];
+    int count;      // kPolygon 의 꼭짓점 수
+    float size;     // kCircle 반지름, kPoint 지름, kRect 는 pts[0..1] = LT, RB
+    SkColor color;
+};
+
+std::vector<StressShape> makeStressShapes(int width, int height, int count)
+{
+    Lcg rand(2468);
+    std::vector<StressShape> shapes(count);
+    for (StressShape &shape : shapes) {
+        float cx = rand.nextF(0, width);
+        float cy = rand.nextF(0, height);
+        float r = rand.nextF(2, 10);
+        shape.color = SkColorSetARGB(0xC0, rand.next() & 0xFF, rand.next() & 0xFF, rand.next() & 0xFF);
+        uint32_t kind = rand.next() % 10;
+        if (kind < 4) {
+            shape.type = StressShape::kPolygon;
+            shape.count = 3 + rand.next() % 4;
+            for (int p = 0; p < shape.count; ++p) {
+                float a = p * 2 * 3.14159265f / shape.count;
+                shape.pts[p] = SkPoint::Make(cx + r * std::cos(a), cy + r * std::sin(a));
+            }
+        } else if (kind < 6) {
+            shape.type = StressShape::kRect;
+            shape.pts[0] = SkPoint::Make(cx - r, cy - r * 0.5f);
+            shape.pts[1] = SkPoint::Make(cx + r, cy + r * 0.5f);
+        } else if (kind < 8) {
+            shape.type = StressShape::kCircle;
+            shape.pts[0] = SkPoint::Make(cx, cy);
+            shape.size = r;
+        } else {
+            shape.type = StressShape::kPoint;
+            shape.pts[0] = SkPoint::Make(cx, cy);
+            shape.size = (rand.next() % 3 + 1) * 2.0f;
+        }
+    }
+    return shapes;
+}
+
+class StressShapesWorkload : public Workload
+{
+public:
+    StressShapesWorkload(int width, int height, bool batched)
+        : fShapes(makeStressShapes(width, height, kCount)), fBatched(batched)
+    {
+    }
+
+    const char *name() const override { return fBatched ? "stress_shapes_batched" : "stress_shapes"; }
+    void draw(SkCanvas *canvas, int frame) override
+    {
+        canvas->clear(SK_ColorWHITE);
+        const SkVector offset = SkVector::Make((frame % 64) * 0.5f, 0);
+        if (fBatched) {
+            drawBatched(canvas, offset);
+        } else {
+            drawImmediate(canvas, offset);
+        }
+    }
+
+private:
+    // drawFrame() 처럼 도형마다 path 를 만들어 그린다.
+    // batched 메시에는 AA 가 없으므로 다각형/사각형은 AA 를 끄고 그려 같은 조건으로 비교한다
+    // (원/점은 양쪽 모두 AA: sprite 가 AA 로 그려져 있음)
+    void drawImmediate(SkCanvas *canvas, SkVector offset)
+    {
+        SkPaint paint;
+        paint.setStrokeCap(SkPaint::kRound_Cap);
+        for (const StressShape &shape : fShapes) {
+            paint.setColor(shape.color);
+            paint.setAntiAlias(shape.type == StressShape::kCircle || shape.type == StressShape::kPoint);
+            switch (shape.type) {
+                case StressShape::kPolygon: {
+                    SkPath path;
+                    path.moveTo(shape.pts[0] + offset);
+                    for (int p = 1; p < shape.count; ++p) {
+                        path.lineTo(shape.pts[p] + offset);
+                    }
+                    path.close();
+                    canvas->drawPath(path, paint);
+                    break;
+                }
+                case StressShape::kRect:
+                    canvas->drawRect(SkRect::MakeLTRB(shape.pts[0].fX, shape.pts[0].fY, shape.pts[1].fX,
+                                                      shape.pts[1].fY).makeOffset(offset),
+                                     paint);
+                    break;
+                case StressShape::kCircle:
+                    canvas->drawCircle(shape.pts[0] + offset, shape.size, paint);
+                    break;
+                case StressShape::kPoint:
+                    paint.setStrokeWidth(shape.size);
+                    canvas->drawPoint(shape.pts[0] + offset, paint);
+                    break;
+            }
+        }
+    }
+
+    void drawBatched(SkCanvas *canvas, SkVector offset)
+    {
+        SkPoint pts[6];
+        for (const StressShape &shape : fShapes) {
+            switch (shape.type) {
+                case StressShape::kPolygon:
+                    for (int p = 0; p < shape.count; ++p) {
+                        pts[p] = shape.pts[p] + offset;
+                    }
+                    fBatcher.addPolygon(pts, shape.count, shape.color);
+                    break;
+                case StressShape::kRect:
+                    fBatcher.addRect(SkRect::MakeLTRB(shape.pts[0].fX, shape.pts[0].fY, shape.pts[1].fX,
+                                                      shape.pts[1].fY).makeOffset(offset),
+                                     shape.color);
+                    break;
+                case StressShape::kCircle:
+                    fBatcher.addCircle(shape.pts[0] + offset, shape.size, shape.color);
+                    break;
+                case StressShape::kPoint:
+                    fBatcher.addPoint(shape.pts[0] + offset, shape.size, shape.color);
+                    break;
+            }
+        }
+        fBatcher.flush(canvas);
+    }
+
+    static constexpr int kCount = 40000;
+    std::vector<StressShape> fShapes;
+    bool fBatched;
+    PrimitiveBatcher fBatcher;
+};
+
+// 표/라벨이 많은 overlay: 대부분 고정 문자열이고 매 프레임 일부(1/kUpdateEvery)만 값이 바뀐다.
+// immediate 는 프레임마다 typeface 를 다시 찾고 drawString 으로 매번 glyph 변환,
+// cached 는 TextCache 의 typeface / SkTextBlob 을 재사용한다.
+class LabelsWorkload : public Workload
+{
+public:
+    LabelsWorkload(int width, int height, bool cached) : fCached(cached)
+    {
+        const int columns = std::max(1, width / kCellWidth);
+        for (int i = 0; i < kCount; ++i) {
+            Label label;
+            label.pos = SkPoint::Make((i % columns) * kCellWidth + 4.0f,
+                                      (i / columns) * kCellHeight % std::max(kCellHeight, height) + 14.0f);
+            label.text = "row " + std::to_string(i) + ": " + std::to_string(i * 37 % 1000);
+            fLabels.push_back(label);
+        }
+    }
+
+    const char *name() const override { return fCached ? "labels_cached" : "labels"; }
+    void draw(SkCanvas *canvas, int frame) override
+    {
+        canvas->clear(SK_ColorWHITE);
+        SkPaint paint;
+        paint.setColor(SK_ColorBLACK);
+
+        SkFont fonts[3];
+        for (int s = 0; s < 3; ++s) {
+            if (fCached) {
+                fonts[s] = fTextCache.font("sans-serif", kSizes[s]);
+            } else {
+                fonts[s] = SkFont(sharedFontMgr()->matchFamilyStyle("sans-serif", SkFontStyle()), kSizes[s]);
+                fonts[s].setEdging(SkFont::Edging::kAntiAlias);
+                fonts[s].setSubpixel(true);
+            }
+        }
+
+        std::string dynamicText;
+        for (int i = 0; i < kCount; ++i) {
+            const Label &label = fLabels[i];
+            const std::string *text = &label.text;
+            if (i % kUpdateEvery == frame % kUpdateEvery) {
+                dynamicText = "row " + std::to_string(i) + ": " + std::to_string(frame);
+                text = &dynamicText;
+            }
+            const SkFont &font = fonts[i % 3];
+            if (fCached) {
+                fTextCache.drawText(canvas, *text, label.pos.fX, label.pos.fY, font, paint);
+            } else {
+                canvas->drawString(text->c_str(), label.pos.fX, label.pos.fY, font, paint);
+            }
+        }
+    }
+
+private:
+    struct Label
+    {
+        SkPoint pos;
+        std::string text;   // 크기는 kSizes[index % 3]
+    };
+
+    static constexpr int kCount = 5000;
+    static constexpr int kUpdateEvery = 100;
+    static constexpr int kCellWidth = 120;
+    static constexpr int kCellHeight = 16;
+    static constexpr float kSizes[3] = {10, 12, 14};
+    bool fCached;
+    std::vector<Label> fLabels;
+    TextCache fTextCache{2 * kCount};
+};
+
+} // namespace
+
+std::vector<std::string> workloadNames()
+{
+    return {"triangle",       "rect_triangle",  "stress_paths",  "stress_rects",          "immediate_scene",
+            "interned_scene", "retained_scene", "stress_shapes", "stress_shapes_batched", "labels",
+            "labels_cached"};
+}
+
+std::unique_ptr<Workload> makeWorkload(const std::string &name, int width, int height)
+{
+    if (name == "triangle") {
+        return std::make_unique<TriangleWorkload>();
+    }
+    if (name == "rect_triangle") {
+        return std::make_unique<RectTriangleWorkload>();
+    }
+    if (name == "stress_paths") {
+        return std::make_unique<StressPathsWorkload>(width, height);
+    }
+    if (name == "stress_rects") {
+        return std::make_unique<StressRectsWorkload>(width, height);
+    }
+    if (name == "immediate_scene" || name == "interned_scene") {
+        return std::make_unique<ImmediateSceneWorkload>(width, height, name == "interned_scene");
+    }
+    if (name == "retained_scene") {
+        return std::make_unique<RetainedSceneWorkload>(width, height);
+    }
+    if (name == "stress_shapes" || name == "stress_shapes_batched") {
+        return std::make_unique<StressShapesWorkload>(width, height, name == "stress_shapes_batched");
+    }
+    if (name == "labels" || name == "labels_cached") {
+        return std::make_unique<LabelsWorkload>(width, height, name == "labels_cached");
+    }
+    return nullptr;
+}
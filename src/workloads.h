@@ -0,0 +1,21 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class SkCanvas;
+
+// 샘플/벤치마크 공용 그리기 워크로드
+class Workload
+{
+public:
+    virtual ~Workload() = default;
+
+    virtual const char *name() const = 0;
+    // frame: 0 부터 증가하는 프레임 번호 (애니메이션 워크로드용)
+    virtual void draw(SkCanvas *canvas, int frame) = 0;
+};
+
+std::vector<std::string> workloadNames();
+std::unique_ptr<Workload> makeWorkload(const std::string &name, int width, int height);
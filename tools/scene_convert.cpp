@@ -0,0 +1,306 @@
+// 텍스트 scene 설명을 mmap 용 binary scene (.skscene) 으로 변환. Skia 없이 빌드된다.
+//
+//   scene_convert scenes/triangle.txt triangle.skscene
+//   scene_convert --generate=200000 --size=1920x1080 big.skscene
+//   scene_convert --info big.skscene
+//
+// 텍스트 형식 (한 줄에 한 명령, # 으로 시작하는 줄은 주석):
+//   size W H
+//   clear #AARRGGBB
+//   paint NAME fill|stroke|stroke-fill [color=#AARRGGBB] [width=W] [miter=M]
+//         [cap=butt|round|square] [join=miter|round|bevel] [aa|no-aa]
+//   path NAME [winding|evenodd|inverse-winding|inverse-evenodd] M x y L x y Q x1 y1 x2 y2
+//         K x1 y1 x2 y2 w C x1 y1 x2 y2 x3 y3 Z
+//   draw path NAME PAINT
+//   draw rect|oval L T R B PAINT
+//   draw circle CX CY R PAINT
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "scene_format.h"
+
+static bool parseColor(const std::string &text, uint32_t *argb)
+{
+    if (text.empty() || text[0] != '#' || (text.size() != 7 && text.size() != 9)) {
+        return false;
+    }
+    char *end = nullptr;
+    unsigned long value = strtoul(text.c_str() + 1, &end, 16);
+    if (*end != '\0') {
+        return false;
+    }
+    *argb = text.size() == 7 ? (0xFF000000u | static_cast<uint32_t>(value)) : static_cast<uint32_t>(value);
+    return true;
+}
+
+static bool parsePaint(std::istringstream &in, ScenePaint *paint)
+{
+    *paint = {};
+    paint->color = 0xFF000000;
+    paint->strokeWidth = 1;
+    paint->miterLimit = 4;
+    paint->antiAlias = 1;
+    std::string token;
+    while (in >> token) {
+        if (token == "fill") {
+            paint->style = 0;
+        } else if (token == "stroke") {
+            paint->style = 1;
+        } else if (token == "stroke-fill") {
+            paint->style = 2;
+        } else if (token == "aa") {
+            paint->antiAlias = 1;
+        } else if (token == "no-aa") {
+            paint->antiAlias = 0;
+        } else if (token.rfind("color=", 0) == 0) {
+            if (!parseColor(token.substr(6), &paint->color)) {
+                return false;
+            }
+        } else if (token.rfind("width=", 0) == 0) {
+            paint->strokeWidth = strtof(token.c_str() + 6, nullptr);
+        } else if (token.rfind("miter=", 0) == 0) {
+            paint->miterLimit = strtof(token.c_str() + 6, nullptr);
+        } else if (token == "cap=butt" || token == "cap=round" || token == "cap=square") {
+            paint->cap = token == "cap=butt" ? 0 : token == "cap=round" ? 1 : 2;
+        } else if (token == "join=miter" || token == "join=round" || token == "join=bevel") {
+            paint->join = token == "join=miter" ? 0 : token == "join=round" ? 1 : 2;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool parsePath(std::istringstream &in, SceneBuilder &builder)
+{
+    static const std::map<std::string, uint32_t> kFillTypes = {
+            {"winding", 0}, {"evenodd", 1}, {"inverse-winding", 2}, {"inverse-evenodd", 3}};
+    std::string token;
+    uint32_t fillType = 0;
+    std::streampos start = in.tellg();
+    if (in >> token && kFillTypes.count(token)) {
+        fillType = kFillTypes.at(token);
+    } else {
+        in.clear();
+        in.seekg(start);
+    }
+
+    builder.beginPath(fillType);
+    float v[6];
+    auto read = [&in, &v](int count) {
+        for (int i = 0; i < count; ++i) {
+            if (!(in >> v[i])) {
+                return false;
+            }
+        }
+        return true;
+    };
+    while (in >> token) {
+        if (token == "M" && read(2)) {
+            builder.moveTo(v[0], v[1]);
+        } else if (token == "L" && read(2)) {
+            builder.lineTo(v[0], v[1]);
+        } else if (token == "Q" && read(4)) {
+            builder.quadTo(v[0], v[1], v[2], v[3]);
+        } else if (token == "K" && read(5)) {
+            builder.conicTo(v[0], v[1], v[2], v[3], v[4]);
+        } else if (token == "C" && read(6)) {
+            builder.cubicTo(v[0], v[1], v[2], v[3], v[4], v[5]);
+        } else if (token == "Z") {
+            builder.close();
+        } else {
+            builder.endPath();
+            return false;
+        }
+    }
+    builder.endPath();
+    return true;
+}
+
+static bool convertText(const char *inputPath, SceneBuilder &builder)
+{
+    std::ifstream input(inputPath);
+    if (!input) {
+        std::cerr << "Failed to open " << inputPath << std::endl;
+        return false;
+    }
+    std::map<std::string, uint32_t> paints;
+    std::map<std::string, uint32_t> paths;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        std::istringstream in(line);
+        std::string command, name;
+        if (!(in >> command) || command[0] == '#') {
+            continue;
+        }
+
+        bool ok = true;
+        if (command == "size") {
+            float w = 0, h = 0;
+            ok = static_cast<bool>(in >> w >> h);
+            builder.setSize(w, h);
+        } else if (command == "clear") {
+            uint32_t color = 0;
+            ok = in >> name && parseColor(name, &color);
+            builder.setClearColor(color);
+        } else if (command == "paint") {
+            ScenePaint paint;
+            ok = in >> name && parsePaint(in, &paint);
+            if (ok) {
+                paints[name] = builder.addPaint(paint);
+            }
+        } else if (command == "path") {
+            ok = static_cast<bool>(in >> name);
+            uint32_t index = static_cast<uint32_t>(builder.pathCount());
+            ok = ok && parsePath(in, builder);
+            paths[name] = index;
+        } else if (command == "draw") {
+            std::string op, paintName;
+            SceneDraw draw = {};
+            ok = static_cast<bool>(in >> op);
+            if (op == "path") {
+                draw.op = kSceneDrawPath;
+                ok = ok && in >> name && paths.count(name);
+                draw.path = ok ? paths[name] : 0;
+            } else if (op == "rect" || op == "oval") {
+                draw.op = op == "rect" ? kSceneDrawRect : kSceneDrawOval;
+                ok = ok && in >> draw.rect[0] >> draw.rect[1] >> draw.rect[2] >> draw.rect[3];
+            } else if (op == "circle") {
+                draw.op = kSceneDrawCircle;
+                ok = ok && in >> draw.rect[0] >> draw.rect[1] >> draw.rect[2];
+            } else {
+                ok = false;
+            }
+            ok = ok && in >> paintName && paints.count(paintName);
+            if (ok) {
+                draw.paint = paints[paintName];
+                builder.addDraw(draw);
+            }
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << inputPath << ":" << lineNumber << ": invalid line: " << line << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// 결정적인 합성 scene: count 개의 작은 AA 다각형 (workloads 의 stress_paths 와 비슷한 분포)
+static void generate(int count, float width, float height, SceneBuilder &builder)
+{
+    builder.setSize(width, height);
+    builder.setClearColor(0xFFFFFFFF);
+    constexpr int kPaletteSize = 64;
+    uint32_t state = 1234;
+    auto next = [&state] {
+        state = state * 1664525u + 1013904223u;
+        return state;
+    };
+    auto nextF = [&next](float lo, float hi) { return lo + (hi - lo) * (next() >> 8) / float(1 << 24); };
+
+    for (int i = 0; i < kPaletteSize; ++i) {
+        ScenePaint paint = {};
+        paint.color = 0xC0000000u | (next() & 0xFFFFFF);
+        paint.strokeWidth = 1;
+        paint.miterLimit = 4;
+        paint.antiAlias = 1;
+        builder.addPaint(paint);
+    }
+    for (int i = 0; i < count; ++i) {
+        float cx = nextF(0, width);
+        float cy = nextF(0, height);
+        float r = nextF(2, 12);
+        int points = 3 + next() % 5;
+        builder.beginPath(0);
+        for (int p = 0; p < points; ++p) {
+            float a = p * 2 * 3.14159265f / points;
+            if (p == 0) {
+                builder.moveTo(cx + r * std::cos(a), cy + r * std::sin(a));
+            } else {
+                builder.lineTo(cx + r * std::cos(a), cy + r * std::sin(a));
+            }
+        }
+        builder.close();
+        SceneDraw draw = {};
+        draw.op = kSceneDrawPath;
+        draw.path = builder.endPath();
+        draw.paint = next() % kPaletteSize;
+        builder.addDraw(draw);
+    }
+}
+
+static int printInfo(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    SceneHeader header;
+    bool ok = file && fread(&header, sizeof(header), 1, file) == 1;
+    if (file) {
+        fclose(file);
+    }
+    if (!ok || header.magic != kSceneMagic) {
+        std::cerr << "Not a scene file: " << path << std::endl;
+        return 1;
+    }
+    std::cout << path << ": version " << header.version << ", " << header.width << "x" << header.height
+              << ", " << header.paints.count << " paints, " << header.paths.count << " paths, "
+              << header.draws.count << " draws, " << header.points.count << " points, "
+              << header.verbs.count << " verbs" << std::endl;
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int generateCount = 0;
+    float width = 800, height = 600;
+    bool info = false;
+    std::vector<const char *> files;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--generate=", 11) == 0) {
+            generateCount = atoi(argv[i] + 11);
+        } else if (strncmp(argv[i], "--size=", 7) == 0) {
+            sscanf(argv[i] + 7, "%fx%f", &width, &height);
+        } else if (strcmp(argv[i], "--info") == 0) {
+            info = true;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+
+    if (info && files.size() == 1) {
+        return printInfo(files[0]);
+    }
+    if (generateCount > 0 ? files.size() != 1 : files.size() != 2) {
+        std::cerr << "Usage: " << argv[0] << " INPUT.txt OUTPUT.skscene\n"
+                  << "       " << argv[0] << " --generate=N [--size=WxH] OUTPUT.skscene\n"
+                  << "       " << argv[0] << " --info FILE.skscene" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    SceneBuilder builder;
+    if (generateCount > 0) {
+        generate(generateCount, width, height, builder);
+    } else if (!convertText(files[0], builder)) {
+        return 1;
+    }
+    if (!builder.write(files.back())) {
+        return 1;
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Wrote " << files.back() << " (" << builder.paintCount() << " paints, " << builder.pathCount()
+              << " paths, " << builder.drawCount() << " draws, " << elapsed.count() << " ms)" << std::endl;
+    return 0;
+}